@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Replaces the global operator new and delete so a benchmark can count its heap
+// allocations. Linked only into the benchmarks that report allocations; the rest keep
+// the standard allocator.
+
+#include <stdlib.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "BenchmarkSupport.h"
+
+namespace {
+
+std::atomic<long> calls{0};
+std::atomic<size_t> bytes{0};
+
+void* countedAllocate(std::size_t size) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+}  // namespace
+
+namespace bench {
+
+long allocationCount() {
+    return calls.load(std::memory_order_relaxed);
+}
+
+size_t allocatedBytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+}  // namespace bench
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+#ifdef __cpp_aligned_new
+namespace {
+
+void* countedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    void* p = nullptr;
+    if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return p;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = countedAllocateAligned(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = countedAllocateAligned(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+#endif
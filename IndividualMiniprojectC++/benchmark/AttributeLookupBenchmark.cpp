@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost of finding the courses with a given instructor, location or time slot in a
+// large catalog (1000 departments of 1000 courses by default). "scan" walks every
+// course of every department and compares the attribute, which is the least a client
+// filtering /retrieveDept output has to do. "index" asks MyFileDatabase::findCoursesBy,
+// which answers from the secondary attribute indexes. Both return the same courses.
+//
+// The synthetic catalog repeats a handful of values, so common values match a large
+// share of the catalog; one course is also given a unique instructor through
+// commitMutation() to show the cost of a lookup with a single result.
+//
+// Usage: AttributeLookupBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+using Attribute = CourseAttributeIndex::Attribute;
+
+static std::string valueOf(const Course& course, Attribute attribute) {
+    switch (attribute) {
+        case Attribute::Instructor:
+            return course.getInstructorName();
+        case Attribute::Location:
+            return course.getCourseLocation();
+        default:
+            return course.getCourseTimeSlot();
+    }
+}
+
+static size_t scan(const MyFileDatabase& database, const std::vector<std::string>& deptCodes, Attribute attribute,
+                   const std::string& value) {
+    size_t matches = 0;
+    for (const std::string& deptCode : deptCodes) {
+        for (const auto& it : database.findDepartment(deptCode)->getCourseSelection()) {
+            matches += valueOf(*it.second, attribute) == value ? 1 : 0;
+        }
+    }
+    return matches;
+}
+
+template <typename Work>
+static double bestMicros(int rounds, size_t& matches, Work work) {
+    double best = 0;
+    for (int round = 0; round < rounds; ++round) {
+        bench::Stopwatch watch;
+        matches = work();
+        double micros = watch.elapsedSeconds() * 1e6;
+        if (round == 0 || micros < best) {
+            best = micros;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(bench::buildCatalog(departmentCount, coursesPerDept));
+    std::vector<std::string> deptCodes;
+    for (int d = 0; d < departmentCount; ++d) {
+        deptCodes.push_back(bench::deptCodeFor(d));
+    }
+    database.commitMutation(MutationRecord::forCourse(MutationType::SetCourseInstructor, deptCodes.back(),
+                                                      bench::courseIdFor(0), 0, "Visiting Lecturer"));
+
+    struct Query {
+        const char* name;
+        Attribute attribute;
+        std::string value;
+    };
+    const std::vector<Query> queries = {
+        {"instructor", Attribute::Instructor, bench::kInstructors[2]},
+        {"location", Attribute::Location, bench::kLocations[4]},
+        {"time", Attribute::TimeSlot, bench::kTimes[1]},
+        {"instructor", Attribute::Instructor, "Visiting Lecturer"},
+    };
+
+    std::printf("%d courses in %d departments, best of 3 rounds\n", departmentCount * coursesPerDept,
+                departmentCount);
+    std::printf("%-12s %-20s %9s %12s %12s %10s\n", "attribute", "value", "matches", "scan us", "index us", "speedup");
+    for (const Query& query : queries) {
+        size_t scanned = 0;
+        size_t indexed = 0;
+        double scanMicros = bestMicros(3, scanned, [&]() {
+            return scan(database, deptCodes, query.attribute, query.value);
+        });
+        double indexMicros = bestMicros(3, indexed, [&]() {
+            return database.findCoursesBy(query.attribute, query.value).size();
+        });
+        if (scanned != indexed) {
+            std::fprintf(stderr, "%s=%s: scan found %zu, index found %zu\n", query.name, query.value.c_str(), scanned,
+                         indexed);
+            return 1;
+        }
+        std::printf("%-12s %-20s %9zu %12.1f %12.1f %9.1fx\n", query.name, query.value.c_str(), indexed, scanMicros,
+                    indexMicros, scanMicros / indexMicros);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost of filling a timetable page for a cart of courses (40 by default) from a large
+// catalog (1000 departments of 1000 courses), two ways:
+//
+//   single  three requests per course, /retrieveCourse, /findCourseTime and
+//           /findCourseLocation, 120 in all for 40 courses
+//   batch   one /retrieveCourses request asking for details, time and location of
+//           every course in the cart
+//
+// Each request is built from its query string and handed to the RouteController
+// handler, as Crow does once it has read the request. Server time is the wall clock
+// and CPU time of the handlers; end-to-end latency adds one network round trip per
+// request (250 us by default, a loopback HTTP round trip including Crow's parsing) for
+// a client that sends the requests one after another. Response bytes are summed too.
+//
+// Usage: BatchLookupBenchmark [cart size] [round trip us] [departments] [courses per department]
+
+#include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+using Handler = void (RouteController::*)(const crow::request&, crow::response&);
+
+static double cpuSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+struct CartCost {
+    double wallMicros;
+    double cpuMicros;
+    size_t requests;
+    size_t bytes;
+};
+
+/**
+ * Serves one cart the given number of times and reports the cost of one cart.
+ */
+template <typename ServeCart>
+static CartCost measure(int rounds, ServeCart serveCart) {
+    CartCost cost{0, 0, 0, 0};
+    double cpuStart = cpuSeconds();
+    bench::Stopwatch watch;
+    for (int round = 0; round < rounds; ++round) {
+        cost.requests = 0;
+        cost.bytes = 0;
+        serveCart(cost);
+    }
+    cost.wallMicros = watch.elapsedSeconds() * 1e6 / rounds;
+    cost.cpuMicros = (cpuSeconds() - cpuStart) * 1e6 / rounds;
+    return cost;
+}
+
+static void serve(RouteController& routeController, Handler handler, const std::string& query, CartCost& cost) {
+    crow::request req;
+    req.url_params = crow::query_string{"?" + query};
+    crow::response res;
+    (routeController.*handler)(req, res);
+    cost.requests++;
+    cost.bytes += res.body.size();
+}
+
+static void report(const char* path, const CartCost& cost, double roundTripMicros) {
+    std::printf("%-8s %9zu %10zu %12.1f %12.1f %14.1f\n", path, cost.requests, cost.bytes, cost.wallMicros,
+                cost.cpuMicros, cost.wallMicros + cost.requests * roundTripMicros);
+}
+
+int main(int argc, char* argv[]) {
+    int cartSize = argc > 1 ? std::atoi(argv[1]) : 40;
+    double roundTripMicros = argc > 2 ? std::atof(argv[2]) : 250;
+    int departmentCount = argc > 3 ? std::atoi(argv[3]) : 1000;
+    int coursesPerDept = argc > 4 ? std::atoi(argv[4]) : 1000;
+    const int rounds = 2000;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(bench::buildCatalog(departmentCount, coursesPerDept));
+    RouteController routeController;
+    routeController.setDatabase(&database);
+
+    // a cart spread over many departments, as a student's schedule is
+    std::vector<std::string> cart;
+    std::string batch = "courses=";
+    for (int i = 0; i < cartSize; ++i) {
+        std::string deptCode = bench::deptCodeFor(i * 7919 % departmentCount);
+        std::string courseCode = bench::courseIdFor(i * 104729 % coursesPerDept);
+        cart.push_back("deptCode=" + deptCode + "&courseCode=" + courseCode);
+        batch += (i == 0 ? "" : ",") + deptCode + ":" + courseCode;
+    }
+    batch += "&fields=details,time,location";
+
+    CartCost single = measure(rounds, [&](CartCost& cost) {
+        for (const std::string& query : cart) {
+            serve(routeController, &RouteController::retrieveCourse, query, cost);
+            serve(routeController, &RouteController::findCourseTime, query, cost);
+            serve(routeController, &RouteController::findCourseLocation, query, cost);
+        }
+    });
+    CartCost batched = measure(rounds, [&](CartCost& cost) {
+        serve(routeController, &RouteController::retrieveCourses, batch, cost);
+    });
+
+    std::printf("%d course cart from %d courses, %.0f us per round trip, mean of %d carts\n", cartSize,
+                departmentCount * coursesPerDept, roundTripMicros, rounds);
+    std::printf("%-8s %9s %10s %12s %12s %14s\n", "path", "requests", "bytes", "server us", "cpu us",
+                "end-to-end us");
+    report("single", single, roundTripMicros);
+    report("batch", batched, roundTripMicros);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Bulk update throughput of term setup: a list of location, instructor, time and
+// enrolled count changes (4000 by default) spread over a 100 x 100 course catalog,
+// made two ways with the mutation log on under the "batch" sync policy:
+//
+//   single  one PATCH handler call per change, /changeCourseLocation and the like,
+//           one after another as a setup script sends them
+//   batch   /batchUpdate with every change in one body, in chunks of up to 10000
+//
+// Every request is built from its query string or body and handed to the
+// RouteController handler, as Crow does once it has read the request, so parsing,
+// lookups, locking and logging are all counted; network round trips are not.
+// Both ways must leave the catalog in the same state.
+//
+// Usage: BatchMutationBenchmark [changes]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+static const char kSnapshotPath[] = "batchmutation_benchmark.bin";
+static const char kLogPath[] = "batchmutation_benchmark.wal";
+static const int kDepartments = 100;
+static const int kCoursesPerDept = 100;
+static const size_t kChunk = 10000;
+
+using Handler = void (RouteController::*)(const crow::request&, crow::response&);
+
+struct Change {
+    Handler handler;
+    std::string path;
+    std::string query;
+};
+
+/**
+ * Builds the i-th change. Every course gets a room of its own, so no change clashes.
+ */
+static Change changeFor(int i) {
+    int course = i % (kDepartments * kCoursesPerDept);
+    std::string target = "deptCode=" + bench::deptCodeFor(course / kCoursesPerDept) +
+                         "&courseCode=" + bench::courseIdFor(course % kCoursesPerDept);
+    switch (i % 4) {
+        case 0:
+            return Change{&RouteController::setCourseLocation, "/changeCourseLocation",
+                          target + "&location=" + std::to_string(100 + i % 900) + " HALL " + std::to_string(course)};
+        case 1:
+            return Change{&RouteController::setCourseInstructor, "/changeCourseTeacher",
+                          target + "&instructor=" + bench::kInstructors[i % 8]};
+        case 2:
+            return Change{&RouteController::setCourseTime, "/changeCourseTime",
+                          target + "&time=" + bench::kTimes[i % 5]};
+        default:
+            return Change{&RouteController::setEnrollmentCount, "/setEnrollmentCount",
+                          target + "&count=" + std::to_string(i % 250)};
+    }
+}
+
+static MyFileDatabase* openDatabase() {
+    std::remove(kLogPath);
+    MyFileDatabase* database = new MyFileDatabase(1, kSnapshotPath);
+    auto catalog = bench::buildCatalog(kDepartments, kCoursesPerDept);
+    for (auto& dept : catalog) {
+        for (const auto& course : dept.second.getCourseSelection()) {
+            course.second->reassignLocation("ROOM " + dept.first + course.first);
+        }
+    }
+    database->setMapping(catalog);
+    database->enableMutationLog(kLogPath, MutationLog::parseOptions("batch"));
+    return database;
+}
+
+static std::string fingerprint(const MyFileDatabase& database) {
+    std::string state;
+    for (int d = 0; d < kDepartments; ++d) {
+        for (int c = 0; c < kCoursesPerDept; ++c) {
+            const Course* course = database.findCourse(bench::deptCodeFor(d), bench::courseIdFor(c));
+            state += course->display() + std::to_string(course->getEnrolledStudentCount());
+        }
+    }
+    return state;
+}
+
+static void report(const char* path, int changes, size_t requests, double seconds, uint64_t syncs) {
+    std::printf("%-8s %9d %9zu %10.3f %14.0f %8llu\n", path, changes, requests, seconds, changes / seconds,
+                static_cast<unsigned long long>(syncs));
+}
+
+int main(int argc, char* argv[]) {
+    int changeCount = argc > 1 ? std::atoi(argv[1]) : 4000;
+    std::vector<Change> changes;
+    for (int i = 0; i < changeCount; ++i) {
+        changes.push_back(changeFor(i));
+    }
+
+    std::printf("%d changes over %d courses, mutation log with group commit\n", changeCount,
+                kDepartments * kCoursesPerDept);
+    std::printf("%-8s %9s %9s %10s %14s %8s\n", "path", "changes", "requests", "seconds", "changes/s", "fsyncs");
+
+    MyFileDatabase* single = openDatabase();
+    RouteController singleRoutes;
+    singleRoutes.setDatabase(single);
+    bench::Stopwatch singleWatch;
+    for (const Change& change : changes) {
+        crow::request req;
+        req.url_params = crow::query_string{"?" + change.query};
+        crow::response res;
+        (singleRoutes.*change.handler)(req, res);
+        if (res.code != 200) {
+            std::fprintf(stderr, "%s?%s failed: %s\n", change.path.c_str(), change.query.c_str(), res.body.c_str());
+            return 1;
+        }
+    }
+    report("single", changeCount, changes.size(), singleWatch.elapsedSeconds(),
+           single->getMutationLog()->getSyncCount());
+    std::string singleState = fingerprint(*single);
+    delete single;
+
+    MyFileDatabase* batched = openDatabase();
+    RouteController batchRoutes;
+    batchRoutes.setDatabase(batched);
+    size_t requests = 0;
+    bench::Stopwatch batchWatch;
+    for (size_t first = 0; first < changes.size(); first += kChunk) {
+        crow::request req;
+        for (size_t i = first; i < std::min(changes.size(), first + kChunk); ++i) {
+            req.body += changes[i].path + "?" + changes[i].query + "\n";
+        }
+        crow::response res;
+        batchRoutes.batchUpdate(req, res);
+        ++requests;
+        if (res.code != 200) {
+            std::fprintf(stderr, "batch failed: %s\n", res.body.c_str());
+            return 1;
+        }
+    }
+    report("batch", changeCount, requests, batchWatch.elapsedSeconds(), batched->getMutationLog()->getSyncCount());
+    bool same = fingerprint(*batched) == singleState;
+    delete batched;
+
+    std::remove(kLogPath);
+    MyFileDatabase::removeDataFiles(kSnapshotPath);
+    if (!same) {
+        std::fprintf(stderr, "single and batch updates left different states\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#ifndef BENCHMARKSUPPORT_H
+#define BENCHMARKSUPPORT_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include "Course.h"
+#include "Department.h"
+
+namespace bench {
+
+static const char* const kInstructors[] = {"Adam Cannon", "Brian Borowski", "Jae Lee", "Gail Kaiser",
+                                           "Josh Alman", "Tony Dear", "Daniel Rubenstein", "Kaizheng Wang"};
+static const char* const kLocations[] = {"417 IAB", "309 HAV", "301 URIS", "501 NWC", "702 HAM", "633 MUDD"};
+static const char* const kTimes[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55", "6:10-9:50"};
+
+/**
+ * Builds the four letter department code used for the index-th synthetic department
+ * (AAAA, AAAB, ...).
+ */
+inline std::string deptCodeFor(int index) {
+    std::string code(4, 'A');
+    for (int i = 3; i >= 0; --i) {
+        code[i] = static_cast<char>('A' + index % 26);
+        index /= 26;
+    }
+    return code;
+}
+
+/**
+ * Builds the course ID used for the index-th synthetic course in a department.
+ */
+inline std::string courseIdFor(int index) {
+    return std::to_string(1000 + index);
+}
+
+/**
+ * Builds a synthetic catalog shaped like the real one: every department offers the same
+ * number of courses and course attributes cycle through a small set of repeated values.
+ *
+ * @param departments       number of departments to create
+ * @param coursesPerDept    number of courses in every department
+ * @return the department mapping, ready for MyFileDatabase::setMapping
+ */
+inline std::map<std::string, Department> buildCatalog(int departments, int coursesPerDept) {
+    std::map<std::string, Department> mapping;
+    for (int d = 0; d < departments; ++d) {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (int c = 0; c < coursesPerDept; ++c) {
+            int n = d * coursesPerDept + c;
+            auto course = std::make_shared<Course>(100 + n % 200, kInstructors[n % 8], kLocations[n % 6], kTimes[n % 5]);
+            course->setEnrolledStudentCount(n % 250);
+            courses[courseIdFor(c)] = course;
+        }
+        std::string code = deptCodeFor(d);
+        mapping[code] = Department(code, courses, kInstructors[d % 8], 100 + d);
+    }
+    return mapping;
+}
+
+/**
+ * Gets the size of a saved database: its manifest and every segment it names, or the
+ * data file alone if it is not a manifest.
+ */
+inline double savedMegabytes(const std::string& filePath) {
+    SnapshotManifest manifest;
+    if (SnapshotManifest::read(filePath, manifest)) {
+        uint64_t bytes = manifest.getFileSize();
+        for (const auto& segment : manifest.segments) {
+            bytes += segment.size;
+        }
+        return bytes / 1e6;
+    }
+    std::ifstream in(filePath, std::ios::binary | std::ios::ate);
+    return in.tellg() / 1e6;
+}
+
+/**
+ * Keeps a computed value observable so the compiler cannot drop the work producing it.
+ */
+inline void consume(size_t value) {
+    asm volatile("" : : "r"(value) : "memory");
+}
+
+/**
+ * The number of heap allocations, and the bytes they asked for, since the process
+ * started. Defined by benchmark/AllocationCounter.cpp, which only the benchmarks that
+ * report allocations are linked with.
+ */
+long allocationCount();
+size_t allocatedBytes();
+
+/**
+ * Wall clock stopwatch reporting elapsed time since construction.
+ */
+class Stopwatch {
+    public:
+        Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+        double elapsedSeconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace bench
+
+#endif
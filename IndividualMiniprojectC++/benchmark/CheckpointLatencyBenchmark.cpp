@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Request latency while the data file is checkpointed. Request threads send a mix of
+// lookups and mutations through the RouteController against a large catalog (1M
+// courses by default) and every request is timed. Latency percentiles are reported
+// with no checkpoint running, during copy-on-write checkpoints, and during a
+// checkpoint that holds every request back until the file is written, which is what a
+// consistent save needed without copy-on-write.
+//
+// Usage: CheckpointLatencyBenchmark [courses]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+static const char kSnapshotPath[] = "checkpoint_benchmark.bin";
+static const char kLogPath[] = "checkpoint_benchmark.wal";
+
+enum Phase { kIdle, kCopyOnWrite, kStopTheWorld, kPhases };
+static const char* const kPhaseNames[] = {"no checkpoint", "copy-on-write", "stop-the-world"};
+
+using Handler = void (RouteController::*)(const crow::request&, crow::response&);
+
+static crow::request makeRequest(const std::string& query) {
+    crow::request req;
+    req.url_params = crow::query_string{"?" + query};
+    return req;
+}
+
+static void printPercentiles(const char* name, std::vector<double>& micros) {
+    if (micros.empty()) {
+        return;
+    }
+    std::sort(micros.begin(), micros.end());
+    auto at = [&micros](double q) { return micros[static_cast<size_t>(q * (micros.size() - 1))]; };
+    std::printf("%-16s %10zu %10.1f %10.1f %10.1f %10.1f\n", name, micros.size(), at(0.5), at(0.99), at(0.999),
+                micros.back());
+}
+
+int main(int argc, char* argv[]) {
+    int courses = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int departments = std::max(1, courses / 1000);
+    int coursesPerDept = courses / departments;
+
+    std::remove(kLogPath);
+    MyFileDatabase db(1, kSnapshotPath);
+    db.setMapping(bench::buildCatalog(departments, coursesPerDept));
+    db.enableMutationLog(kLogPath, MutationLog::parseOptions("10ms"));
+    RouteController routeController;
+    routeController.setDatabase(&db);
+
+    // Stands in for a save that keeps writers out until it is done; only taken
+    // exclusively in the stop-the-world phase.
+    std::shared_timed_mutex worldLock;
+    std::atomic<int> phase{kIdle};
+    std::atomic<bool> running{true};
+    int threadCount = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::vector<double>> latencies(threadCount * kPhases);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            const Handler handlers[] = {&RouteController::retrieveCourse, &RouteController::isCourseFull,
+                                        &RouteController::enrollStudentInCourse,
+                                        &RouteController::dropStudentFromCourse,
+                                        &RouteController::setCourseLocation, &RouteController::addMajorToDept};
+            unsigned n = 2654435761u * (t + 1);
+            while (running.load(std::memory_order_relaxed)) {
+                n = n * 1664525u + 1013904223u;
+                int dept = (n >> 8) % departments;
+                int course = (n >> 4) % coursesPerDept;
+                std::string query = "deptCode=" + bench::deptCodeFor(dept) + "&courseCode=" +
+                                    bench::courseIdFor(course) + "&location=" + bench::kLocations[n % 6];
+                crow::request req = makeRequest(query);
+                crow::response res;
+                int current = phase.load(std::memory_order_relaxed);
+
+                bench::Stopwatch watch;
+                {
+                    std::shared_lock<std::shared_timed_mutex> world(worldLock);
+                    (routeController.*handlers[n % 6])(req, res);
+                }
+                latencies[t * kPhases + current].push_back(watch.elapsedSeconds() * 1e6);
+            }
+        });
+    }
+
+    bench::Stopwatch total;
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    phase = kCopyOnWrite;
+    double cowSeconds = 0;
+    for (int i = 0; i < 3; ++i) {
+        bench::Stopwatch watch;
+        db.saveContentsToFile(true);
+        cowSeconds += watch.elapsedSeconds();
+    }
+
+    phase = kStopTheWorld;
+    bench::Stopwatch blockedWatch;
+    {
+        std::unique_lock<std::shared_timed_mutex> world(worldLock);
+        db.saveContentsToFile(true);
+    }
+    double blockedSeconds = blockedWatch.elapsedSeconds();
+
+    phase = kIdle;
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double megabytes = bench::savedMegabytes(kSnapshotPath);
+
+    std::printf("%d courses in %d departments, %d request threads, %.1f MB snapshot\n", departments * coursesPerDept,
+                departments, threadCount, megabytes);
+    std::printf("copy-on-write checkpoint %.2f s, stop-the-world checkpoint %.2f s\n\n", cowSeconds / 3,
+                blockedSeconds);
+    std::printf("%-16s %10s %10s %10s %10s %10s\n", "phase", "requests", "p50 us", "p99 us", "p99.9 us", "max us");
+    for (int p = 0; p < kPhases; ++p) {
+        std::vector<double> merged;
+        for (int t = 0; t < threadCount; ++t) {
+            merged.insert(merged.end(), latencies[t * kPhases + p].begin(), latencies[t * kPhases + p].end());
+        }
+        printPercentiles(kPhaseNames[p], merged);
+    }
+    MyFileDatabase::removeDataFiles(kSnapshotPath);
+    std::remove(kLogPath);
+    return 0;
+}
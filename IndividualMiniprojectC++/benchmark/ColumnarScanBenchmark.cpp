@@ -0,0 +1,145 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost of a filtered query over every course of a large catalog (1000 departments of
+// 1000 courses by default), done two ways. "objects" walks every department's courses
+// and tests each Course through its getters, the way a query over the object graph
+// would. "columns" runs the same conditions through CourseColumns::select(), which
+// filters the column arrays many rows per instruction. Both count the matching courses
+// and must agree.
+//
+// Usage: ColumnarScanBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "CourseColumns.h"
+
+using Conditions = std::vector<CourseColumns::Condition>;
+
+static bool compare(CourseColumns::Comparison comparison, float value, float limit) {
+    switch (comparison) {
+        case CourseColumns::Comparison::Less:
+            return value < limit;
+        case CourseColumns::Comparison::LessOrEqual:
+            return value <= limit;
+        case CourseColumns::Comparison::Equal:
+            return value == limit;
+        case CourseColumns::Comparison::GreaterOrEqual:
+            return value >= limit;
+        case CourseColumns::Comparison::Greater:
+            return value > limit;
+    }
+    return false;
+}
+
+static bool passes(const std::string& deptCode, const Course& course, const CourseColumns::Condition& condition) {
+    float number = static_cast<float>(condition.number);
+    switch (condition.column) {
+        case CourseColumns::Column::Capacity:
+            return compare(condition.comparison, static_cast<float>(course.getEnrollmentCapacity()), number);
+        case CourseColumns::Column::Enrolled:
+            return compare(condition.comparison, static_cast<float>(course.getEnrolledStudentCount()), number);
+        case CourseColumns::Column::Fill:
+            return compare(condition.comparison, static_cast<float>(course.getEnrolledStudentCount()),
+                           static_cast<float>(course.getEnrollmentCapacity()) * number);
+        case CourseColumns::Column::Department:
+            return deptCode == condition.text;
+        case CourseColumns::Column::Location:
+            return *course.getInternedStrings().courseLocation == condition.text;
+        case CourseColumns::Column::Instructor:
+            return *course.getInternedStrings().instructorName == condition.text;
+        case CourseColumns::Column::TimeSlot:
+            return *course.getInternedStrings().courseTimeSlot == condition.text;
+    }
+    return false;
+}
+
+static size_t scanObjects(const std::map<std::string, Department>& mapping, const Conditions& conditions) {
+    size_t matches = 0;
+    for (const auto& dept : mapping) {
+        for (const auto& it : dept.second.getCourseSelection()) {
+            bool match = true;
+            for (const CourseColumns::Condition& condition : conditions) {
+                if (!passes(dept.first, *it.second, condition)) {
+                    match = false;
+                    break;
+                }
+            }
+            matches += match ? 1 : 0;
+        }
+    }
+    return matches;
+}
+
+static Conditions parse(const std::vector<std::string>& texts) {
+    Conditions conditions;
+    for (const std::string& text : texts) {
+        CourseColumns::Condition condition;
+        if (!CourseColumns::Condition::parse(text, condition)) {
+            std::fprintf(stderr, "bad condition %s\n", text.c_str());
+            std::exit(1);
+        }
+        conditions.push_back(condition);
+    }
+    return conditions;
+}
+
+template <typename Work>
+static double bestNanosPerCourse(size_t courseCount, size_t& matches, Work work) {
+    double best = 0;
+    for (int round = 0; round < 5; ++round) {
+        bench::Stopwatch watch;
+        matches = work();
+        double nanos = watch.elapsedSeconds() * 1e9 / courseCount;
+        if (round == 0 || nanos < best) {
+            best = nanos;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 1000;
+    size_t courseCount = static_cast<size_t>(departmentCount) * coursesPerDept;
+
+    std::map<std::string, Department> mapping = bench::buildCatalog(departmentCount, coursesPerDept);
+    CourseColumns columns;
+    for (const auto& it : mapping) {
+        columns.addDepartment(it.first, it.second.getCourseSelection());
+    }
+
+    const std::vector<std::vector<std::string>> queries = {
+        {"fill>0.9"},
+        {"capacity>100", "fill>0.9", "dept=" + bench::deptCodeFor(departmentCount / 2)},
+        {"instructor=Jae Lee", "time=4:10-5:25", "enrolled<50"},
+    };
+
+    std::printf("%zu courses in %d departments, best of 5 rounds\n", courseCount, departmentCount);
+    std::printf("%-52s %9s %13s %13s %8s\n", "query", "matches", "objects ns", "columns ns", "speedup");
+    for (const auto& query : queries) {
+        Conditions conditions = parse(query);
+        std::string text;
+        for (const std::string& condition : query) {
+            text += (text.empty() ? "" : "&") + condition;
+        }
+        size_t objectMatches = 0;
+        size_t columnMatches = 0;
+        double objects = bestNanosPerCourse(courseCount, objectMatches,
+                                            [&]() { return scanObjects(mapping, conditions); });
+        double scanned = bestNanosPerCourse(courseCount, columnMatches,
+                                            [&]() { return columns.select(conditions).size(); });
+        if (objectMatches != columnMatches) {
+            std::fprintf(stderr, "%s: %zu matches walking objects, %zu scanning columns\n", text.c_str(),
+                         objectMatches, columnMatches);
+            return 1;
+        }
+        std::printf("%-52s %9zu %13.2f %13.2f %7.1fx\n", text.c_str(), columnMatches, objects, scanned,
+                    objects / scanned);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Drives every RouteController handler from N threads at once against a shared
+// store and reports request throughput as the thread count grows.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+using Handler = void (RouteController::*)(const crow::request&, crow::response&);
+
+struct Call {
+    Handler handler;
+    crow::request req;
+};
+
+static crow::request makeRequest(const std::string& query) {
+    crow::request req;
+    req.url_params = crow::query_string{"?" + query};
+    return req;
+}
+
+/**
+ * Builds one request per handler for every (department, course) pair used by a thread,
+ * so the mix covers all routes and spreads across departments.
+ */
+static std::vector<Call> buildWorkload(int thread, int departments, int coursesPerDept) {
+    std::vector<Call> calls;
+    for (int i = 0; i < 16; ++i) {
+        int n = thread * 7919 + i * 104729;
+        std::string dept = "deptCode=" + bench::deptCodeFor(n % departments);
+        std::string course = dept + "&courseCode=" + bench::courseIdFor(n % coursesPerDept);
+
+        calls.push_back({&RouteController::retrieveDepartment, makeRequest(dept)});
+        calls.push_back({&RouteController::retrieveCourse, makeRequest(course)});
+        calls.push_back({&RouteController::isCourseFull, makeRequest(course)});
+        calls.push_back({&RouteController::getMajorCountFromDept, makeRequest(dept)});
+        calls.push_back({&RouteController::identifyDeptChair, makeRequest(dept)});
+        calls.push_back({&RouteController::findCourseLocation, makeRequest(course)});
+        calls.push_back({&RouteController::findCourseInstructor, makeRequest(course)});
+        calls.push_back({&RouteController::findCourseTime, makeRequest(course)});
+        calls.push_back({&RouteController::addMajorToDept, makeRequest(dept)});
+        calls.push_back({&RouteController::removeMajorFromDept, makeRequest(dept)});
+        calls.push_back({&RouteController::setEnrollmentCount, makeRequest(course + "&count=" + std::to_string(n % 90))});
+        calls.push_back({&RouteController::setCourseLocation, makeRequest(course + "&location=" + bench::kLocations[n % 6])});
+        calls.push_back({&RouteController::setCourseInstructor, makeRequest(course + "&instructor=Jae+Lee")});
+        calls.push_back({&RouteController::setCourseTime, makeRequest(course + "&time=" + bench::kTimes[n % 5])});
+        calls.push_back({&RouteController::enrollStudentInCourse, makeRequest(course)});
+        calls.push_back({&RouteController::dropStudentFromCourse, makeRequest(course)});
+    }
+    return calls;
+}
+
+int main() {
+    const int departments = 64;
+    const int coursesPerDept = 64;
+    const double secondsPerRun = 1.0;
+
+    MyFileDatabase db(1, "");
+    db.setMapping(bench::buildCatalog(departments, coursesPerDept));
+    RouteController routeController;
+    routeController.setDatabase(&db);
+
+    int maxThreads = std::max(2u, std::thread::hardware_concurrency()) * 2;
+    double baseline = 0;
+
+    std::printf("%8s %14s %10s\n", "threads", "requests/s", "speedup");
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        std::atomic<bool> running{true};
+        std::atomic<long> completed{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<Call> calls = buildWorkload(t, departments, coursesPerDept);
+                long count = 0;
+                while (running.load(std::memory_order_relaxed)) {
+                    for (const Call& call : calls) {
+                        crow::response res;
+                        (routeController.*call.handler)(call.req, res);
+                    }
+                    count += calls.size();
+                }
+                completed += count;
+            });
+        }
+
+        bench::Stopwatch watch;
+        std::this_thread::sleep_for(std::chrono::duration<double>(secondsPerRun));
+        running = false;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double throughput = completed.load() / watch.elapsedSeconds();
+        if (threadCount == 1) {
+            baseline = throughput;
+        }
+        std::printf("%8d %14.0f %9.2fx\n", threadCount, throughput, throughput / baseline);
+    }
+    return 0;
+}
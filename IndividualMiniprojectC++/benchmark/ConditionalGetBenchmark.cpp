@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// A portal polling /retrieveDept and /retrieveCourse every few seconds, where 95% of
+// polls (by default) find nothing changed. Before each changed poll one course of the
+// polled department is given a new instructor. Polled two ways:
+//
+//   full         every poll downloads the whole body, as before ETags
+//   conditional  every poll sends the ETag it last saw in If-None-Match and gets a 304
+//                with no body when nothing changed
+//
+// Each request is built from its query string and headers and handed to the
+// RouteController handler, as Crow does once it has read the request. Bytes on the
+// wire count the status line, the headers the handler sets plus a fixed 120 bytes of
+// headers Crow adds (Content-Length, Server, Date), and the body. Server CPU is the
+// process CPU time of the handlers, changes included.
+//
+// Usage: ConditionalGetBenchmark [polls] [unchanged percent] [courses per department]
+
+#include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+static const size_t kCrowHeaderBytes = 120;
+
+static double cpuSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static size_t wireBytes(const crow::response& res) {
+    size_t bytes = 17 + kCrowHeaderBytes + res.body.size();  // "HTTP/1.1 200 OK\r\n"
+    for (const auto& header : res.headers) {
+        bytes += header.first.size() + header.second.size() + 4;
+    }
+    return bytes;
+}
+
+struct PollCost {
+    double cpuMicros;
+    double wireBytes;
+    double notModified;
+};
+
+/**
+ * Polls one department and one of its courses the given number of times. The same
+ * pseudo-random sequence decides which polls follow a change, so both ways see the
+ * same changes.
+ */
+static PollCost poll(RouteController& routeController, MyFileDatabase& database, int polls, int unchangedPercent,
+                     int coursesPerDept, bool conditional) {
+    std::string deptCode = bench::deptCodeFor(3);
+    std::string deptTag;
+    std::string courseTag;
+    size_t bytes = 0;
+    size_t notModified = 0;
+    unsigned seed = 12345;
+    double cpuStart = cpuSeconds();
+    for (int i = 0; i < polls; ++i) {
+        seed = seed * 1103515245 + 12345;
+        if (static_cast<int>((seed >> 16) % 100) >= unchangedPercent) {
+            database.commitMutation(MutationRecord::forCourse(
+                MutationType::SetCourseInstructor, deptCode, bench::courseIdFor((seed >> 8) % coursesPerDept),
+                0, bench::kInstructors[i % 8]));
+        }
+
+        bool wholeDept = i % 2 == 0;
+        crow::request req;
+        req.url_params = crow::query_string{"?deptCode=" + deptCode +
+                                            (wholeDept ? "" : "&courseCode=" + bench::courseIdFor(0))};
+        std::string& tag = wholeDept ? deptTag : courseTag;
+        if (conditional && !tag.empty()) {
+            req.add_header("If-None-Match", tag);
+        }
+        crow::response res;
+        if (wholeDept) {
+            routeController.retrieveDepartment(req, res);
+        } else {
+            routeController.retrieveCourse(req, res);
+        }
+        if (!conditional) {
+            res.headers.erase("ETag");
+        }
+        tag = res.get_header_value("ETag");
+        notModified += res.code == 304 ? 1 : 0;
+        bytes += wireBytes(res);
+    }
+    return PollCost{(cpuSeconds() - cpuStart) * 1e6 / polls, static_cast<double>(bytes) / polls,
+                    100.0 * notModified / polls};
+}
+
+static void report(const char* path, const PollCost& cost) {
+    std::printf("%-12s %12.1f %12.2f %8.1f%%\n", path, cost.wireBytes, cost.cpuMicros, cost.notModified);
+}
+
+int main(int argc, char* argv[]) {
+    int polls = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int unchangedPercent = argc > 2 ? std::atoi(argv[2]) : 95;
+    int coursesPerDept = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    MyFileDatabase database(1, "");
+    RouteController routeController;
+    routeController.setDatabase(&database);
+
+    std::printf("%d polls of a %d-course department and one of its courses, %d%% unchanged\n", polls,
+                coursesPerDept, unchangedPercent);
+    std::printf("%-12s %12s %12s %9s\n", "path", "bytes/poll", "cpu us/poll", "304s");
+    database.setMapping(bench::buildCatalog(10, coursesPerDept));
+    report("full", poll(routeController, database, polls, unchangedPercent, coursesPerDept, false));
+    database.setMapping(bench::buildCatalog(10, coursesPerDept));
+    report("conditional", poll(routeController, database, polls, unchangedPercent, coursesPerDept, true));
+    return 0;
+}
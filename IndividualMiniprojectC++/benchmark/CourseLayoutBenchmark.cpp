@@ -0,0 +1,206 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Iteration and lookup cost of the two ways a department can hold its courses, on a
+// large catalog (10k departments of 100 courses by default). "map" is the layout
+// departments used to have: a std::map from course ID to a shared_ptr<Course>, every
+// course a separate heap object, built in ID order the way a data file was loaded.
+// "table" is CourseTable as a department now fills it from a data file: a sorted
+// array of entries with the courses stored by value in one block.
+//
+// Three workloads are timed: a scan that reads the enrolled count of every course in
+// every department with warm caches, the same scan after evicting the caches, and
+// lookups of random courses in random departments. Where the kernel allows it, cache
+// misses are counted with perf_event_open; otherwise they are reported as n/a.
+//
+// Usage: CourseLayoutBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#include "BenchmarkSupport.h"
+#include "CourseTable.h"
+
+using CourseMap = std::map<std::string, std::shared_ptr<Course>>;
+
+static const int kLookups = 1000000;
+static const size_t kEvictBytes = 64 << 20;
+
+/**
+ * Counts hardware cache misses of this thread between start() and stop(), if the
+ * kernel lets the process read the counter.
+ */
+class CacheMissCounter {
+    public:
+        CacheMissCounter() : fd(-1) {
+#ifdef __linux__
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~CacheMissCounter() {
+#ifdef __linux__
+            if (fd >= 0) {
+                close(fd);
+            }
+#endif
+        }
+
+        void start() {
+#ifdef __linux__
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        /**
+         * @return the misses since start(), or -1 if they cannot be counted
+         */
+        long long stop() {
+            long long misses = -1;
+#ifdef __linux__
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fd, &misses, sizeof(misses)) != sizeof(misses)) {
+                    misses = -1;
+                }
+            }
+#endif
+            return misses;
+        }
+
+    private:
+        int fd;
+};
+
+static Course::State stateFor(int n) {
+    return Course::State{100 + n % 200, n % 250, bench::kLocations[n % 6], bench::kInstructors[n % 8],
+                         bench::kTimes[n % 5]};
+}
+
+static size_t scan(const std::vector<CourseMap>& departments) {
+    size_t enrolled = 0;
+    for (const CourseMap& courses : departments) {
+        for (const auto& it : courses) {
+            enrolled += it.second->getEnrolledStudentCount();
+        }
+    }
+    return enrolled;
+}
+
+static size_t scan(const std::vector<CourseTable>& departments) {
+    size_t enrolled = 0;
+    for (const CourseTable& courses : departments) {
+        for (const auto& it : courses) {
+            enrolled += it.second->getEnrolledStudentCount();
+        }
+    }
+    return enrolled;
+}
+
+template <typename Layout>
+static size_t lookUp(const std::vector<Layout>& departments, const std::vector<std::pair<int, std::string>>& queries) {
+    size_t enrolled = 0;
+    for (const auto& query : queries) {
+        auto it = departments[query.first].find(query.second);
+        if (it != departments[query.first].end()) {
+            enrolled += it->second->getEnrolledStudentCount();
+        }
+    }
+    return enrolled;
+}
+
+/**
+ * Pushes the catalog out of the CPU caches by walking a larger buffer.
+ */
+static void evictCaches() {
+    static std::vector<char> buffer(kEvictBytes, 1);
+    size_t sum = 0;
+    for (size_t i = 0; i < buffer.size(); i += 64) {
+        buffer[i] = static_cast<char>(buffer[i] + 1);
+        sum += buffer[i];
+    }
+    bench::consume(sum);
+}
+
+template <typename Work>
+static void report(const char* workload, const char* layout, size_t operations, bool cold, Work work) {
+    CacheMissCounter counter;
+    double best = 0;
+    long long misses = -1;
+    for (int round = 0; round < 3; ++round) {
+        if (cold) {
+            evictCaches();
+        }
+        counter.start();
+        bench::Stopwatch watch;
+        bench::consume(work());
+        double nanos = watch.elapsedSeconds() * 1e9 / operations;
+        long long counted = counter.stop();
+        if (round == 0 || nanos < best) {
+            best = nanos;
+            misses = counted;
+        }
+    }
+    if (misses < 0) {
+        std::printf("%-12s %-6s %12.2f %16s\n", workload, layout, best, "n/a");
+    } else {
+        std::printf("%-12s %-6s %12.2f %16.3f\n", workload, layout, best, static_cast<double>(misses) / operations);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 100;
+    size_t courseCount = static_cast<size_t>(departmentCount) * coursesPerDept;
+
+    std::vector<CourseMap> maps(departmentCount);
+    std::vector<CourseTable> tables(departmentCount);
+    for (int d = 0; d < departmentCount; ++d) {
+        tables[d].reserveContiguous(coursesPerDept);
+        for (int c = 0; c < coursesPerDept; ++c) {
+            int n = d * coursesPerDept + c;
+            maps[d].emplace_hint(maps[d].end(), bench::courseIdFor(c), std::make_shared<Course>(stateFor(n)));
+            tables[d].emplace(bench::courseIdFor(c), stateFor(n));
+        }
+    }
+
+    std::mt19937 random(4156);
+    std::vector<std::pair<int, std::string>> queries;
+    queries.reserve(kLookups);
+    for (int i = 0; i < kLookups; ++i) {
+        queries.emplace_back(random() % departmentCount, bench::courseIdFor(random() % coursesPerDept));
+    }
+
+    std::printf("%zu courses in %d departments, best of 3 rounds\n", courseCount, departmentCount);
+    std::printf("%-12s %-6s %12s %16s\n", "workload", "layout", "ns/course", "misses/course");
+    report("warm scan", "map", courseCount, false, [&maps]() { return scan(maps); });
+    report("warm scan", "table", courseCount, false, [&tables]() { return scan(tables); });
+    report("cold scan", "map", courseCount, true, [&maps]() { return scan(maps); });
+    report("cold scan", "table", courseCount, true, [&tables]() { return scan(tables); });
+    report("lookup", "map", queries.size(), false, [&]() { return lookUp(maps, queries); });
+    report("lookup", "table", queries.size(), false, [&]() { return lookUp(tables, queries); });
+    return 0;
+}
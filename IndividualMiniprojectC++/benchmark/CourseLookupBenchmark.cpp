@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Nanoseconds per course lookup on a large catalog (10k departments of 100 courses by
+// default), done the way the course routes do it: parse courseCode from the request,
+// then find the course. "two-level walk" is the old route code, which turned the
+// number back into a string and looked up the department map and then the course map.
+// "composite index" probes the packed (department, course number) index. Lookups
+// are spread uniformly over the catalog, and the same lookups are timed for both.
+//
+// Usage: CourseLookupBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const int kLookups = 1000000;
+static const int kRounds = 3;
+
+using Query = std::pair<std::string, std::string>;
+
+static size_t twoLevelWalk(const MyFileDatabase& db, const std::vector<Query>& queries) {
+    size_t found = 0;
+    for (const Query& query : queries) {
+        int courseCode = std::stoi(query.second);
+        const Department* dept = db.findDepartment(query.first);
+        if (dept != nullptr && dept->findCourse(std::to_string(courseCode)) != nullptr) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+static size_t compositeIndex(const MyFileDatabase& db, const std::vector<Query>& queries) {
+    size_t found = 0;
+    for (const Query& query : queries) {
+        int courseCode = std::stoi(query.second);
+        if (db.findCourse(query.first, courseCode) != nullptr) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+/**
+ * Runs every lookup several times and returns the best time per lookup in ns.
+ */
+template <typename Lookup>
+static double bestNanosPerLookup(const std::vector<Query>& queries, Lookup lookup) {
+    double best = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        bench::Stopwatch watch;
+        bench::consume(lookup(queries));
+        double nanos = watch.elapsedSeconds() * 1e9 / queries.size();
+        best = round == 0 || nanos < best ? nanos : best;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int departments = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    MyFileDatabase db(1, "");
+    bench::Stopwatch loadWatch;
+    db.setMapping(bench::buildCatalog(departments, coursesPerDept));
+    double loadMs = loadWatch.elapsedSeconds() * 1e3;
+
+    std::mt19937 random(4156);
+    std::vector<Query> queries;
+    queries.reserve(kLookups);
+    for (int i = 0; i < kLookups; ++i) {
+        queries.emplace_back(bench::deptCodeFor(random() % departments), bench::courseIdFor(random() % coursesPerDept));
+    }
+
+    std::printf("%d courses in %d departments, setMapping %.0f ms, %d lookups, best of %d rounds\n",
+                departments * coursesPerDept, departments, loadMs, kLookups, kRounds);
+    std::printf("%-18s %12s\n", "method", "ns/lookup");
+    double walk = bestNanosPerLookup(queries, [&db](const std::vector<Query>& q) { return twoLevelWalk(db, q); });
+    std::printf("%-18s %12.1f\n", "two-level walk", walk);
+    double index = bestNanosPerLookup(queries, [&db](const std::vector<Query>& q) { return compositeIndex(db, q); });
+    std::printf("%-18s %12.1f\n", "composite index", index);
+    std::printf("speedup %.2fx\n", walk / index);
+    return 0;
+}
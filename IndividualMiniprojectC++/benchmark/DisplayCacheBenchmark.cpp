@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Heap allocations and latency of repeated /retrieveDept calls on a 500-course
+// department (the course count can be given), three ways:
+//
+//   rebuild  the rendering /retrieveDept did before display() was cached: an
+//            ostringstream over every course, each course rendered anew
+//   cached   the /retrieveDept handler with nothing changed between calls
+//   changed  the handler with one course of the department reassigned before every
+//            call, so the department is rendered again from its courses' cached text
+//
+// Every request is built from its query string and handed to the RouteController
+// handler, as Crow does once it has read the request.
+//
+// Usage: DisplayCacheBenchmark [courses]
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+/**
+ * Renders a department the way Department::display() did before it kept its text.
+ */
+static std::string rebuildDisplay(const Department& dept, const std::string& deptCode) {
+    std::ostringstream result;
+    for (const auto& it : dept.getCourseSelection()) {
+        Course::InternedStrings strings = it.second->getInternedStrings();
+        result << deptCode << " " << it.first << ": "
+               << "\nInstructor: " + *strings.instructorName + "; Location: " + *strings.courseLocation +
+                      "; Time: " + *strings.courseTimeSlot
+               << "\n";
+    }
+    return result.str();
+}
+
+template <typename Call>
+static void measure(const char* label, int iterations, Call call) {
+    size_t bytes = 0;
+    long before = bench::allocationCount();
+    bench::Stopwatch watch;
+    for (int i = 0; i < iterations; ++i) {
+        bytes += call(i);
+    }
+    double seconds = watch.elapsedSeconds();
+    long allocations = bench::allocationCount() - before;
+    bench::consume(bytes);
+    std::printf("%-8s %12.1f %12.2f %10zu\n", label, static_cast<double>(allocations) / iterations,
+                seconds * 1e6 / iterations, bytes / iterations);
+}
+
+int main(int argc, char* argv[]) {
+    int coursesPerDept = argc > 1 ? std::atoi(argv[1]) : 500;
+    const int iterations = 5000;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(bench::buildCatalog(4, coursesPerDept));
+    RouteController routeController;
+    routeController.setDatabase(&database);
+
+    std::string deptCode = bench::deptCodeFor(1);
+    const Department* dept = database.findDepartment(deptCode);
+    crow::request req;
+    req.url_params = crow::query_string{"?deptCode=" + deptCode};
+
+    std::printf("/retrieveDept on a %d-course department, mean of %d calls\n", coursesPerDept, iterations);
+    std::printf("%-8s %12s %12s %10s\n", "path", "allocs/req", "us/req", "bytes");
+    measure("rebuild", iterations, [&](int) {
+        crow::response res;
+        res.code = 200;
+        res.write(rebuildDisplay(*dept, deptCode));
+        res.end();
+        return res.body.size();
+    });
+    measure("cached", iterations, [&](int) {
+        crow::response res;
+        routeController.retrieveDepartment(req, res);
+        return res.body.size();
+    });
+    Course* course = database.findCourse(deptCode, bench::courseIdFor(coursesPerDept / 2));
+    measure("changed", iterations, [&](int i) {
+        course->reassignInstructor(bench::kInstructors[i % 8]);
+        crow::response res;
+        routeController.retrieveDepartment(req, res);
+        return res.body.size();
+    });
+    return 0;
+}
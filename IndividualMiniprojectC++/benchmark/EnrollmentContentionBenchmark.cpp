@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Registration-day contention on a single hot course (COMS 4156). Thousands of
+// enroll attempts are released at once and the number that succeed must equal the
+// capacity exactly. Enroll/drop churn is then timed against a mutex-guarded counter,
+// which is how the count was protected before it became an atomic.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+/**
+ * Check-then-increment under a lock, equivalent to the previous Course implementation.
+ */
+class MutexEnrollment {
+    public:
+        explicit MutexEnrollment(int capacity) : capacity(capacity), enrolled(0) {}
+
+        bool enrollStudent() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (capacity <= enrolled) {
+                return false;
+            }
+            enrolled++;
+            return true;
+        }
+
+        bool dropStudent() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (enrolled <= 0) {
+                return false;
+            }
+            enrolled--;
+            return true;
+        }
+
+    private:
+        std::mutex mutex;
+        int capacity;
+        int enrolled;
+};
+
+/**
+ * Runs the body on threadCount threads released together and returns the wall time.
+ */
+template <typename Body>
+static double runTogether(int threadCount, Body body) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(t);
+        });
+    }
+    bench::Stopwatch watch;
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return watch.elapsedSeconds();
+}
+
+static void registrationRush(RouteController& routeController, Course* coms4156, int threadCount,
+                             int attemptsPerThread) {
+    coms4156->setEnrolledStudentCount(0);
+    crow::request req;
+    req.url_params = crow::query_string{"?deptCode=COMS&courseCode=4156"};
+
+    std::atomic<int> accepted{0};
+    std::atomic<int> rejected{0};
+    double seconds = runTogether(threadCount, [&](int) {
+        for (int i = 0; i < attemptsPerThread; ++i) {
+            crow::response res;
+            routeController.enrollStudentInCourse(req, res);
+            (res.code == 200 ? accepted : rejected)++;
+        }
+    });
+
+    std::printf("%8d %10d %10d %10d %10s %12.0f\n", threadCount, threadCount * attemptsPerThread,
+                accepted.load(), rejected.load(), coms4156->isCourseFull() ? "full" : "open",
+                threadCount * attemptsPerThread / seconds);
+}
+
+template <typename Counter>
+static double churn(Counter& counter, int threadCount, int pairsPerThread) {
+    double seconds = runTogether(threadCount, [&](int) {
+        for (int i = 0; i < pairsPerThread; ++i) {
+            counter.enrollStudent();
+            counter.dropStudent();
+        }
+    });
+    return 2.0 * threadCount * pairsPerThread / seconds;
+}
+
+int main() {
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+
+    MyFileDatabase db(1, "");
+    db.setMapping(mapping);
+    RouteController routeController;
+    routeController.setDatabase(&db);
+    Course* coms4156 = db.findCourse("COMS", "4156");
+
+    int maxThreads = std::max(4u, std::thread::hardware_concurrency()) * 4;
+
+    std::printf("Registration rush on COMS 4156 (capacity 120)\n");
+    std::printf("%8s %10s %10s %10s %10s %12s\n", "threads", "attempts", "accepted", "rejected", "state", "attempts/s");
+    for (int threads = 4; threads <= maxThreads; threads *= 2) {
+        registrationRush(routeController, coms4156, threads, 4000 / threads + 1000);
+    }
+
+    std::printf("\nEnroll/drop churn on one course\n");
+    std::printf("%8s %14s %14s\n", "threads", "cas ops/s", "mutex ops/s");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Course course(1000000, "Gail Kaiser", "501 NWC", "10:10-11:25");
+        MutexEnrollment locked(1000000);
+        double casRate = churn(course, threads, 200000 / threads);
+        double mutexRate = churn(locked, threads, 200000 / threads);
+        std::printf("%8d %14.0f %14.0f\n", threads, casRate, mutexRate);
+    }
+    return 0;
+}
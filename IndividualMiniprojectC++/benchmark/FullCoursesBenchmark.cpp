@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost of listing the full courses of a large catalog (1000 departments of 1000 courses
+// by default), and of one department, three ways:
+//
+//   poll    looks up every course by department and ID and asks isCourseFull(), as a
+//           dashboard calling /isCourseFull for each section does
+//   walk    walks every department's courses and asks isCourseFull()
+//   bitmap  asks MyFileDatabase::findFullCourses, which reads the set bits of the
+//           full course bitmap
+//
+// All three must find the same courses. The catalog is then changed through
+// commitMutation() so a tenth of the full courses open up, and the listing is timed
+// again.
+//
+// Usage: FullCoursesBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static size_t poll(const MyFileDatabase& database, const std::vector<std::string>& deptCodes, int coursesPerDept) {
+    size_t full = 0;
+    for (const std::string& deptCode : deptCodes) {
+        for (int c = 0; c < coursesPerDept; ++c) {
+            full += database.findCourse(deptCode, bench::courseIdFor(c))->isCourseFull() ? 1 : 0;
+        }
+    }
+    return full;
+}
+
+static size_t walk(const MyFileDatabase& database, const std::vector<std::string>& deptCodes) {
+    size_t full = 0;
+    for (const std::string& deptCode : deptCodes) {
+        for (const auto& it : database.findDepartment(deptCode)->getCourseSelection()) {
+            full += it.second->isCourseFull() ? 1 : 0;
+        }
+    }
+    return full;
+}
+
+template <typename Work>
+static double bestMillis(size_t& found, Work work) {
+    double best = 0;
+    for (int round = 0; round < 3; ++round) {
+        bench::Stopwatch watch;
+        found = work();
+        double millis = watch.elapsedSeconds() * 1e3;
+        if (round == 0 || millis < best) {
+            best = millis;
+        }
+    }
+    return best;
+}
+
+static bool report(const char* scope, MyFileDatabase& database, const std::vector<std::string>& deptCodes,
+                   int coursesPerDept, bool wholeCatalog) {
+    size_t polled = 0;
+    size_t walked = 0;
+    size_t listed = 0;
+    double pollMillis = bestMillis(polled, [&]() { return poll(database, deptCodes, coursesPerDept); });
+    double walkMillis = bestMillis(walked, [&]() { return walk(database, deptCodes); });
+    double bitmapMillis = bestMillis(listed, [&]() {
+        return wholeCatalog ? database.findFullCourses().size() : database.findFullCourses(deptCodes[0]).size();
+    });
+    if (polled != listed || walked != listed) {
+        std::fprintf(stderr, "%s: poll found %zu, walk %zu, bitmap %zu\n", scope, polled, walked, listed);
+        return false;
+    }
+    std::printf("%-24s %9zu %11.3f %11.3f %11.4f %9.1fx\n", scope, listed, pollMillis, walkMillis, bitmapMillis,
+                pollMillis / bitmapMillis);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(bench::buildCatalog(departmentCount, coursesPerDept));
+    std::vector<std::string> deptCodes;
+    for (int d = 0; d < departmentCount; ++d) {
+        deptCodes.push_back(bench::deptCodeFor(d));
+    }
+    std::vector<std::string> middle = {deptCodes[departmentCount / 2]};
+
+    std::printf("%d courses in %d departments, best of 3 rounds\n", departmentCount * coursesPerDept,
+                departmentCount);
+    std::printf("%-24s %9s %11s %11s %11s %10s\n", "scope", "full", "poll ms", "walk ms", "bitmap ms", "speedup");
+    if (!report("catalog", database, deptCodes, coursesPerDept, true) ||
+        !report("one department", database, middle, coursesPerDept, false)) {
+        return 1;
+    }
+
+    size_t opened = 0;
+    for (const CourseRef& course : database.findFullCourses()) {
+        if (opened++ % 10 == 0) {
+            database.commitMutation(MutationRecord::forCourse(MutationType::DropStudent, course.deptCode,
+                                                              course.courseId, 0));
+        }
+    }
+    return report("catalog after drops", database, deptCodes, coursesPerDept, true) ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Bytes written and time taken per save of a large catalog (1M courses in 1000
+// departments by default) when a realistic mix of mutations is made between saves,
+// compared with a full save of every department. Mutations are skewed the way
+// registration traffic is: four in five go to the busiest tenth of the departments,
+// and most are enrollments and drops, with some room, instructor, time slot and major
+// changes. Saves that compact the segments into a full save are included in the
+// averages.
+//
+// Usage: IncrementalSaveBenchmark [courses]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kPath[] = "incremental_save_benchmark.bin";
+static const int kSavesPerRow = 20;
+
+static MutationRecord randomMutation(std::mt19937& random, int departments, int coursesPerDept) {
+    int busy = std::max(1, departments / 10);
+    int dept = random() % 5 != 0 ? random() % busy : random() % departments;
+    std::string deptCode = bench::deptCodeFor(dept);
+    std::string courseId = bench::courseIdFor(random() % coursesPerDept);
+    int kind = random() % 100;
+    if (kind < 45) {
+        return MutationRecord::forCourse(MutationType::EnrollStudent, deptCode, courseId);
+    }
+    if (kind < 85) {
+        return MutationRecord::forCourse(MutationType::DropStudent, deptCode, courseId);
+    }
+    if (kind < 90) {
+        return MutationRecord::forCourse(MutationType::SetCourseLocation, deptCode, courseId, 0,
+                                         bench::kLocations[random() % 6]);
+    }
+    if (kind < 93) {
+        return MutationRecord::forCourse(MutationType::SetCourseInstructor, deptCode, courseId, 0,
+                                         bench::kInstructors[random() % 8]);
+    }
+    if (kind < 95) {
+        return MutationRecord::forCourse(MutationType::SetCourseTime, deptCode, courseId, 0,
+                                         bench::kTimes[random() % 5]);
+    }
+    return MutationRecord::forDepartment(random() % 2 ? MutationType::AddMajor : MutationType::RemoveMajor, deptCode);
+}
+
+int main(int argc, char* argv[]) {
+    int courses = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int departments = std::max(1, courses / 1000);
+    int coursesPerDept = courses / departments;
+
+    MyFileDatabase::removeDataFiles(kPath);
+    MyFileDatabase db(1, kPath);
+    db.setMapping(bench::buildCatalog(departments, coursesPerDept));
+    bench::Stopwatch fullWatch;
+    db.saveContentsToFile(true);
+    double fullMs = fullWatch.elapsedSeconds() * 1e3;
+    double fullMegabytes = db.getLastSaveBytes() / 1e6;
+
+    std::printf("%d courses in %d departments; full save %.1f MB in %.0f ms; mean of %d saves per row\n", courses,
+                departments, fullMegabytes, fullMs, kSavesPerRow);
+    std::printf("%12s %12s %12s %10s %10s\n", "mutations", "depts hit", "MB/save", "% of full", "ms/save");
+    std::mt19937 random(4156);
+    for (int mutations = 10; mutations <= 100000; mutations *= 10) {
+        double megabytes = 0;
+        double seconds = 0;
+        size_t departmentsHit = 0;
+        for (int save = 0; save < kSavesPerRow; ++save) {
+            std::set<std::string> hit;
+            for (int i = 0; i < mutations; ++i) {
+                MutationRecord record = randomMutation(random, departments, coursesPerDept);
+                if (db.commitMutation(record) == MutationResult::Applied) {
+                    hit.insert(record.deptCode);
+                }
+            }
+            departmentsHit += hit.size();
+            bench::Stopwatch watch;
+            db.saveContentsToFile();
+            seconds += watch.elapsedSeconds();
+            megabytes += db.getLastSaveBytes() / 1e6;
+        }
+        std::printf("%12d %12.1f %12.3f %9.2f%% %10.1f\n", mutations,
+                    static_cast<double>(departmentsHit) / kSavesPerRow, megabytes / kSavesPerRow,
+                    100 * megabytes / kSavesPerRow / fullMegabytes, seconds * 1e3 / kSavesPerRow);
+    }
+    MyFileDatabase::removeDataFiles(kPath);
+    return 0;
+}
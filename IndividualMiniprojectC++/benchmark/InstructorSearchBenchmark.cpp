@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Per-keystroke latency of a search-as-you-type box over instructor names in a large
+// catalog (1000 departments of 1000 courses by default, taught by 20008 distinct
+// instructors). Every prefix of a few names is looked up the way a client asks again
+// on each keystroke. "scan" walks every course and matches the start of each word of
+// its instructor's name, which is what answering the box without an index costs;
+// "search" asks MyFileDatabase::searchValues for the top 10, repeated to give the
+// median and 99th percentile. For queries without typos, the top 10 must be names the
+// scan also found.
+//
+// Usage: InstructorSearchBenchmark [departments] [courses per department]
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char* const kFirstNames[] = {"Ana", "Ben", "Carla", "David", "Elena", "Farid", "Grace", "Hiro",
+                                          "Ines", "Jonas", "Kiran", "Lena", "Mateo", "Nadia", "Omar", "Priya",
+                                          "Quinn", "Rosa", "Sam", "Tara"};
+static const char* const kSyllables[] = {"bar", "cor", "del", "fen", "gar", "hol", "kas", "lin", "mor", "nov",
+                                         "pel", "ros", "sal", "tam", "ven", "wil", "yar", "zed", "bro", "kai"};
+
+static std::string instructorFor(int n) {
+    if (n % 100 == 0) {
+        return bench::kInstructors[n / 100 % 8];
+    }
+    int name = n % 20000;
+    int last = name / 20;
+    return std::string(kFirstNames[name % 20]) + " " + static_cast<char>(std::toupper(kSyllables[last % 20][0])) +
+           (kSyllables[last % 20] + 1) + kSyllables[last / 20 % 20] + kSyllables[last / 400 % 20] + "son";
+}
+
+static std::map<std::string, Department> buildCatalog(int departments, int coursesPerDept) {
+    std::map<std::string, Department> mapping;
+    for (int d = 0; d < departments; ++d) {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (int c = 0; c < coursesPerDept; ++c) {
+            int n = d * coursesPerDept + c;
+            courses[bench::courseIdFor(c)] = std::make_shared<Course>(100 + n % 200, instructorFor(n),
+                                                                      bench::kLocations[n % 6], bench::kTimes[n % 5]);
+        }
+        std::string code = bench::deptCodeFor(d);
+        mapping[code] = Department(code, courses, bench::kInstructors[d % 8], 100 + d);
+    }
+    return mapping;
+}
+
+static std::string lower(const std::string& text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+static std::set<std::string> scan(const MyFileDatabase& database, const std::vector<std::string>& deptCodes,
+                                  const std::string& query) {
+    std::string prefix = lower(query);
+    std::set<std::string> names;
+    for (const std::string& deptCode : deptCodes) {
+        for (const auto& it : database.findDepartment(deptCode)->getCourseSelection()) {
+            std::string name = lower(it.second->getInstructorName());
+            for (size_t word = 0; word != std::string::npos; word = name.find(' ', word + 1)) {
+                size_t start = name[word] == ' ' ? word + 1 : word;
+                if (name.compare(start, prefix.size(), prefix) == 0) {
+                    names.insert(it.second->getInstructorName());
+                    break;
+                }
+            }
+        }
+    }
+    return names;
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const int kRepeats = 500;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(buildCatalog(departmentCount, coursesPerDept));
+    std::vector<std::string> deptCodes;
+    for (int d = 0; d < departmentCount; ++d) {
+        deptCodes.push_back(bench::deptCodeFor(d));
+    }
+
+    struct Typed {
+        std::string text;
+        bool typo;
+    };
+    const std::vector<Typed> typed = {{"Borowski", false}, {"Kaiser", false}, {"Delkasbar", false},
+                                      {"Rubenstien", true}};
+
+    std::printf("%d courses in %d departments, top 10, %d searches per keystroke\n",
+                departmentCount * coursesPerDept, departmentCount, kRepeats);
+    std::printf("%-12s %7s %-26s %11s %11s %10s\n", "typed", "names", "best match", "search p50", "search p99",
+                "scan ms");
+    for (const Typed& word : typed) {
+        for (size_t length = 1; length <= word.text.size(); ++length) {
+            std::string query = word.text.substr(0, length);
+            std::vector<double> micros;
+            std::vector<CourseAttributeIndex::SearchHit> hits;
+            for (int i = 0; i < kRepeats; ++i) {
+                bench::Stopwatch watch;
+                hits = database.searchValues(CourseAttributeIndex::Attribute::Instructor, query, 10);
+                micros.push_back(watch.elapsedSeconds() * 1e6);
+            }
+            std::sort(micros.begin(), micros.end());
+
+            bench::Stopwatch watch;
+            std::set<std::string> scanned = scan(database, deptCodes, query);
+            double scanMillis = watch.elapsedSeconds() * 1e3;
+            if (!word.typo) {
+                size_t expected = std::min<size_t>(10, scanned.size());
+                for (size_t i = 0; i < expected; ++i) {
+                    if (i >= hits.size() || scanned.count(hits[i].value) == 0) {
+                        std::fprintf(stderr, "%s: search result %zu was not found by the scan\n", query.c_str(), i);
+                        return 1;
+                    }
+                }
+            }
+            std::printf("%-12s %7zu %-26s %9.1fus %9.1fus %10.1f\n", query.c_str(), scanned.size(),
+                        hits.empty() ? "-" : hits[0].value.c_str(), micros[kRepeats / 2],
+                        micros[kRepeats * 99 / 100], scanMillis);
+        }
+    }
+    return 0;
+}
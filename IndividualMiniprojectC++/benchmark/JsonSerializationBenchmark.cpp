@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost per course of writing out a whole catalog (200 departments of 500 courses by
+// default), as text through MyFileDatabase::display() and as JSON through
+// MyFileDatabase::writeJson():
+//
+//   display cold  the first display() after the mapping is set, rendering every course
+//   display warm  display() again, from the text each department and course kept
+//   json          writeJson() into a body string that is cleared between rounds, as a
+//                 response buffer is reused; JSON carries capacity and enrolled count too
+//
+// Heap allocations are counted by replacing operator new.
+//
+// Usage: JsonSerializationBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "JsonWriter.h"
+#include "MyFileDatabase.h"
+
+static const int kRounds = 5;
+
+struct Cost {
+    double seconds;
+    long allocations;
+    size_t bytes;
+};
+
+template <typename Write>
+static Cost measure(Write write) {
+    long before = bench::allocationCount();
+    bench::Stopwatch watch;
+    size_t bytes = write();
+    return Cost{watch.elapsedSeconds(), bench::allocationCount() - before, bytes};
+}
+
+static void report(const char* path, const Cost& cost, int courses) {
+    std::printf("%-13s %10.1f %14.2f %10.1f\n", path, cost.seconds * 1e9 / courses,
+                static_cast<double>(cost.allocations) / courses, static_cast<double>(cost.bytes) / courses);
+}
+
+int main(int argc, char* argv[]) {
+    int departments = argc > 1 ? std::atoi(argv[1]) : 200;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 500;
+    int courses = departments * coursesPerDept;
+
+    Cost cold{0, 0, 0};
+    Cost warm{0, 0, 0};
+    Cost json{0, 0, 0};
+    std::string body;
+    for (int round = 0; round < kRounds; ++round) {
+        // fresh courses every round, so the first display() has nothing cached
+        MyFileDatabase database(1, "");
+        database.setMapping(bench::buildCatalog(departments, coursesPerDept));
+
+        Cost first = measure([&]() { return database.display().size(); });
+        Cost again = measure([&]() { return database.display().size(); });
+        Cost written = measure([&]() {
+            body.clear();
+            JsonWriter writer(body);
+            database.writeJson(writer);
+            return body.size();
+        });
+        for (auto part : {std::make_pair(&cold, first), std::make_pair(&warm, again), std::make_pair(&json, written)}) {
+            part.first->seconds += part.second.seconds / kRounds;
+            part.first->allocations += part.second.allocations / kRounds;
+            part.first->bytes = part.second.bytes;
+        }
+    }
+
+    std::printf("%d courses in %d departments, mean of %d rounds\n", courses, departments, kRounds);
+    std::printf("%-13s %10s %14s %10s\n", "path", "ns/course", "allocs/course", "bytes");
+    report("display cold", cold, courses);
+    report("display warm", warm, courses);
+    report("json", json, courses);
+    return 0;
+}
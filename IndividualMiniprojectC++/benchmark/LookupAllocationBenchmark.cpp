@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Measures heap allocations per course lookup as the catalog grows, comparing the
+// old copy-the-whole-map access pattern against the reference based lookup API
+// that the routes now use.
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+
+/**
+ * The lookup performed by every handler before the read API existed: copy the
+ * department mapping, then copy the department's course selection.
+ */
+static std::string legacyFindCourseTime(const MyFileDatabase& db, const std::string& deptCode,
+                                        const std::string& courseId) {
+    std::map<std::string, Department> departmentMapping = db.getDepartmentMapping();
+    auto deptIt = departmentMapping.find(deptCode);
+    if (deptIt == departmentMapping.end()) {
+        return "";
+    }
+    const CourseTable& courses = deptIt->second.getCourseSelection();
+    std::map<std::string, std::shared_ptr<Course>> coursesMapping(courses.begin(), courses.end());
+    auto courseIt = coursesMapping.find(courseId);
+    if (courseIt == coursesMapping.end()) {
+        return "";
+    }
+    return courseIt->second->getCourseTimeSlot();
+}
+
+static std::string currentFindCourseTime(const MyFileDatabase& db, const std::string& deptCode,
+                                         const std::string& courseId) {
+    Course* course = db.findCourse(deptCode, courseId);
+    return course == nullptr ? "" : course->getCourseTimeSlot();
+}
+
+template <typename Lookup>
+static void measure(const char* label, const MyFileDatabase& db, int departments, int coursesPerDept,
+                    int iterations, Lookup lookup) {
+    std::string deptCode = bench::deptCodeFor(departments / 2);
+    std::string courseId = bench::courseIdFor(coursesPerDept / 2);
+
+    long before = bench::allocationCount();
+    bench::Stopwatch watch;
+    size_t sink = 0;
+    for (int i = 0; i < iterations; ++i) {
+        sink += lookup(db, deptCode, courseId).size();
+    }
+    double seconds = watch.elapsedSeconds();
+    long allocations = bench::allocationCount() - before;
+
+    bench::consume(sink);
+
+    std::printf("%-10s %8d %12.1f %14.1f\n", label, departments * coursesPerDept,
+                static_cast<double>(allocations) / iterations, seconds * 1e9 / iterations);
+}
+
+int main() {
+    const int coursesPerDept = 50;
+    const int departmentCounts[] = {2, 20, 200, 2000};
+
+    std::printf("%-10s %8s %12s %14s\n", "path", "courses", "allocs/req", "ns/req");
+    for (int departments : departmentCounts) {
+        MyFileDatabase db(1, "");
+        db.setMapping(bench::buildCatalog(departments, coursesPerDept));
+        int iterations = departments >= 2000 ? 20 : 2000;
+
+        measure("legacy", db, departments, coursesPerDept, iterations, legacyFindCourseTime);
+        measure("findCourse", db, departments, coursesPerDept, iterations * 100, currentFindCourseTime);
+
+        RouteController routeController;
+        routeController.setDatabase(&db);
+        crow::request req;
+        req.url_params = crow::query_string{"?deptCode=" + bench::deptCodeFor(departments / 2) +
+                                            "&courseCode=" + bench::courseIdFor(coursesPerDept / 2)};
+        measure("handler", db, departments, coursesPerDept, iterations * 100,
+                [&](const MyFileDatabase&, const std::string&, const std::string&) {
+                    crow::response res;
+                    routeController.findCourseTime(req, res);
+                    return res.body;
+                });
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Mutation throughput through MyFileDatabase::commitMutation under each mutation log
+// sync policy, with N request threads. fsyncs/s shows how many records each group
+// commit batch absorbs.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kSnapshotPath[] = "mutationlog_benchmark.bin";
+static const char kLogPath[] = "mutationlog_benchmark.wal";
+
+static void run(const char* policyName, int threadCount, double seconds) {
+    std::remove(kLogPath);
+    MyFileDatabase db(1, kSnapshotPath);
+    db.setMapping(bench::buildCatalog(32, 32));
+    db.enableMutationLog(kLogPath, MutationLog::parseOptions(policyName));
+
+    std::atomic<bool> running{true};
+    std::atomic<long> committed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            long count = 0;
+            for (int i = t; running.load(std::memory_order_relaxed); i += threadCount) {
+                MutationRecord record = MutationRecord::forCourse(
+                    MutationType::SetCourseLocation, bench::deptCodeFor(i % 32), bench::courseIdFor(i / 32 % 32),
+                    0, bench::kLocations[i % 6]);
+                db.commitMutation(record);
+                ++count;
+            }
+            committed += count;
+        });
+    }
+
+    bench::Stopwatch watch;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = watch.elapsedSeconds();
+    uint64_t syncs = db.getMutationLog()->getSyncCount();
+
+    std::printf("%-8s %8d %14.0f %12.0f %14.1f\n", policyName, threadCount, committed.load() / elapsed,
+                syncs / elapsed, syncs == 0 ? 0.0 : static_cast<double>(committed.load()) / syncs);
+}
+
+int main() {
+    const char* policies[] = {"write", "batch", "1ms", "10ms"};
+    int maxThreads = std::max(4u, std::thread::hardware_concurrency()) * 4;
+
+    std::printf("%-8s %8s %14s %12s %14s\n", "policy", "threads", "mutations/s", "fsyncs/s", "records/fsync");
+    for (const char* policy : policies) {
+        for (int threads = 1; threads <= maxThreads; threads *= 4) {
+            run(policy, threads, 1.0);
+        }
+    }
+    std::remove(kLogPath);
+    return 0;
+}
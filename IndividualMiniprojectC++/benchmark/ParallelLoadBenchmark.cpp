@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Time to bring a whole memory-mapped data file into memory with
+// MyFileDatabase::loadAllDepartments, decoding departments on 1, 2, 4, ... threads up to
+// the number of hardware threads (or the number given). Each run opens the file afresh,
+// so every run decodes every department; the file stays in the page cache between runs.
+//
+// Usage: ParallelLoadBenchmark [courses] [most threads]
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kPath[] = "parallel_load_benchmark.bin";
+static const int kRounds = 3;
+
+/**
+ * Opens the file and loads every department, returning the best time of a few rounds.
+ */
+static double bestLoadSeconds(unsigned threads) {
+    double best = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        bench::Stopwatch watch;
+        MyFileDatabase db(0, kPath);
+        db.loadAllDepartments(threads);
+        double seconds = watch.elapsedSeconds();
+        best = round == 0 || seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int courses = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    unsigned mostThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    if (mostThreads == 0) {
+        mostThreads = 1;
+    }
+    {
+        MyFileDatabase db(1, kPath);
+        db.setMapping(bench::buildCatalog(courses / 1000, 1000));
+        db.saveContentsToFile();
+    }
+
+    std::printf("%d courses in %d departments, %u hardware threads, best of %d rounds\n", courses, courses / 1000,
+                std::thread::hardware_concurrency(), kRounds);
+    std::printf("%8s %10s %10s\n", "threads", "load ms", "speedup");
+    double oneThread = 0;
+    for (unsigned threads = 1; threads <= mostThreads; threads *= 2) {
+        double seconds = bestLoadSeconds(threads);
+        if (threads == 1) {
+            oneThread = seconds;
+        }
+        std::printf("%8u %10.1f %9.2fx\n", threads, seconds * 1e3, oneThread / seconds);
+        if (threads < mostThreads && threads * 2 > mostThreads) {
+            threads = mostThreads / 2;
+        }
+    }
+    MyFileDatabase::removeDataFiles(kPath);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Latency of checking whether a course can move to a room and time, as the number of
+// rooms and courses grows. "scan" compares the move with every course until it finds a
+// clash, which is what a check costs without an occupancy structure; it stops early
+// when rooms are crowded. "bitmap" asks RoomOccupancy, which ANDs
+// the room's 5-minute occupancy words with the slots of the new meeting time. Both
+// must agree on every check.
+//
+// Courses meet for 50, 75 or 150 minutes starting on a 5-minute mark from 8:00 to
+// 20:00, spread evenly over the rooms.
+//
+// Usage: RoomConflictBenchmark [checks]
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "RoomOccupancy.h"
+
+static TimeInterval meetingFor(unsigned n) {
+    static const int kLengths[] = {50, 75, 150};
+    int start = 8 * 60 + static_cast<int>(n % 145 * 7 % 145) * 5;
+    return TimeInterval{static_cast<int16_t>(start), static_cast<int16_t>(start + kLengths[n % 3])};
+}
+
+static std::string clock(int minutes) {
+    return std::to_string(minutes / 60) + ":" + (minutes % 60 < 10 ? "0" : "") + std::to_string(minutes % 60);
+}
+
+struct Check {
+    const Course* course;
+    const std::string* room;
+    TimeInterval meeting;
+};
+
+static bool scanConflicts(const CourseTable& courses, const Check& check) {
+    for (const auto& it : courses) {
+        const Course* other = it.second.get();
+        if (other != check.course && other->getInternedStrings().courseLocation == check.room &&
+            other->getMeetingTime().overlaps(check.meeting)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    int checks = argc > 1 ? std::atoi(argv[1]) : 20;
+    const int roomCounts[] = {100, 1000, 10000};
+    const int courseCounts[] = {10000, 100000, 1000000};
+
+    std::printf("%d checks per size, %d bitmap checks per size\n", checks, checks * 1000);
+    std::printf("%8s %9s %10s %12s %12s %10s\n", "rooms", "courses", "conflicts", "scan ns", "bitmap ns", "speedup");
+    for (int roomCount : roomCounts) {
+        std::vector<const std::string*> rooms;
+        for (int r = 0; r < roomCount; ++r) {
+            rooms.push_back(StringPool::intern("ROOM " + std::to_string(r)));
+        }
+        for (int courseCount : courseCounts) {
+            CourseTable courses;
+            courses.reserveContiguous(courseCount);
+            for (int n = 0; n < courseCount; ++n) {
+                TimeInterval meeting = meetingFor(n);
+                courses.emplace(std::to_string(100000000 + n),
+                                Course::State{100, 0, *rooms[n % roomCount], bench::kInstructors[n % 8],
+                                              clock(meeting.start) + "-" + clock(meeting.end)});
+            }
+            RoomOccupancy occupancy;
+            occupancy.addDepartment(courses);
+
+            std::mt19937 random(4156);
+            std::vector<Check> work;
+            for (int i = 0; i < checks * 1000; ++i) {
+                work.push_back(Check{courses.findCourse(std::to_string(100000000 + random() % courseCount)),
+                                     rooms[random() % roomCount], meetingFor(random())});
+            }
+
+            size_t conflicts = 0;
+            bench::Stopwatch scanWatch;
+            for (int i = 0; i < checks; ++i) {
+                conflicts += scanConflicts(courses, work[i]) ? 1 : 0;
+            }
+            double scanNanos = scanWatch.elapsedSeconds() * 1e9 / checks;
+
+            size_t agreed = 0;
+            bench::Stopwatch bitmapWatch;
+            for (const Check& check : work) {
+                agreed += occupancy.wouldConflict(check.course, check.room, check.meeting) ? 1 : 0;
+            }
+            double bitmapNanos = bitmapWatch.elapsedSeconds() * 1e9 / work.size();
+
+            for (int i = 0; i < checks; ++i) {
+                bool bitmap = occupancy.wouldConflict(work[i].course, work[i].room, work[i].meeting);
+                if (bitmap != scanConflicts(courses, work[i])) {
+                    std::fprintf(stderr, "check %d: scan and bitmap disagree\n", i);
+                    return 1;
+                }
+            }
+            bench::consume(agreed);
+            std::printf("%8d %9d %7zu/%-2d %12.0f %12.1f %9.0fx\n", roomCount, courseCount, conflicts, checks,
+                        scanNanos, bitmapNanos, scanNanos / bitmapNanos);
+        }
+    }
+    return 0;
+}
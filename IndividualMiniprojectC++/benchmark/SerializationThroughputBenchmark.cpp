@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Load and save throughput, in MB/s of file, for a data file in the original format.
+// "per-field" is the original code: one istream::read or ostream::write call per length
+// prefix, string and number. "buffered" is the current code, which moves the file
+// through BufferedReader and BufferedWriter in large chunks and decodes fields straight
+// out of the buffer. Both produce and accept the same bytes.
+//
+// Usage: SerializationThroughputBenchmark [courses]
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kPath[] = "serialization_benchmark.bin";
+static const int kRounds = 3;
+
+static void writeSize(std::ostream& out, size_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeInt(std::ostream& out, int value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeString(std::ostream& out, const std::string& value) {
+    writeSize(out, value.length());
+    out.write(value.c_str(), value.length());
+}
+
+static size_t readSize(std::istream& in) {
+    size_t value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+static int readInt(std::istream& in) {
+    int value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+static std::string readString(std::istream& in) {
+    std::string value(readSize(in), ' ');
+    in.read(&value[0], value.size());
+    return value;
+}
+
+/**
+ * Saves the catalog the way the original serialize() functions did.
+ */
+static void savePerField(const std::map<std::string, Department>& mapping) {
+    std::ofstream out(kPath, std::ios::binary | std::ios::trunc);
+    writeSize(out, mapping.size());
+    for (const auto& dept : mapping) {
+        writeString(out, dept.first);
+        writeString(out, dept.first);
+        writeString(out, dept.second.getDepartmentChair());
+        writeInt(out, dept.second.getNumberOfMajors());
+        const auto& courses = dept.second.getCourseSelection();
+        writeSize(out, courses.size());
+        for (const auto& course : courses) {
+            Course::State state = course.second->getState();
+            writeString(out, course.first);
+            writeInt(out, state.enrollmentCapacity);
+            writeInt(out, state.enrolledStudentCount);
+            writeString(out, state.courseLocation);
+            writeString(out, state.instructorName);
+            writeString(out, state.courseTimeSlot);
+        }
+    }
+}
+
+static void saveBuffered(const std::map<std::string, Department>& mapping) {
+    std::ofstream out(kPath, std::ios::binary | std::ios::trunc);
+    BufferedWriter writer(out, 1 << 20);
+    writer.write(mapping.size());
+    for (const auto& dept : mapping) {
+        writer.writeString(dept.first);
+        dept.second.serialize(writer);
+    }
+}
+
+/**
+ * Loads the catalog the way the original deserialize() functions did.
+ */
+static size_t loadPerField() {
+    std::ifstream in(kPath, std::ios::binary);
+    std::map<std::string, Department> mapping;
+    size_t mapSize = readSize(in);
+    for (size_t i = 0; i < mapSize; ++i) {
+        std::string key = readString(in);
+        std::string code = readString(in);
+        std::string chair = readString(in);
+        int majors = readInt(in);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        size_t courseCount = readSize(in);
+        for (size_t c = 0; c < courseCount; ++c) {
+            std::string courseId = readString(in);
+            int capacity = readInt(in);
+            int enrolled = readInt(in);
+            std::string location = readString(in);
+            std::string instructor = readString(in);
+            std::string timeSlot = readString(in);
+            auto course = std::make_shared<Course>(capacity, instructor, location, timeSlot);
+            course->setEnrolledStudentCount(enrolled);
+            courses[courseId] = course;
+        }
+        mapping[key] = Department(code, courses, chair, majors);
+    }
+    return mapping.size();
+}
+
+static size_t loadBuffered() {
+    MyFileDatabase db(0, kPath);
+    return db.getDepartmentCount();
+}
+
+static double fileMegabytes() {
+    std::ifstream in(kPath, std::ios::binary | std::ios::ate);
+    return in.tellg() / 1e6;
+}
+
+/**
+ * Runs an operation several times and returns the best throughput seen.
+ */
+template <typename Operation>
+static double bestMegabytesPerSecond(double megabytes, Operation operation) {
+    double best = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        bench::Stopwatch watch;
+        operation();
+        double rate = megabytes / watch.elapsedSeconds();
+        best = rate > best ? rate : best;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int courses = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::map<std::string, Department> mapping = bench::buildCatalog(courses / 1000, 1000);
+    saveBuffered(mapping);
+    double megabytes = fileMegabytes();
+
+    std::printf("%d courses, %.1f MB file, best of %d rounds\n", courses, megabytes, kRounds);
+    std::printf("%-10s %12s %12s\n", "method", "load MB/s", "save MB/s");
+    double perFieldLoad = bestMegabytesPerSecond(megabytes, []() { bench::consume(loadPerField()); });
+    double perFieldSave = bestMegabytesPerSecond(megabytes, [&mapping]() { savePerField(mapping); });
+    std::printf("%-10s %12.1f %12.1f\n", "per-field", perFieldLoad, perFieldSave);
+    double bufferedLoad = bestMegabytesPerSecond(megabytes, []() { bench::consume(loadBuffered()); });
+    double bufferedSave = bestMegabytesPerSecond(megabytes, [&mapping]() { saveBuffered(mapping); });
+    std::printf("%-10s %12.1f %12.1f\n", "buffered", bufferedLoad, bufferedSave);
+    std::remove(kPath);
+    return 0;
+}
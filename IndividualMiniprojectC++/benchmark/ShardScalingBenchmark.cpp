@@ -0,0 +1,93 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Requests/s for mixed read/write traffic spread across many departments (1000 by
+// default, 100 courses each) with the store split into 1 shard, which behaves like the
+// single map and lock the store used to have, and into the default number of shards.
+// Each request picks a random department and course; four in five are lookups and the
+// rest are enrollments or drops sent through commitMutation. Threads go from 1 to 2x
+// the hardware threads. The time to render the whole catalog with display() is also
+// reported.
+//
+// Usage: ShardScalingBenchmark [departments] [seconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const int kCoursesPerDept = 100;
+
+static double requestsPerSecond(MyFileDatabase& db, int departments, unsigned threadCount, double seconds) {
+    std::atomic<bool> running(true);
+    std::vector<uint64_t> counts(threadCount * 8, 0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 random(t + 1);
+            uint64_t done = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                std::string deptCode = bench::deptCodeFor(random() % departments);
+                std::string courseId = bench::courseIdFor(random() % kCoursesPerDept);
+                int kind = random() % 10;
+                if (kind < 8) {
+                    Course* course = db.findCourse(deptCode, courseId);
+                    bench::consume(course->getEnrolledStudentCount());
+                } else {
+                    MutationType type = kind == 8 ? MutationType::EnrollStudent : MutationType::DropStudent;
+                    db.commitMutation(MutationRecord::forCourse(type, deptCode, courseId));
+                }
+                ++done;
+            }
+            // counts are spaced apart so threads do not share a cache line
+            counts[t * 8] = done;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    uint64_t total = 0;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads[t].join();
+        total += counts[t * 8];
+    }
+    return total / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    int departments = argc > 1 ? std::atoi(argv[1]) : 1000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::map<std::string, Department> catalog = bench::buildCatalog(departments, kCoursesPerDept);
+
+    MyFileDatabase single(1, "", 1);
+    MyFileDatabase sharded(1, "", MyFileDatabase::kDefaultShardCount);
+    single.setMapping(catalog);
+    sharded.setMapping(catalog);
+
+    std::printf("%d departments x %d courses, %u hardware threads, 80%% lookups / 20%% enroll+drop\n",
+                departments, kCoursesPerDept, hardware);
+    std::printf("%8s %14s %14s %9s\n", "threads", "1 shard req/s", "64 shards", "speedup");
+    for (unsigned threads = 1; threads <= 2 * hardware; threads *= 2) {
+        double one = requestsPerSecond(single, departments, threads, seconds);
+        double many = requestsPerSecond(sharded, departments, threads, seconds);
+        std::printf("%8u %14.0f %14.0f %8.2fx\n", threads, one, many, many / one);
+    }
+
+    bench::Stopwatch singleWatch;
+    bench::consume(single.display().size());
+    double singleMs = singleWatch.elapsedSeconds() * 1e3;
+    bench::Stopwatch shardedWatch;
+    bench::consume(sharded.display().size());
+    double shardedMs = shardedWatch.elapsedSeconds() * 1e3;
+    std::printf("\ndisplay(): 1 shard %.1f ms, %zu shards in parallel %.1f ms\n", singleMs,
+                MyFileDatabase::kDefaultShardCount, shardedMs);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Time from process start to the first answered request, and peak resident memory, when
+// the server loads a data file in the original format (every department and course is
+// deserialized up front) versus the memory-mapped version 2 format (only the department
+// table is read and a department's courses are read on first use). Each load runs in a
+// fresh process so its memory use is measured on its own.
+//
+// Usage: SnapshotStartupBenchmark [largest catalog size in courses]
+
+#include <sys/resource.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kOriginalPath[] = "startup_benchmark_v1.bin";
+static const char kMappedPath[] = "startup_benchmark_v2.bin";
+
+static double peakResidentMegabytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1e6;
+#else
+    return usage.ru_maxrss / 1e3;
+#endif
+}
+
+/**
+ * Child process: loads the file and answers one course lookup.
+ */
+static int loadAndAnswer(const char* path, const char* deptCode, const char* courseId) {
+    bench::Stopwatch watch;
+    MyFileDatabase db(0, path);
+    Course* course = db.findCourse(deptCode, courseId);
+    if (course == nullptr) {
+        return 1;
+    }
+    bench::consume(course->getCourseLocation().size());
+    std::printf("%f %f\n", watch.elapsedSeconds() * 1e3, peakResidentMegabytes());
+    return 0;
+}
+
+/**
+ * Writes the catalog in the original format, as saveContentsToFile() used to.
+ */
+static void writeOriginalFormat(const std::map<std::string, Department>& mapping) {
+    std::ofstream out(kOriginalPath, std::ios::binary);
+    size_t mapSize = mapping.size();
+    out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+    for (const auto& it : mapping) {
+        size_t keyLen = it.first.length();
+        out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+        out.write(it.first.c_str(), keyLen);
+        it.second.serialize(out);
+    }
+}
+
+static void measure(const char* self, const char* format, const char* path, int courses, int departments) {
+    std::string command = std::string(self) + " load " + path + " " + bench::deptCodeFor(departments / 2) + " " +
+                          bench::courseIdFor(0);
+    std::FILE* child = popen(command.c_str(), "r");
+    double firstRequestMs = 0;
+    double residentMb = 0;
+    int parsed = std::fscanf(child, "%lf %lf", &firstRequestMs, &residentMb);
+    pclose(child);
+    if (parsed != 2) {
+        std::printf("%10d %-10s load failed\n", courses, format);
+        return;
+    }
+    std::printf("%10d %-10s %10.1f %14.2f %10.1f\n", courses, format, bench::savedMegabytes(path), firstRequestMs, residentMb);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 5 && std::string(argv[1]) == "load") {
+        return loadAndAnswer(argv[2], argv[3], argv[4]);
+    }
+    int largest = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::printf("%10s %-10s %10s %14s %10s\n", "courses", "format", "file MB", "first req ms", "peak MB");
+    for (int courses = 10000; courses <= largest; courses *= 10) {
+        int departments = courses / 1000;
+        {
+            std::map<std::string, Department> mapping = bench::buildCatalog(departments, 1000);
+            writeOriginalFormat(mapping);
+            MyFileDatabase db(1, kMappedPath);
+            db.setMapping(mapping);
+            db.saveContentsToFile();
+        }
+        measure(argv[0], "original", kOriginalPath, courses, departments);
+        measure(argv[0], "mapped", kMappedPath, courses, departments);
+    }
+    std::remove(kOriginalPath);
+    MyFileDatabase::removeDataFiles(kMappedPath);
+    return 0;
+}
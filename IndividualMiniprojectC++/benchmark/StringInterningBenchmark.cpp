@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Memory per course, and data file size, with the course strings interned. Courses
+// are built the way a catalog holds them, each in its own shared_ptr, with locations,
+// instructors and time slots cycling through the small sets a real catalog repeats.
+// "own copies" is a struct with the fields Course had when it held its own
+// std::string copies; "interned" is the current Course, which points into the
+// StringPool. Heap bytes are counted by replacing operator new. The data file sizes
+// compare the original format, which writes every string inline, with the version 2
+// format, which writes each distinct string once.
+//
+// Usage: StringInterningBenchmark [courses]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static const char kOriginalPath[] = "interning_benchmark_original.bin";
+static const char kMappedPath[] = "interning_benchmark.bin";
+
+/**
+ * The fields of a course before its strings were interned.
+ */
+struct CourseWithOwnCopies {
+    CourseWithOwnCopies(int capacity, const std::string& instructor, const std::string& location,
+                        const std::string& timeSlot)
+        : enrollmentCapacity(capacity), enrolledStudentCount(0), courseLocation(location), instructorName(instructor),
+          courseTimeSlot(timeSlot), checkpointEpoch(0), changedAt(0), departmentStamp(nullptr) {}
+
+    std::shared_timed_mutex mutex;
+    int enrollmentCapacity;
+    std::atomic<int> enrolledStudentCount;
+    std::string courseLocation;
+    std::string instructorName;
+    std::string courseTimeSlot;
+    std::atomic<uint64_t> checkpointEpoch;
+    std::unique_ptr<Course::State> checkpointImage;
+    std::atomic<uint64_t> changedAt;
+    std::shared_ptr<std::atomic<uint64_t>> departmentStampHolder;
+    std::atomic<std::atomic<uint64_t>*> departmentStamp;
+};
+
+/**
+ * Builds the given number of courses and returns the heap bytes used per course.
+ */
+template <typename CourseType>
+static double heapBytesPerCourse(int courses) {
+    std::vector<std::shared_ptr<CourseType>> built;
+    built.reserve(courses);
+    size_t before = bench::allocatedBytes();
+    for (int n = 0; n < courses; ++n) {
+        built.push_back(std::make_shared<CourseType>(100 + n % 200, bench::kInstructors[n % 8],
+                                                     bench::kLocations[n % 6], bench::kTimes[n % 5]));
+    }
+    return static_cast<double>(bench::allocatedBytes() - before) / courses;
+}
+
+static double originalFormatMegabytes(const std::map<std::string, Department>& mapping) {
+    {
+        std::ofstream out(kOriginalPath, std::ios::binary | std::ios::trunc);
+        BufferedWriter writer(out, 1 << 20);
+        writer.write(mapping.size());
+        for (const auto& dept : mapping) {
+            writer.writeString(dept.first);
+            dept.second.serialize(writer);
+        }
+    }
+    double megabytes = bench::savedMegabytes(kOriginalPath);
+    std::remove(kOriginalPath);
+    return megabytes;
+}
+
+int main(int argc, char* argv[]) {
+    int courses = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    double ownCopies = heapBytesPerCourse<CourseWithOwnCopies>(courses);
+    double interned = heapBytesPerCourse<Course>(courses);
+    std::printf("%d courses, %zu distinct strings in the pool\n", courses, StringPool::size());
+    std::printf("%-12s %14s %14s\n", "course", "sizeof bytes", "heap B/course");
+    std::printf("%-12s %14zu %14.1f\n", "own copies", sizeof(CourseWithOwnCopies), ownCopies);
+    std::printf("%-12s %14zu %14.1f\n", "interned", sizeof(Course), interned);
+
+    int departments = std::max(1, courses / 1000);
+    std::map<std::string, Department> mapping = bench::buildCatalog(departments, courses / departments);
+    MyFileDatabase::removeDataFiles(kMappedPath);
+    MyFileDatabase db(1, kMappedPath);
+    db.setMapping(mapping);
+    db.saveContentsToFile(true);
+    std::printf("\n%-22s %10s\n", "data file", "MB");
+    std::printf("%-22s %10.1f\n", "original, inline", originalFormatMegabytes(mapping));
+    std::printf("%-22s %10.1f\n", "version 2, pooled", bench::savedMegabytes(kMappedPath));
+    MyFileDatabase::removeDataFiles(kMappedPath);
+    return 0;
+}
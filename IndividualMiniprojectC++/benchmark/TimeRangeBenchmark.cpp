@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+// Cost of finding the courses that meet during a range of the day in a large catalog
+// (1000 departments of 1000 courses by default). Courses meet for 50, 75 or 150
+// minutes starting on any 5-minute mark from 8:00 to 20:00, so the catalog has a few
+// hundred distinct meeting times. Three ways are timed:
+//
+//   parse  walks every course and parses its time slot string, as a query had to
+//          before time slots were kept parsed
+//   walk   walks every course and tests its parsed meeting time
+//   index  asks MyFileDatabase::findCoursesMeeting, which answers from the interval
+//          tree of distinct meeting times
+//
+// All three must find the same number of courses.
+//
+// Usage: TimeRangeBenchmark [departments] [courses per department]
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "MyFileDatabase.h"
+
+static std::string clock(int minutes) {
+    int hours = minutes / 60 > 12 ? minutes / 60 - 12 : minutes / 60;
+    std::string mins = std::to_string(minutes % 60);
+    return std::to_string(hours) + ":" + (mins.size() == 1 ? "0" : "") + mins;
+}
+
+static std::string timeSlotFor(int n) {
+    static const int kLengths[] = {50, 75, 150};
+    int start = 8 * 60 + (n * 7 % 145) * 5;
+    return clock(start) + "-" + clock(start + kLengths[n % 3]);
+}
+
+static std::map<std::string, Department> buildCatalog(int departments, int coursesPerDept) {
+    std::map<std::string, Department> mapping;
+    for (int d = 0; d < departments; ++d) {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (int c = 0; c < coursesPerDept; ++c) {
+            int n = d * coursesPerDept + c;
+            courses[bench::courseIdFor(c)] = std::make_shared<Course>(100 + n % 200, bench::kInstructors[n % 8],
+                                                                      bench::kLocations[n % 6], timeSlotFor(n));
+        }
+        std::string code = bench::deptCodeFor(d);
+        mapping[code] = Department(code, courses, bench::kInstructors[d % 8], 100 + d);
+    }
+    return mapping;
+}
+
+template <typename Test>
+static size_t walk(const MyFileDatabase& database, const std::vector<std::string>& deptCodes, Test test) {
+    size_t matches = 0;
+    for (const std::string& deptCode : deptCodes) {
+        for (const auto& it : database.findDepartment(deptCode)->getCourseSelection()) {
+            matches += test(*it.second) ? 1 : 0;
+        }
+    }
+    return matches;
+}
+
+template <typename Work>
+static double bestMillis(size_t& matches, Work work) {
+    double best = 0;
+    for (int round = 0; round < 3; ++round) {
+        bench::Stopwatch watch;
+        matches = work();
+        double millis = watch.elapsedSeconds() * 1e3;
+        if (round == 0 || millis < best) {
+            best = millis;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    int departmentCount = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int coursesPerDept = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    MyFileDatabase database(1, "");
+    database.setMapping(buildCatalog(departmentCount, coursesPerDept));
+    std::vector<std::string> deptCodes;
+    for (int d = 0; d < departmentCount; ++d) {
+        deptCodes.push_back(bench::deptCodeFor(d));
+    }
+
+    const char* const ranges[] = {"21:55-21:59", "8:00-8:05", "10:00-10:30", "10:00-12:00", "1:00-5:00"};
+    std::printf("%d courses in %d departments, best of 3 rounds\n", departmentCount * coursesPerDept,
+                departmentCount);
+    std::printf("%-12s %9s %11s %11s %11s %9s\n", "range", "matches", "parse ms", "walk ms", "index ms", "speedup");
+    for (const char* text : ranges) {
+        TimeInterval range = TimeInterval::parse(text);
+        size_t parsed = 0;
+        size_t walked = 0;
+        size_t indexed = 0;
+        double parseMillis = bestMillis(parsed, [&]() {
+            return walk(database, deptCodes, [&range](const Course& course) {
+                return TimeInterval::parse(course.getCourseTimeSlot()).overlaps(range);
+            });
+        });
+        double walkMillis = bestMillis(walked, [&]() {
+            return walk(database, deptCodes, [&range](const Course& course) {
+                return course.getMeetingTime().overlaps(range);
+            });
+        });
+        double indexMillis = bestMillis(indexed, [&]() { return database.findCoursesMeeting(range).size(); });
+        if (parsed != indexed || walked != indexed) {
+            std::fprintf(stderr, "%s: parse found %zu, walk %zu, index %zu\n", text, parsed, walked, indexed);
+            return 1;
+        }
+        std::printf("%-12s %9zu %11.2f %11.2f %11.3f %8.1fx\n", text, indexed, parseMillis, walkMillis, indexMillis,
+                    parseMillis / indexMillis);
+    }
+    return 0;
+}
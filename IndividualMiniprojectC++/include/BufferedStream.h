@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#ifndef BUFFEREDSTREAM_H
+#define BUFFEREDSTREAM_H
+
+/**
+ * Reads the original binary data format from a stream in large chunks and decodes
+ * fields straight out of the buffer, instead of one istream::read call per field.
+ * Values are read exactly as they were written: native byte order, and strings as a
+ * size_t length followed by the bytes.
+ *
+ * The reader may read ahead of the last field decoded. When it is destroyed, the bytes
+ * it read but did not use are handed back by seeking the stream, so the stream must
+ * support seeking (files and string streams do).
+ */
+class BufferedReader {
+    public:
+        static const size_t kDefaultChunkSize = 1 << 16;
+
+        explicit BufferedReader(std::istream& in, size_t chunkSize = kDefaultChunkSize);
+        ~BufferedReader();
+
+        template <typename T>
+        bool read(T& value) {
+            if (end - position >= sizeof(value)) {
+                std::memcpy(&value, buffer.data() + position, sizeof(value));
+                position += sizeof(value);
+                return true;
+            }
+            return readBytes(&value, sizeof(value));
+        }
+
+        bool readBytes(void* out, size_t length);
+        bool readString(std::string& value);
+        bool ok() const;
+
+    private:
+        bool refill();
+
+        std::istream& in;
+        std::vector<char> buffer;
+        size_t position;
+        size_t end;
+        bool failed;
+};
+
+/**
+ * Writes the original binary data format to a stream through a large buffer, the
+ * counterpart of BufferedReader. Everything written is passed to the stream when the
+ * buffer fills, on flush(), and when the writer is destroyed.
+ */
+class BufferedWriter {
+    public:
+        static const size_t kDefaultChunkSize = 1 << 16;
+
+        explicit BufferedWriter(std::ostream& out, size_t chunkSize = kDefaultChunkSize);
+        ~BufferedWriter();
+
+        template <typename T>
+        void write(const T& value) {
+            writeBytes(&value, sizeof(value));
+        }
+
+        void writeBytes(const void* data, size_t length);
+        void writeString(const std::string& value);
+        void flush();
+
+    private:
+        std::ostream& out;
+        std::string buffer;
+        size_t chunkSize;
+};
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <atomic>
+#include <cstdint>
+#ifndef CHANGECLOCK_H
+#define CHANGECLOCK_H
+
+/**
+ * Process-wide clock used to find what changed since a save. Every change to a course
+ * or department stamps it with the current tick, and a save advances the clock while
+ * it picks its cut. Everything stamped after the tick a save advanced from has changed
+ * since that save, and nothing needs clearing afterwards. Records read from a data file
+ * carry tick 0; the clock starts at 1.
+ */
+class ChangeClock {
+    public:
+        static uint64_t now() {
+            return tick().load(std::memory_order_acquire);
+        }
+
+        /**
+         * Moves the clock forward.
+         *
+         * @return the tick before the move; changes stamped later happened after it
+         */
+        static uint64_t advance() {
+            return tick().fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        /**
+         * Raises a change stamp to the given tick. The stamp never moves back, even when
+         * changes stamped on both sides of a save race each other.
+         */
+        static void raise(std::atomic<uint64_t>& stamp, uint64_t at) {
+            uint64_t seen = stamp.load(std::memory_order_relaxed);
+            while (seen < at && !stamp.compare_exchange_weak(seen, at, std::memory_order_acq_rel)) {
+            }
+        }
+
+    private:
+        static std::atomic<uint64_t>& tick() {
+            static std::atomic<uint64_t> value(1);
+            return value;
+        }
+};
+
+#endif
@@ -1,23 +1,109 @@
+#include "BufferedStream.h"
+#include "ChangeClock.h"
+#include "DepartmentTotals.h"
+#include "JsonWriter.h"
+#include "RenderCache.h"
+#include "StringPool.h"
+#include "TimeInterval.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <shared_mutex>
 #ifndef COURSE_H
 #define COURSE_H
 
+/**
+ * A single course offering. Every accessor is safe to call from concurrent request
+ * threads: reads share the course's lock and mutations take it exclusively, so
+ * updates to different courses never wait on each other. The enrolled count is an
+ * atomic updated by compare-and-swap and never takes the lock.
+ *
+ * While a checkpoint runs, the first change to a course keeps a copy of its state from
+ * before the change, so the checkpoint can write the course as it was when
+ * the checkpoint began without stopping writers.
+ *
+ * Every change stamps the course with the current ChangeClock tick, so a save can tell
+ * whether the course changed since the last one. The stamp is also passed on to the
+ * department the course was first added to, so the department knows it changed
+ * without looking at each of its courses. Changes to the capacity and enrolled count
+ * are passed on the same way to that department's DepartmentTotals.
+ *
+ * Every change also bumps the course's version, and the department's version along
+ * with it. display() keeps the text it last rendered and hands it back until the
+ * version moves on.
+ *
+ * The location, instructor and time slot are held as pointers into the StringPool,
+ * since the same few values repeat across most of a catalog. The time slot is also
+ * kept parsed into a TimeInterval, updated whenever the slot is set.
+ */
 class Course {
+    public:
+        /**
+         * The stored fields of a course, as written to the data file.
+         */
+        struct State {
+            int enrollmentCapacity;
+            int enrolledStudentCount;
+            std::string courseLocation;
+            std::string instructorName;
+            std::string courseTimeSlot;
+        };
+
+        /**
+         * The pooled strings of a course, comparable by address.
+         */
+        struct InternedStrings {
+            const std::string* courseLocation;
+            const std::string* instructorName;
+            const std::string* courseTimeSlot;
+        };
+
     private:
+        mutable std::shared_timed_mutex mutex;
         int enrollmentCapacity;
-        int enrolledStudentCount;
-        std::string courseLocation;
-        std::string instructorName;
-        std::string courseTimeSlot;
+        std::atomic<int> enrolledStudentCount;
+        const std::string* courseLocation;
+        const std::string* instructorName;
+        const std::string* courseTimeSlot;
+        TimeInterval meetingTime;
+        std::atomic<uint64_t> checkpointEpoch;
+        std::unique_ptr<State> checkpointImage;
+        std::atomic<uint64_t> changedAt;
+        std::shared_ptr<std::atomic<uint64_t>> departmentStampHolder;
+        std::atomic<std::atomic<uint64_t>*> departmentStamp;
+        std::shared_ptr<DepartmentTotals> departmentTotalsHolder;
+        std::atomic<DepartmentTotals*> departmentTotals;
+        std::atomic<uint64_t> version;
+        std::shared_ptr<std::atomic<uint64_t>> departmentVersionHolder;
+        std::atomic<std::atomic<uint64_t>*> departmentVersion;
+        RenderCache rendered;
+
+        State currentState() const;
+        void markChanged();
+        void reportEnrollment(int before, int after);
     
     public:
         Course(int count, const std::string &instructorName, const std::string &courseLocation, const std::string &timeSlot);
         Course();
+        explicit Course(const State& state);
 
         std::string getCourseLocation() const;
         std::string getInstructorName() const;
         std::string getCourseTimeSlot() const;
+        int getEnrolledStudentCount() const;
+        int getEnrollmentCapacity() const;
+        InternedStrings getInternedStrings() const;
+        TimeInterval getMeetingTime() const;
+        State getState() const;
+        uint64_t getChangedAt() const;
+        uint64_t getVersion() const;
+        bool attachToDepartment(const std::shared_ptr<std::atomic<uint64_t>>& stamp,
+                                const std::shared_ptr<std::atomic<uint64_t>>& deptVersion,
+                                const std::shared_ptr<DepartmentTotals>& totals);
         std::string display() const;
+        std::shared_ptr<const std::string> displayText() const;
+        void writeJsonFields(JsonWriter& out) const;
 
 
         bool isCourseFull() const;
@@ -29,7 +115,11 @@ class Course {
         void reassignTime(const std::string &newTime);
         void setEnrolledStudentCount(int count);
         void serialize(std::ostream& out) const;
+        void serialize(BufferedWriter& out) const;
         void deserialize(std::istream& in);
+        void deserialize(BufferedReader& in);
+        void preserveForCheckpoint(uint64_t epoch);
+        State stateForCheckpoint(uint64_t epoch);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include "CourseTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef COURSEATTRIBUTEINDEX_H
+#define COURSEATTRIBUTEINDEX_H
+
+/**
+ * A course found through CourseAttributeIndex. The course pointer stays valid as long
+ * as its department holds the course.
+ */
+struct CourseRef {
+    std::string deptCode;
+    std::string courseId;
+    const Course* course;
+};
+
+/**
+ * Secondary indexes from instructor, location and time slot to the courses that have
+ * them. Each attribute maps a pooled string to the list of course rows holding it, and
+ * every row remembers where it sits in its lists, so moving a course to another value
+ * is a constant-time removal and append. A lookup costs a hash probe plus the size of
+ * its result.
+ *
+ * Courses are added department by department; rows are numbered in the order they
+ * are added, and lookups return their courses in that order. refresh() moves a course
+ * to the lists of its current values after it is reassigned. One reader/writer lock
+ * guards the index.
+ *
+ * The distinct values of each attribute can also be searched by partial, misspelled
+ * text with search(). Every value is split into lowercase words, and each word into
+ * trigrams, the first two padded as if the word started with "$$", so "Kaiser" gives
+ * "$$k", "$ka", "kai", "ais", "ise" and "ser". Each distinct value is a term with a
+ * small number, and each trigram lists the numbers of the terms holding it, so a
+ * query split the same way counts shared trigrams in a flat array. Only terms sharing
+ * at least half of the query's trigrams are scored, so a search costs as much as the
+ * values it can match, not the number of courses. A value becomes a term with its
+ * first course and its number is reused after its last course leaves.
+ */
+class CourseAttributeIndex {
+    public:
+        enum class Attribute { Instructor, Location, TimeSlot };
+
+        /**
+         * A value found by search(), with the number of courses holding it.
+         */
+        struct SearchHit {
+            std::string value;
+            size_t courseCount;
+        };
+
+        CourseAttributeIndex();
+        CourseAttributeIndex(const CourseAttributeIndex&) = delete;
+        CourseAttributeIndex& operator=(const CourseAttributeIndex&) = delete;
+
+        void addDepartment(const std::string& deptCode, const CourseTable& courses);
+        void refresh(const Course* course);
+        std::vector<CourseRef> find(Attribute attribute, const std::string& value) const;
+        std::vector<SearchHit> search(Attribute attribute, const std::string& query, size_t limit) const;
+        size_t size() const;
+
+    private:
+        static const int kAttributes = 3;
+        using Postings = std::unordered_map<const std::string*, std::vector<uint32_t>>;
+
+        struct Term {
+            const std::string* value;
+            std::vector<std::string> words;
+        };
+
+        static const std::string* valueOf(const Course::InternedStrings& strings, int attribute);
+        static std::vector<std::string> wordsOf(const std::string& text);
+        static std::vector<uint32_t> trigramsOf(const std::string& text);
+        void post(int attribute, uint32_t row, const std::string* value);
+        void unpost(int attribute, uint32_t row);
+
+        mutable std::shared_timed_mutex mutex;
+        Postings postings[kAttributes];
+        std::vector<const std::string*> values[kAttributes];
+        std::vector<uint32_t> positions[kAttributes];
+        std::vector<Term> terms[kAttributes];
+        std::vector<uint32_t> freeTerms[kAttributes];
+        std::unordered_map<const std::string*, uint32_t> termNumbers[kAttributes];
+        std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams[kAttributes];
+
+        std::vector<const std::string*> deptCodes;
+        std::vector<const std::string*> courseIds;
+        std::vector<const Course*> courses;
+        std::unordered_map<const Course*, uint32_t> rows;
+};
+
+#endif
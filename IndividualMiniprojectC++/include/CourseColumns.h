@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include "CourseTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef COURSECOLUMNS_H
+#define COURSECOLUMNS_H
+
+/**
+ * Column-oriented copy of every course's state for analytic scans: one array each for
+ * capacity, enrolled count, department and the pooled location, instructor and time
+ * slot, with one row per course, in department and course ID order. Strings are stored
+ * as small ids assigned by the columns, so every column is an array of 32-bit
+ * integers that a filter compares several rows at a time with SIMD instructions
+ * (SSE2 where available, plain loops the compiler can vectorize otherwise).
+ *
+ * Rows are kept current by refresh(), which copies a course's state into its row
+ * after a change. Rows are split into blocks with a reader/writer lock each: a refresh
+ * takes its row's block exclusively, and a scan reads one block at a time in shared
+ * mode, so a scan sees each row either before or after any given refresh.
+ */
+class CourseColumns {
+    public:
+        enum class Column { Capacity, Enrolled, Fill, Department, Location, Instructor, TimeSlot };
+        enum class Comparison { Less, LessOrEqual, Equal, GreaterOrEqual, Greater };
+
+        /**
+         * One test on a column. Number columns take any comparison against number;
+         * fill is enrolled / capacity. String columns only test equality with text.
+         */
+        struct Condition {
+            Column column;
+            Comparison comparison;
+            double number;
+            std::string text;
+
+            static bool parse(const std::string& condition, Condition& parsed);
+        };
+
+        CourseColumns();
+        CourseColumns(const CourseColumns&) = delete;
+        CourseColumns& operator=(const CourseColumns&) = delete;
+
+        void addDepartment(const std::string& deptCode, const CourseTable& courses);
+        void refresh(const Course* course);
+        void refreshEnrollment(const Course* course);
+
+        std::vector<size_t> select(const std::vector<Condition>& conditions) const;
+        size_t size() const;
+        const std::string& getDeptCode(size_t row) const;
+        const std::string& getCourseId(size_t row) const;
+        int getCapacity(size_t row) const;
+        int getEnrolled(size_t row) const;
+
+    private:
+        static const size_t kBlockRows = 4096;
+
+        int32_t idOf(const std::string* pooled);
+        int32_t findId(const std::string* pooled) const;
+        std::shared_timed_mutex& blockLock(size_t row) const;
+
+        std::vector<int32_t> capacity;
+        std::vector<int32_t> enrolled;
+        std::vector<int32_t> department;
+        std::vector<int32_t> location;
+        std::vector<int32_t> instructor;
+        std::vector<int32_t> timeSlot;
+
+        std::vector<std::string> deptCodes;
+        std::unordered_map<std::string, int32_t> deptIds;
+        std::vector<const std::string*> courseIds;
+        std::unordered_map<const Course*, size_t> rows;
+        mutable std::vector<std::unique_ptr<std::shared_timed_mutex>> blockLocks;
+
+        mutable std::mutex stringIdsMutex;
+        std::unordered_map<const std::string*, int32_t> stringIds;
+};
+
+#endif
@@ -0,0 +1,51 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#ifndef COURSEINDEX_H
+#define COURSEINDEX_H
+
+class Course;
+
+/**
+ * Hash index from a packed (department, course number) key to a course, so a course is
+ * found with one probe instead of a department lookup followed by a course lookup.
+ *
+ * A key holds the department code, up to four bytes, in its upper 32 bits and the
+ * course number in its lower 32 bits. Courses whose department code or ID does not fit
+ * that shape cannot be indexed and have to be found through their department.
+ *
+ * The table uses open addressing with linear probing over a power-of-two array of
+ * slots kept at most 70% full. Key 0 marks an empty slot; no packed key is 0, since a
+ * department code is never empty. The index is filled once and then only read, so it
+ * needs no locking of its own.
+ */
+class CourseIndex {
+    public:
+        CourseIndex();
+        explicit CourseIndex(size_t expectedCourses);
+
+        static bool packKey(const std::string& deptCode, const std::string& courseId, uint64_t& key);
+        static bool packKey(const std::string& deptCode, int courseNumber, uint64_t& key);
+
+        void insert(uint64_t key, Course* course);
+        Course* find(uint64_t key) const;
+        size_t size() const;
+
+    private:
+        struct Slot {
+            uint64_t key;
+            Course* course;
+        };
+
+        size_t slotFor(uint64_t key) const;
+
+        std::vector<Slot> slots;
+        size_t mask;
+        int shift;
+        size_t count;
+};
+
+#endif
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifndef COURSETABLE_H
+#define COURSETABLE_H
+
+/**
+ * The courses of one department, kept as a flat array of (course ID, course) entries
+ * sorted by ID. Lookups binary search the array and iteration walks it in order, so
+ * neither follows tree pointers.
+ *
+ * Courses a department reads from a data file are built by the table itself with
+ * emplace(). After reserveContiguous(n), the next n of them are stored by value side
+ * by side in one allocation, in ID order, so a scan over them reads memory
+ * sequentially. Courses handed in from outside with set() keep their own allocation.
+ * Either way a course never moves once added, so pointers to it stay valid while the
+ * table holds it, and copies of a table share their courses. Room reserved in a table
+ * is not passed on to its copies.
+ *
+ * The table has no lock; its department's lock guards it.
+ */
+class CourseTable {
+    public:
+        using value_type = std::pair<std::string, std::shared_ptr<Course>>;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        CourseTable();
+        explicit CourseTable(const std::map<std::string, std::shared_ptr<Course>>& courses);
+        CourseTable(const CourseTable& other);
+        CourseTable& operator=(const CourseTable& other);
+        CourseTable(CourseTable&& other) = default;
+        CourseTable& operator=(CourseTable&& other) = default;
+
+        void reserveContiguous(size_t count);
+        Course& emplace(const std::string& courseId);
+        Course& emplace(const std::string& courseId, const Course::State& state);
+        void set(const std::string& courseId, std::shared_ptr<Course> course);
+
+        const_iterator find(const std::string& courseId) const;
+        Course* findCourse(const std::string& courseId) const;
+        const_iterator begin() const;
+        const_iterator end() const;
+        size_t size() const;
+        bool empty() const;
+
+    private:
+        /**
+         * Storage for courses constructed in place, side by side.
+         */
+        class Block {
+            public:
+                explicit Block(size_t capacity);
+                ~Block();
+                Block(const Block&) = delete;
+                Block& operator=(const Block&) = delete;
+
+                bool isFull() const;
+                template <typename... Args>
+                Course* construct(Args&&... args) {
+                    Course* course = new (&slots[used]) Course(std::forward<Args>(args)...);
+                    ++used;
+                    return course;
+                }
+
+            private:
+                using Slot = std::aligned_storage<sizeof(Course), alignof(Course)>::type;
+                std::unique_ptr<Slot[]> slots;
+                size_t capacity;
+                size_t used;
+        };
+
+        template <typename... Args>
+        std::shared_ptr<Course> makeCourse(Args&&... args);
+
+        std::vector<value_type> entries;
+        std::shared_ptr<Block> block;
+};
+
+#endif
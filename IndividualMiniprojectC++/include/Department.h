@@ -1,37 +1,104 @@
 #include <string>
 #include <map>
 #include "Course.h"
+#include "CourseTable.h"
+#include "DepartmentTotals.h"
+#include "RenderCache.h"
+#include "SnapshotFile.h"
 #ifndef DEPARTMENT_H
 #define DEPARTMENT_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <memory>
+#include <shared_mutex>
 
+/**
+ * A department and the courses it offers. Lookups share the department's lock so they
+ * run in parallel; changes to the department itself (its majors or its course list)
+ * take the lock exclusively. Changes to an individual course are serialized by that
+ * course's own lock instead.
+ *
+ * Like a course, a department keeps its major count as of a running checkpoint before
+ * the first change made during it, and is stamped with the ChangeClock tick of its
+ * last change or of the last change to any of its courses. Copies of a department
+ * share their Course objects and also share this stamp.
+ *
+ * A department read from a version 2 data file starts out with only its code, chair
+ * and major count. Its courses are read from the mapped file the first time any of
+ * them is needed.
+ *
+ * Courses are kept in a CourseTable sorted by ID. Courses read from a data file are
+ * stored by value in one block per department, in ID order.
+ *
+ * The department's seats, enrolled students and full courses are kept in a
+ * DepartmentTotals that its courses update as they change, and copies share it like
+ * the change stamp. The totals count every course ever attached to them, so when the
+ * table no longer holds exactly those courses (a course was replaced, a copy gained a
+ * course, or a course reports to another department) getCourseTotals() adds the
+ * courses up instead.
+ *
+ * Every change to the department or to one of its courses also bumps the department's
+ * version, which copies share too. display() keeps the text it last rendered and hands
+ * it back until the version moves on; a new rendering reuses the text each unchanged
+ * course kept.
+ */
 class Department {
     public:
         Department(std::string deptCode, std::map<std::string, std::shared_ptr<Course>> courses,
                 std::string departmentChair, int numberOfMajors);
 
+        Department(std::shared_ptr<const SnapshotFile> snapshot, size_t index);
         Department();
+        Department(const Department& other);
+        Department& operator=(const Department& other);
 
         int getNumberOfMajors() const;
         void serialize(std::ostream& out) const;
+        void serialize(BufferedWriter& out) const;
         void deserialize(std::istream& in);
+        void deserialize(BufferedReader& in);
         void addPersonToMajor();
-        void dropPersonFromMajor();
+        bool dropPersonFromMajor();
         void addCourse(std::string courseId, std::shared_ptr<Course> course);
         void createCourse(std::string courseId, std::string instructorName, std::string courseLocation,
                         std::string courseTimeSlot, int capacity);
         std::string display() const;
+        std::shared_ptr<const std::string> displayText() const;
+        void writeJson(JsonWriter& out) const;
         std::string getDepartmentChair() const;
-        std::map<std::string, std::shared_ptr<Course>> getCourseSelection() const;
+        const CourseTable& getCourseSelection() const;
+        Course* findCourse(const std::string& courseId) const;
+        void preserveForCheckpoint(uint64_t epoch) const;
+        void writeCheckpoint(SnapshotWriter& writer, const std::string& key, uint64_t epoch) const;
+        void loadCourses() const;
+        bool isLoaded() const;
+        uint64_t getChangedAt() const;
+        uint64_t getVersion() const;
+        DepartmentTotals::Values getCourseTotals() const;
 
     private:
+        void markChanged();
+        void attachCourse(Course& course) const;
+        uint64_t currentVersion() const;
+
+        mutable std::shared_timed_mutex mutex;
         int numberOfMajors;
         std::string deptCode;
         std::string departmentChair;
-        std::map<std::string, std::shared_ptr<Course>> courses;
+        mutable CourseTable courses;
+        mutable std::atomic<bool> coursesLoaded;
+        std::shared_ptr<const SnapshotFile> snapshot;
+        size_t snapshotIndex;
+        mutable std::atomic<uint64_t> checkpointEpoch;
+        mutable int checkpointMajors;
+        std::shared_ptr<std::atomic<uint64_t>> changeStamp;
+        std::shared_ptr<std::atomic<uint64_t>> version;
+        std::shared_ptr<DepartmentTotals> totals;
+        mutable bool hasForeignCourses;
+        RenderCache rendered;
 };
 
 
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#ifndef DEPARTMENTTOTALS_H
+#define DEPARTMENTTOTALS_H
+
+/**
+ * Running totals over the courses of a department: how many courses report to it, their
+ * seats, their enrolled students and how many of them are full. A course adds itself
+ * when it is attached to its department and then reports every change to its capacity
+ * or enrolled count as a difference, so the totals never need a walk over the courses.
+ *
+ * Each total is a separate atomic. Once the changes in flight have finished they are
+ * exact, but a read made while courses change may see one total a change ahead of
+ * another.
+ */
+class DepartmentTotals {
+    public:
+        /**
+         * The totals as read at one moment.
+         */
+        struct Values {
+            size_t courseCount;
+            int64_t seats;
+            int64_t enrolled;
+            size_t fullCourses;
+
+            /**
+             * Gets the share of the department's seats that are taken, or 0 if it has none.
+             */
+            double getFillRate() const {
+                return seats > 0 ? static_cast<double>(enrolled) / static_cast<double>(seats) : 0;
+            }
+        };
+
+        DepartmentTotals() : courseCount(0), seats(0), enrolled(0), fullCourses(0) {}
+        DepartmentTotals(const DepartmentTotals&) = delete;
+        DepartmentTotals& operator=(const DepartmentTotals&) = delete;
+
+        /**
+         * Counts a course with the given capacity and enrolled count.
+         */
+        void addCourse(int capacity, int enrolledCount) {
+            courseCount.fetch_add(1, std::memory_order_acq_rel);
+            seats.fetch_add(capacity, std::memory_order_acq_rel);
+            enrolled.fetch_add(enrolledCount, std::memory_order_acq_rel);
+            if (capacity <= enrolledCount) {
+                fullCourses.fetch_add(1, std::memory_order_acq_rel);
+            }
+        }
+
+        /**
+         * Moves a counted course from one capacity and enrolled count to another. A course
+         * is full when its enrolled count reaches its capacity, as Course::isCourseFull()
+         * says.
+         */
+        void change(int capacityBefore, int enrolledBefore, int capacity, int enrolledCount) {
+            if (capacity != capacityBefore) {
+                seats.fetch_add(capacity - capacityBefore, std::memory_order_acq_rel);
+            }
+            if (enrolledCount != enrolledBefore) {
+                enrolled.fetch_add(enrolledCount - enrolledBefore, std::memory_order_acq_rel);
+            }
+            bool wasFull = capacityBefore <= enrolledBefore;
+            bool isFull = capacity <= enrolledCount;
+            if (wasFull != isFull) {
+                fullCourses.fetch_add(isFull ? 1 : -1, std::memory_order_acq_rel);
+            }
+        }
+
+        Values get() const {
+            return Values{static_cast<size_t>(courseCount.load(std::memory_order_acquire)),
+                          seats.load(std::memory_order_acquire), enrolled.load(std::memory_order_acquire),
+                          static_cast<size_t>(fullCourses.load(std::memory_order_acquire))};
+        }
+
+    private:
+        std::atomic<int64_t> courseCount;
+        std::atomic<int64_t> seats;
+        std::atomic<int64_t> enrolled;
+        std::atomic<int64_t> fullCourses;
+};
+
+#endif
@@ -0,0 +1,57 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include "CourseAttributeIndex.h"
+#include "CourseTable.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#ifndef FULLCOURSEBITMAP_H
+#define FULLCOURSEBITMAP_H
+
+/**
+ * One bit per course, set while the course is full, for listing the closed sections of
+ * the whole catalog or of one department without asking every course. Rows are
+ * numbered in department and course ID order, so each department owns a contiguous run
+ * of bits; a listing walks the 64-bit words of that run, skipping empty words and
+ * taking set bits out of the others with count-trailing-zeros, and a count adds up
+ * popcounts.
+ *
+ * The words are atomics. refresh() sets or clears a course's bit with one atomic
+ * and-or, then checks the course again and repeats if it changed meanwhile, so
+ * concurrent refreshes of one course leave its bit matching the course. Rows are only
+ * added while the bitmap is being built, before it is shared.
+ */
+class FullCourseBitmap {
+    public:
+        FullCourseBitmap();
+        FullCourseBitmap(const FullCourseBitmap&) = delete;
+        FullCourseBitmap& operator=(const FullCourseBitmap&) = delete;
+
+        void addDepartment(const std::string& deptCode, const CourseTable& courses);
+        void refresh(const Course* course);
+        std::vector<CourseRef> findFull() const;
+        std::vector<CourseRef> findFull(const std::string& deptCode) const;
+        size_t countFull() const;
+        size_t size() const;
+
+    private:
+        void set(size_t row, bool full);
+        std::vector<CourseRef> collect(size_t begin, size_t end) const;
+
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+        size_t wordCapacity;
+
+        std::vector<const std::string*> deptCodes;
+        std::vector<const std::string*> courseIds;
+        std::vector<const Course*> courses;
+        std::unordered_map<const Course*, size_t> rows;
+        std::unordered_map<std::string, std::pair<size_t, size_t>> deptRows;
+};
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+/**
+ * Writes JSON text straight onto the end of a string, such as a response body, as the
+ * values are handed to it. Nothing is built on the side: strings are escaped into the
+ * output as they are copied and numbers are formatted in a stack buffer, so writing
+ * takes no allocations beyond the output growing.
+ *
+ * Members of an object are written as key() followed by one value or a nested object
+ * or array; commas are put in by the writer. It keeps one bit per open object or array
+ * saying whether anything was written in it yet, so nesting is limited to 64 levels.
+ * The writer does not check that the calls form valid JSON.
+ */
+class JsonWriter {
+    public:
+        explicit JsonWriter(std::string& out);
+
+        JsonWriter& beginObject();
+        JsonWriter& endObject();
+        JsonWriter& beginArray();
+        JsonWriter& endArray();
+        JsonWriter& key(const char* name);
+        JsonWriter& key(const std::string& name);
+
+        JsonWriter& value(const char* text);
+        JsonWriter& value(const std::string& text);
+        JsonWriter& value(bool flag);
+        JsonWriter& value(double number);
+        JsonWriter& null();
+
+        /**
+         * Writes an integer of any width.
+         */
+        template <typename Integer>
+        typename std::enable_if<std::is_integral<Integer>::value && !std::is_same<Integer, bool>::value,
+                                JsonWriter&>::type
+        value(Integer number) {
+            if (std::is_signed<Integer>::value) {
+                return writeSigned(static_cast<long long>(number));
+            }
+            return writeUnsigned(static_cast<unsigned long long>(number));
+        }
+
+        /**
+         * Writes a member of the current object.
+         */
+        template <typename Value>
+        JsonWriter& field(const char* name, const Value& member) {
+            return key(name).value(member);
+        }
+
+    private:
+        void separate();
+        void open(char bracket);
+        void close(char bracket);
+        void writeString(const char* text, size_t length);
+        JsonWriter& writeSigned(long long number);
+        JsonWriter& writeUnsigned(unsigned long long number);
+        void appendDigits(unsigned long long number);
+
+        std::string& out;
+        uint64_t nonEmpty;
+        int depth;
+        bool afterKey;
+};
+
+#endif
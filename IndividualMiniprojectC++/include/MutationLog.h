@@ -0,0 +1,97 @@
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef MUTATIONLOG_H
+#define MUTATIONLOG_H
+
+/**
+ * Kinds of state change a route can make. Values are part of the on-disk log format.
+ */
+enum class MutationType : uint8_t {
+    AddMajor = 1,
+    RemoveMajor = 2,
+    SetEnrollmentCount = 3,
+    SetCourseLocation = 4,
+    SetCourseInstructor = 5,
+    SetCourseTime = 6,
+    EnrollStudent = 7,
+    DropStudent = 8
+};
+
+/**
+ * A single logged change. Department level changes leave courseId empty; value holds
+ * the enrollment count and text holds the new location, instructor or time slot.
+ */
+struct MutationRecord {
+    MutationType type;
+    std::string deptCode;
+    std::string courseId;
+    int32_t value;
+    std::string text;
+
+    static MutationRecord forDepartment(MutationType type, const std::string& deptCode);
+    static MutationRecord forCourse(MutationType type, const std::string& deptCode, const std::string& courseId,
+                                    int32_t value = 0, const std::string& text = "");
+};
+
+/**
+ * Append-only write-ahead log of mutations. Every record carries a log sequence number
+ * (LSN) so a snapshot can remember the last change it contains and replay can skip
+ * anything older. Records are appended to an in-memory batch and made durable
+ * according to the sync policy:
+ *
+ *   EveryWrite  each record is written and fsynced on its own before append returns
+ *   EveryBatch  group commit: the first waiter writes and fsyncs everything appended
+ *               so far while later arrivals queue up behind it for the next batch
+ *   Interval    a background thread writes and fsyncs every intervalMs; callers never
+ *               wait, so up to one interval of changes can be lost on a crash
+ */
+class MutationLog {
+    public:
+        enum class SyncPolicy { EveryWrite, EveryBatch, Interval };
+
+        struct Options {
+            SyncPolicy policy = SyncPolicy::EveryBatch;
+            int intervalMs = 10;
+        };
+
+        MutationLog(const std::string& filePath, const Options& options, uint64_t lastLsn);
+        ~MutationLog();
+
+        uint64_t append(const MutationRecord& record);
+        uint64_t appendBatch(const std::vector<MutationRecord>& records);
+        void waitDurable(uint64_t lsn);
+        void flush();
+        bool discardThrough(uint64_t snapshotLsn);
+
+        uint64_t getLastLsn() const;
+        uint64_t getSyncCount() const;
+
+        static Options parseOptions(const std::string& policy);
+        static uint64_t replay(const std::string& filePath, uint64_t afterLsn,
+                               const std::function<void(const MutationRecord&)>& apply);
+
+    private:
+        void writeAndSync(const std::string& batch);
+        void flushLoop();
+
+        std::string filePath;
+        Options options;
+        int fd;
+
+        mutable std::mutex mutex;
+        std::condition_variable durableChanged;
+        std::string pending;
+        uint64_t lastLsn;
+        uint64_t durableLsn;
+        uint64_t syncCount;
+        bool flushing;
+        bool stopping;
+        std::thread flusher;
+};
+
+#endif
@@ -9,13 +9,13 @@
 
 class MyApp {
     public:
-        static void run(const std::string& mode);
+        static void run(const std::string& mode, const std::string& syncPolicy = "batch");
         static void onTermination();
         static void overrideDatabase(MyFileDatabase* testData);
         static MyFileDatabase* getDatabase();
 
     private:
-        static void setupDatabase();
+        static void setupDatabase(const MutationLog::Options& logOptions);
         static void resetDataFile();
 
         static MyFileDatabase* myFileDatabase;
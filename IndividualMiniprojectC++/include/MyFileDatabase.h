@@ -1,24 +1,242 @@
+#include "CourseAttributeIndex.h"
+#include "CourseColumns.h"
+#include "CourseIndex.h"
 #include "Department.h"
+#include "FullCourseBitmap.h"
+#include "JsonWriter.h"
+#include "MutationLog.h"
+#include "RoomOccupancy.h"
+#include "TimeRangeIndex.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #ifndef MYFILEDATABASE_H
 #define MYFILEDATABASE_H
 
+/**
+ * Outcome of a mutation sent through MyFileDatabase::commitMutation.
+ */
+enum class MutationResult {
+    Applied,                // state changed and the change was logged
+    Unchanged,              // accepted, but there was nothing to change
+    Rejected,               // not allowed in the current state, e.g. enrolling in a full course
+    DepartmentNotFound,
+    CourseNotFound
+};
+
+/**
+ * Outcome of a batch sent through MyFileDatabase::commitMutations: Applied, or the
+ * result of the mutation that stopped the batch and its position in it.
+ */
+struct BatchResult {
+    MutationResult result;
+    size_t failedIndex;
+};
+
+/**
+ * A course matched by MyFileDatabase::queryCourses.
+ */
+struct CourseMatch {
+    std::string deptCode;
+    std::string courseId;
+    int enrollmentCapacity;
+    int enrolledStudentCount;
+};
+
+/**
+ * One course asked for in a MyFileDatabase::findCourses batch, and what was found.
+ */
+struct CourseLookup {
+    std::string deptCode;
+    int courseNumber;
+    const Department* department;   // nullptr if the department does not exist
+    Course* course;                 // nullptr if the course was not found
+};
+
+/**
+ * In-memory store of every department, persisted to a binary file. Departments are
+ * split into shards by a hash of their code; each shard has its own map and its own
+ * reader/writer lock, so a request only ever touches the shard that owns its
+ * department. Shard locks are only taken exclusively when the whole mapping is
+ * replaced; lookups proceed in parallel and per-record changes are serialized by the
+ * department and course locks. Operations over every department lock the shards in
+ * order, and display() renders the shards in parallel. Pointers returned by the find
+ * methods stay valid until the mapping is replaced.
+ *
+ * Courses are also kept in one CourseIndex over every department, so findCourse()
+ * finds a course with a single probe. The index is built whenever the mapping is
+ * replaced or loaded, from the departments whose courses are in memory, and again by
+ * loadAllDepartments(). Courses it does not hold, such as those of departments still
+ * in the mapped data file or added to a department later, are found through their
+ * department instead. The index is only replaced while every shard is locked
+ * exclusively, so a lookup reads it under the lock of its department's shard.
+ * findCourses() looks up a batch of courses, taking each shard's lock once for all of
+ * the batch's courses in that shard.
+ *
+ * The same courses are mirrored in CourseColumns for queryCourses(), which filters
+ * every course at once, in a CourseAttributeIndex for findCoursesBy(), which finds the
+ * courses with a given instructor, location or time slot, and searchValues(), which
+ * finds the instructors or rooms matching partly typed text, and in a TimeRangeIndex for
+ * findCoursesMeeting(), which finds the courses meeting during a range of the day.
+ * They are rebuilt with the index, and every change made through commitMutation() is
+ * copied into them under the lock of the department's shard. These queries first load
+ * any departments still in the mapped data file.
+ *
+ * Rooms are tracked the same way in a RoomOccupancy. A location or time change made
+ * through commitMutation() is rejected if it would put the course in a room another
+ * course holds at an overlapping time, and findFreeRooms() lists the rooms nobody
+ * holds during a range of the day. A FullCourseBitmap keeps one bit per course that
+ * enrollment changes made through commitMutation() set or clear, and findFullCourses()
+ * lists the set bits. Courses added to a department directly, not through the
+ * database, are not mirrored until the mapping is next replaced or loaded.
+ *
+ * getVersion() moves on with every change made through commitMutation() or
+ * commitMutations() and every time the mapping is replaced or loaded, so a response
+ * built from the whole catalog can be tagged with it. getMappingGeneration() only moves
+ * when the mapping is replaced or loaded, which is when department and course
+ * versions start over.
+ *
+ * commitMutations() makes a batch of course changes all or nothing: every change is
+ * checked before any is made, and the batch is logged as one record.
+ *
+ * When a mutation log is enabled, every change made through commitMutation() is
+ * appended to it, and the snapshot file records the LSN of the last change it holds so
+ * startup can replay only the newer log records on top of it.
+ *
+ * Saving the file is a checkpoint that does not stop request threads. Mutations are
+ * held back only for the instant it takes to pick the checkpoint's LSN; after that the
+ * checkpoint walks the departments while changes continue, and the first change to
+ * each department or course keeps a copy of its earlier state for the checkpoint to
+ * write instead. The file is written next to the old one and renamed over it, after
+ * which the log records it covers are dropped. Checkpoints can also be taken by a
+ * background thread on a timer or after a number of mutations.
+ *
+ * The data path names a manifest listing segment files (see SnapshotManifest). A save
+ * writes a new segment holding only the departments that changed since the previous
+ * save, found by their ChangeClock stamps, and then replaces the manifest. Once the
+ * segments written after the last full save grow to half its size, or there are too
+ * many of them, the next save writes every department into a fresh first segment and
+ * deletes the others.
+ */
 class MyFileDatabase {
     public:
-        MyFileDatabase(int flag, const std::string& filePath);
+        struct CheckpointOptions {
+            int intervalMs = 60000;             // checkpoint at least this often
+            uint64_t everyMutations = 100000;   // or once this many changes were made, 0 for never
+        };
+
+        static const size_t kDefaultShardCount = 64;
+
+        MyFileDatabase(int flag, const std::string& filePath, size_t shardCount = kDefaultShardCount);
+        ~MyFileDatabase();
 
         void setMapping(const std::map<std::string, Department>& mapping);
-        void saveContentsToFile() const;
+        void saveContentsToFile(bool full = false) const;
         void deSerializeObjectFromFile();
+        void loadAllDepartments(unsigned threads);
+        uint64_t getLastSaveBytes() const;
+        static void removeDataFiles(const std::string& filePath);
         
         std::map<std::string, Department> getDepartmentMapping() const;
+        size_t getDepartmentCount() const;
+        const Department* findDepartment(const std::string& deptCode) const;
+        Department* findDepartment(const std::string& deptCode);
+        Course* findCourse(const std::string& deptCode, const std::string& courseId) const;
+        Course* findCourse(const std::string& deptCode, int courseNumber) const;
+        void findCourses(std::vector<CourseLookup>& lookups) const;
         std::string display() const;
+        void writeJson(JsonWriter& out) const;
+        std::vector<CourseMatch> queryCourses(const std::vector<CourseColumns::Condition>& conditions);
+        std::vector<CourseRef> findCoursesBy(CourseAttributeIndex::Attribute attribute, const std::string& value);
+        std::vector<CourseAttributeIndex::SearchHit> searchValues(CourseAttributeIndex::Attribute attribute,
+                                                                  const std::string& query, size_t limit);
+        std::vector<CourseRef> findCoursesMeeting(const TimeInterval& range);
+        std::vector<std::string> findFreeRooms(const TimeInterval& range);
+        std::vector<CourseRef> findFullCourses();
+        std::vector<CourseRef> findFullCourses(const std::string& deptCode);
+        uint64_t getVersion() const;
+        uint64_t getMappingGeneration() const;
+
+        void enableMutationLog(const std::string& logPath, const MutationLog::Options& options);
+        MutationResult commitMutation(const MutationRecord& record);
+        BatchResult commitMutations(const std::vector<MutationRecord>& records);
+        MutationLog* getMutationLog() const;
+
+        void startCheckpointer(const CheckpointOptions& options);
+        void stopCheckpointer();
+        uint64_t getCheckpointCount() const;
 
     private:
-        std::map<std::string, Department> departmentMapping;
+        static const int kOrderingStripes = 64;
+        static const size_t kMaxSegments = 64;
+
+        /**
+         * The departments whose codes hash to one shard.
+         */
+        struct Shard {
+            mutable std::shared_timed_mutex mutex;
+            std::map<std::string, Department> departments;
+        };
+        using DepartmentList = std::vector<std::pair<const std::string*, const Department*>>;
+
+        size_t shardIndexFor(const std::string& deptCode) const;
+        Shard& shardFor(const std::string& deptCode) const;
+        std::vector<std::shared_lock<std::shared_timed_mutex>> lockAllShared() const;
+        std::vector<std::unique_lock<std::shared_timed_mutex>> lockAllExclusive() const;
+        DepartmentList sortedDepartments() const;
+        CourseIndex buildCourseIndex() const;
+        void buildCourseViews();
+        void loadCourseViews();
+        Course* findIndexedCourse(const std::string& deptCode, uint64_t key) const;
+
+        MutationResult applyMutation(const MutationRecord& record, bool replaying);
+        bool moveCourse(const MutationRecord& record, Course* course, bool replaying);
+        BatchResult applyBatch(const std::vector<MutationRecord>& records);
+        std::shared_timed_mutex& orderingStripeFor(const MutationRecord& record);
+        void enterMutation();
+        void exitMutation();
+        void checkpointLoop();
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        CourseIndex courseIndex;
+        std::unique_ptr<CourseColumns> courseColumns;
+        std::unique_ptr<CourseAttributeIndex> attributeIndex;
+        std::unique_ptr<TimeRangeIndex> timeRangeIndex;
+        std::unique_ptr<RoomOccupancy> roomOccupancy;
+        std::unique_ptr<FullCourseBitmap> fullCourses;
+        bool viewsComplete;
+        std::atomic<uint64_t> mappingGeneration;
+        std::atomic<uint64_t> catalogVersion;
         std::string filePath;
+        uint64_t snapshotLsn;
+        std::unique_ptr<MutationLog> mutationLog;
+        std::shared_timed_mutex orderingStripes[kOrderingStripes];
+
+        mutable std::mutex checkpointMutex;
+        mutable std::atomic<bool> checkpointCutPending;
+        mutable std::atomic<int> mutationsInFlight;
+        mutable std::atomic<uint64_t> activeCheckpointEpoch;
+        mutable std::atomic<uint64_t> checkpointCount;
+        mutable std::atomic<uint64_t> mutationsSinceCheckpoint;
+        mutable SnapshotManifest manifest;
+        mutable std::atomic<bool> mappingReplaced;
+        mutable uint64_t lastSavedTick;
+        mutable std::atomic<uint64_t> lastSaveBytes;
+
+        CheckpointOptions checkpointOptions;
+        std::mutex checkpointerMutex;
+        std::condition_variable checkpointerWakeup;
+        bool checkpointerStopping;
+        std::thread checkpointer;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+/**
+ * The last text rendered for an object, tagged with the version of the object it was
+ * rendered from. Readers get the text back without copying it for as long as the
+ * object's version stays the same, and render it again once a change has moved the
+ * version on.
+ *
+ * The entry is swapped as a whole with the atomic shared_ptr functions, so concurrent
+ * readers never wait on each other. Two readers that both miss may both render; the
+ * later store wins, and if that was the older version the next reader simply renders
+ * again.
+ */
+class RenderCache {
+    public:
+        RenderCache() = default;
+        RenderCache(const RenderCache&) = delete;
+        RenderCache& operator=(const RenderCache&) = delete;
+
+        /**
+         * Gets the text rendered from the given version, or nullptr if the cached text
+         * is from another version or nothing was cached yet.
+         */
+        std::shared_ptr<const std::string> get(uint64_t version) const {
+            std::shared_ptr<const Entry> current = std::atomic_load(&entry);
+            if (!current || current->version != version) {
+                return nullptr;
+            }
+            return std::shared_ptr<const std::string>(current, &current->text);
+        }
+
+        /**
+         * Caches text rendered from the given version and hands it back.
+         */
+        std::shared_ptr<const std::string> put(uint64_t version, std::string text) const {
+            std::shared_ptr<const Entry> rendered = std::make_shared<const Entry>(Entry{version, std::move(text)});
+            std::atomic_store(&entry, rendered);
+            return std::shared_ptr<const std::string>(rendered, &rendered->text);
+        }
+
+        /**
+         * Drops the cached text, for when the versions it was tagged with no longer apply.
+         */
+        void clear() const {
+            std::atomic_store(&entry, std::shared_ptr<const Entry>());
+        }
+
+    private:
+        struct Entry {
+            uint64_t version;
+            std::string text;
+        };
+
+        mutable std::shared_ptr<const Entry> entry;
+};
+
+#endif
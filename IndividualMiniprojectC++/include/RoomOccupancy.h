@@ -0,0 +1,91 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include "CourseTable.h"
+#include "TimeInterval.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef ROOMOCCUPANCY_H
+#define ROOMOCCUPANCY_H
+
+/**
+ * Which rooms are in use at which times of day, for refusing changes that would put
+ * two courses in one room at once and for finding free rooms. The day is split into
+ * 5-minute slots, and every room has a bitmap of the slots some course holds it and a
+ * second bitmap of the slots two or more courses hold it, as the data can already
+ * contain clashes. A meeting time is turned into a bitmap of the slots it touches, so
+ * both questions are answered a 64-bit word at a time. Time slots name no days, so the
+ * bitmaps cover one day, and two meetings closer than 5 minutes apart count as a
+ * clash.
+ *
+ * Each placed course remembers its room and slots, so moving it never depends on the
+ * course's own fields. Courses whose location is empty or whose time slot cannot be
+ * parsed hold no room. One reader/writer lock guards the occupancy.
+ */
+class RoomOccupancy {
+    public:
+        static const int kSlotMinutes = 5;
+        static const int kSlots = 24 * 60 / kSlotMinutes;
+        static const int kWords = (kSlots + 63) / 64;
+        using Bitmap = std::array<uint64_t, kWords>;
+
+        /**
+         * A course and the room and meeting time it is to get. A room that is not
+         * pooled is only looked up in the pool, and interned once the move is made.
+         */
+        struct Move {
+            const Course* course;
+            const std::string* room;
+            TimeInterval meeting;
+            bool pooled = true;
+        };
+
+        RoomOccupancy();
+        RoomOccupancy(const RoomOccupancy&) = delete;
+        RoomOccupancy& operator=(const RoomOccupancy&) = delete;
+
+        static Bitmap slotsOf(const TimeInterval& meeting);
+
+        void addDepartment(const CourseTable& courses);
+        bool wouldConflict(const Course* course, const std::string* room, const TimeInterval& meeting) const;
+        bool tryPlace(const Course* course, const std::string* room, const TimeInterval& meeting);
+        bool tryPlaceAll(const std::vector<Move>& moves, size_t& clash);
+        void place(const Course* course, const std::string* room, const TimeInterval& meeting);
+        std::vector<std::string> findFreeRooms(const TimeInterval& range) const;
+        size_t getRoomCount() const;
+
+    private:
+        /**
+         * The slots in which one or more, and two or more, courses hold a room, and how
+         * many hold it in each slot.
+         */
+        struct Room {
+            Bitmap occupied;
+            Bitmap shared;
+            std::array<uint16_t, kSlots> counts;
+        };
+
+        /**
+         * The room and slots a course holds.
+         */
+        struct Placement {
+            const std::string* room;
+            Bitmap slots;
+        };
+
+        bool conflictsLocked(const Course* course, const std::string* room, const Bitmap& slots) const;
+        void placeLocked(const Course* course, const std::string* room, const TimeInterval& meeting);
+        void releaseLocked(const Course* course);
+        void hold(Room& room, const Bitmap& slots, int delta);
+
+        mutable std::shared_timed_mutex mutex;
+        std::unordered_map<const std::string*, Room> rooms;
+        std::unordered_map<const Course*, Placement> placements;
+};
+
+#endif
@@ -5,6 +5,17 @@
 #include "Globals.h"
 #include "MyFileDatabase.h"
 
+/**
+ * The handlers of every route. Successful reads carry an ETag built from the version of
+ * what they show: the department's for department routes, the course's for course
+ * routes, and the database's for queries over the whole catalog. A request whose
+ * If-None-Match header names the current tag gets a 304 with no body, and the response
+ * is not built at all.
+ *
+ * Every read route also answers in JSON, errors included, when asked with format=json
+ * or an Accept header naming application/json. The JSON is written by a JsonWriter
+ * straight into the response body, and is tagged apart from the text form.
+ */
 class RouteController {
     private:
         MyFileDatabase* myFileDatabase;
@@ -18,17 +29,29 @@ class RouteController {
         void retrieveCourse(const crow::request& req, crow::response& res);
         void isCourseFull(const crow::request& req, crow::response& res);
         void getMajorCountFromDept(const crow::request& req, crow::response& res);
+        void getDeptStats(const crow::request& req, crow::response& res);
         void identifyDeptChair(const crow::request& req, crow::response& res);
         void findCourseLocation(const crow::request& req, crow::response& res);
         void findCourseInstructor(const crow::request& req, crow::response& res);
         void findCourseTime(const crow::request& req, crow::response& res);
+        void retrieveCourses(const crow::request& req, crow::response& res);
         void addMajorToDept(const crow::request& req, crow::response& res);
         void removeMajorFromDept(const crow::request& req, crow::response& res);
         void setEnrollmentCount(const crow::request& req, crow::response& res);
         void setCourseLocation(const crow::request& req, crow::response& res);
         void setCourseInstructor(const crow::request& req, crow::response& res);
         void setCourseTime(const crow::request& req, crow::response& res);
+        void enrollStudentInCourse(const crow::request& req, crow::response& res);
         void dropStudentFromCourse(const crow::request&, crow::response& res);
+        void batchUpdate(const crow::request& req, crow::response& res);
+        void queryCourses(const crow::request& req, crow::response& res);
+        void findCoursesByInstructor(const crow::request& req, crow::response& res);
+        void findCoursesByLocation(const crow::request& req, crow::response& res);
+        void findCoursesByTime(const crow::request& req, crow::response& res);
+        void searchInstructors(const crow::request& req, crow::response& res);
+        void findCoursesMeetingBetween(const crow::request& req, crow::response& res);
+        void findFreeRooms(const crow::request& req, crow::response& res);
+        void findFullCourses(const crow::request& req, crow::response& res);
 };
 
 #endif 
@@ -0,0 +1,109 @@
+#include "Course.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+
+/**
+ * Read-only view of a version 2 data file, mapped into memory. The file is laid out so
+ * that any department can be read without decoding the rest:
+ *
+ *   header            magic "CRSSNAP2", snapshot LSN, and the offset and size of
+ *                     each of the sections below
+ *   course table      one fixed-width record per course, grouped by department and
+ *                     sorted by course ID within it
+ *   department table  one fixed-width record per department, sorted by key, holding
+ *                     the index and count of its courses in the course table
+ *   string pool       every distinct string once; records refer to strings by offset
+ *                     and length
+ *
+ * Only the header is read when the file is opened. Pages of the other sections are
+ * read by the operating system when a department is first looked at.
+ */
+class SnapshotFile {
+    public:
+        static std::shared_ptr<const SnapshotFile> open(const std::string& filePath);
+        ~SnapshotFile();
+
+        uint64_t getLsn() const;
+        size_t getDepartmentCount() const;
+        std::string getDepartmentKey(size_t dept) const;
+        std::string getDeptCode(size_t dept) const;
+        std::string getDepartmentChair(size_t dept) const;
+        int getNumberOfMajors(size_t dept) const;
+        size_t getCourseCount(size_t dept) const;
+        std::string getCourseId(size_t dept, size_t course) const;
+        Course::State getCourseState(size_t dept, size_t course) const;
+
+    private:
+        SnapshotFile(const char* data, size_t size);
+
+        const char* departmentRecord(size_t dept) const;
+        const char* courseRecord(size_t dept, size_t course) const;
+        std::string stringAt(const char* ref) const;
+
+        const char* data;
+        size_t size;
+};
+
+/**
+ * Writes a version 2 data file. Departments must be added in key order, each followed
+ * by its courses in course ID order. Course records are streamed to the file as they
+ * are added; the department table, the string pool and the header are written by
+ * finish().
+ */
+class SnapshotWriter {
+    public:
+        explicit SnapshotWriter(const std::string& filePath);
+
+        void addDepartment(const std::string& key, const std::string& deptCode, const std::string& departmentChair,
+                           int numberOfMajors);
+        void addCourse(const std::string& courseId, const Course::State& state);
+        void copyCourses(const SnapshotFile& from, size_t dept);
+        bool finish(uint64_t lsn);
+        uint64_t getFileSize() const;
+
+    private:
+        void putString(std::string& record, const std::string& value);
+
+        std::ofstream out;
+        std::string departmentTable;
+        std::string strings;
+        std::unordered_map<std::string, uint32_t> stringOffsets;
+        uint64_t courseCount;
+        size_t departmentCount;
+        uint64_t fileSize;
+};
+
+/**
+ * The file at a database's data path once it has been saved in segments. Each segment
+ * is a version 2 data file: the first holds every department as of a full save, and
+ * each later one holds only the departments that changed before the save that wrote
+ * it. Reading the segments in order and keeping the last copy of each department gives
+ * the saved catalog. Segment n of the data path P is the file P.seg<n>.
+ *
+ * Layout: [magic "CRSMANI1"][u64 lsn][u64 next segment number][u64 segment count]
+ * then [u64 segment number][u64 segment size] per segment, oldest first.
+ */
+struct SnapshotManifest {
+    struct Segment {
+        uint64_t number;
+        uint64_t size;
+    };
+
+    uint64_t lsn = 0;
+    uint64_t nextSegment = 0;
+    std::vector<Segment> segments;
+
+    static bool read(const std::string& filePath, SnapshotManifest& manifest);
+    static std::string segmentPath(const std::string& filePath, uint64_t number);
+    bool write(const std::string& filePath) const;
+    uint64_t getFileSize() const;
+};
+
+#endif
@@ -0,0 +1,37 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+/**
+ * Process-wide table of interned strings. Courses keep their location, instructor and
+ * time slot as pointers into the pool, so each distinct value is stored once however
+ * many courses share it.
+ *
+ * An interned string is never changed or removed, so the pointer returned by intern()
+ * can be read from any thread without a lock. The table is split into stripes by
+ * string hash, each with its own lock, and a value already in the pool only takes its
+ * stripe's lock in shared mode.
+ */
+class StringPool {
+    public:
+        static const std::string* intern(const std::string& value);
+        static const std::string* find(const std::string& value);
+        static size_t size();
+
+    private:
+        static const size_t kStripes = 16;
+
+        struct Stripe {
+            std::shared_timed_mutex mutex;
+            std::unordered_set<std::string> strings;
+        };
+
+        static Stripe* stripes();
+};
+
+#endif
@@ -0,0 +1,28 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <cstdint>
+#include <string>
+#ifndef TIMEINTERVAL_H
+#define TIMEINTERVAL_H
+
+/**
+ * A meeting time as a half-open interval of minutes after midnight, parsed from a time
+ * slot such as "11:40-12:55". Slots carry no AM or PM, so hours are read the way the
+ * catalog uses them: 8 to 12 as written, 1 to 7 in the afternoon or evening, and 13 to
+ * 23 as 24-hour times. An end earlier than its start is moved 12 hours later, so
+ * "6:10-9:50" is 18:10 to 21:50.
+ *
+ * A slot that cannot be read, such as "TBA", gives an interval that is not valid.
+ */
+struct TimeInterval {
+    int16_t start;
+    int16_t end;
+
+    static TimeInterval parse(const std::string& timeSlot);
+    static bool parseClock(const std::string& text, int& minutes);
+
+    bool isValid() const;
+    bool overlaps(const TimeInterval& other) const;
+};
+
+#endif
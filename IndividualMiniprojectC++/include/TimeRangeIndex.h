@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "Course.h"
+#include "CourseAttributeIndex.h"
+#include "CourseTable.h"
+#include "TimeInterval.h"
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef TIMERANGEINDEX_H
+#define TIMERANGEINDEX_H
+
+/**
+ * Index of courses by meeting time, for finding every course that meets during a range
+ * of the day. A catalog has few distinct meeting intervals, each shared by many
+ * courses, so the courses are grouped by interval and the distinct intervals are
+ * kept in an interval tree: an array sorted by start, searched as an implicit balanced
+ * tree in which every node knows the latest end below it. A range query visits
+ * O(log n) intervals plus those that overlap the range, then returns their courses.
+ *
+ * Each course sits in the list of its interval and remembers its position there, so
+ * refresh() moves a course whose time slot changed in constant time. The tree is
+ * rebuilt only when an interval gains its first course or loses its last one. Courses
+ * whose slot cannot be parsed are not indexed. One reader/writer lock guards the index.
+ */
+class TimeRangeIndex {
+    public:
+        TimeRangeIndex();
+        TimeRangeIndex(const TimeRangeIndex&) = delete;
+        TimeRangeIndex& operator=(const TimeRangeIndex&) = delete;
+
+        void addDepartment(const std::string& deptCode, const CourseTable& courses);
+        void refresh(const Course* course);
+        std::vector<CourseRef> find(const TimeInterval& range) const;
+        size_t getIntervalCount() const;
+
+    private:
+        static uint32_t keyOf(const TimeInterval& interval);
+
+        void post(uint32_t row, const TimeInterval& interval);
+        void unpost(uint32_t row);
+        void rebuildTree();
+        void collect(size_t lo, size_t hi, const TimeInterval& range, std::vector<size_t>& found) const;
+
+        mutable std::shared_timed_mutex mutex;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+        std::vector<TimeInterval> intervals;
+        std::vector<int16_t> maxEnd;
+
+        std::vector<TimeInterval> meetingTimes;
+        std::vector<uint32_t> positions;
+        std::vector<const std::string*> deptCodes;
+        std::vector<const std::string*> courseIds;
+        std::vector<const Course*> courses;
+        std::unordered_map<const Course*, uint32_t> rows;
+};
+
+#endif
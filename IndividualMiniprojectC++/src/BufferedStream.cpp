@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "BufferedStream.h"
+#include <algorithm>
+#include <string>
+
+/**
+ * Creates a reader over the stream's current position.
+ *
+ * @param in        the stream to read from
+ * @param chunkSize how many bytes to read from the stream at a time
+ */
+BufferedReader::BufferedReader(std::istream& in, size_t chunkSize)
+    : in(in), buffer(chunkSize), position(0), end(0), failed(false) {}
+
+/**
+ * Moves the stream back to just after the last byte decoded.
+ */
+BufferedReader::~BufferedReader() {
+    if (end > position) {
+        in.clear();
+        in.seekg(-static_cast<std::streamoff>(end - position), std::ios::cur);
+    }
+}
+
+/**
+ * Copies the next bytes of the stream. If the stream ends first, the rest of the
+ * output is zeroed and the reader stops returning data.
+ *
+ * @param out    where to copy the bytes
+ * @param length how many bytes to copy
+ * @return true if every byte was read
+ */
+bool BufferedReader::readBytes(void* out, size_t length) {
+    char* target = static_cast<char*>(out);
+    while (length > 0) {
+        if (position == end && !refill()) {
+            std::memset(target, 0, length);
+            return false;
+        }
+        size_t count = std::min(length, end - position);
+        std::memcpy(target, buffer.data() + position, count);
+        position += count;
+        target += count;
+        length -= count;
+    }
+    return true;
+}
+
+/**
+ * Reads a string written as its size_t length followed by its bytes. A string that
+ * lies entirely in the buffer is copied in one step.
+ *
+ * @param value receives the string
+ * @return true if the whole string was read
+ */
+bool BufferedReader::readString(std::string& value) {
+    size_t length;
+    if (!read(length)) {
+        value.clear();
+        return false;
+    }
+    if (end - position >= length) {
+        value.assign(buffer.data() + position, length);
+        position += length;
+        return true;
+    }
+    value.resize(length);
+    return readBytes(&value[0], length);
+}
+
+/**
+ * Checks that no read so far has run past the end of the stream.
+ */
+bool BufferedReader::ok() const {
+    return !failed;
+}
+
+bool BufferedReader::refill() {
+    if (failed) {
+        return false;
+    }
+    in.read(buffer.data(), buffer.size());
+    position = 0;
+    end = static_cast<size_t>(in.gcount());
+    if (end == 0) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Creates a writer appending to the stream.
+ *
+ * @param out       the stream to write to
+ * @param chunkSize how many bytes to collect before writing them to the stream
+ */
+BufferedWriter::BufferedWriter(std::ostream& out, size_t chunkSize) : out(out), chunkSize(chunkSize) {
+    buffer.reserve(chunkSize);
+}
+
+BufferedWriter::~BufferedWriter() {
+    flush();
+}
+
+void BufferedWriter::writeBytes(const void* data, size_t length) {
+    if (buffer.size() + length > chunkSize) {
+        flush();
+    }
+    buffer.append(static_cast<const char*>(data), length);
+}
+
+/**
+ * Writes a string as its size_t length followed by its bytes.
+ */
+void BufferedWriter::writeString(const std::string& value) {
+    write(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+/**
+ * Passes everything written so far to the stream.
+ */
+void BufferedWriter::flush() {
+    if (!buffer.empty()) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
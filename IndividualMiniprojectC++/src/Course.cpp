@@ -2,6 +2,8 @@
 
 #include "Course.h"
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 
 
@@ -14,113 +16,357 @@
  * @param capacity           The maximum number of students that can enroll in the course.
  */
 Course::Course(int capacity, const std::string& instructorName, const std::string& courseLocation, const std::string& timeSlot)
-    : enrollmentCapacity(capacity), enrolledStudentCount(0), courseLocation(courseLocation), instructorName(instructorName), courseTimeSlot(timeSlot) {}
+    : enrollmentCapacity(capacity), enrolledStudentCount(0), courseLocation(StringPool::intern(courseLocation)),
+      instructorName(StringPool::intern(instructorName)), courseTimeSlot(StringPool::intern(timeSlot)),
+      meetingTime(TimeInterval::parse(timeSlot)), checkpointEpoch(0), changedAt(0), departmentStamp(nullptr), departmentTotals(nullptr),
+      version(0), departmentVersion(nullptr) {}
 
 /**
  * Constructs a default Course object with the default parameters.
  *
  */
-Course::Course() : enrollmentCapacity(0), enrolledStudentCount(0), courseLocation(""),  instructorName(""), courseTimeSlot("") {}
+Course::Course() : enrollmentCapacity(0), enrolledStudentCount(0), courseLocation(StringPool::intern("")),
+                   instructorName(courseLocation), courseTimeSlot(courseLocation), meetingTime{-1, -1},
+                   checkpointEpoch(0), changedAt(0), departmentStamp(nullptr), departmentTotals(nullptr),
+                   version(0), departmentVersion(nullptr) {}
+
+/**
+ * Constructs a course holding a state read from a data file. The course counts as
+ * unchanged since that file was saved.
+ *
+ * @param state the stored fields of the course
+ */
+Course::Course(const State& state)
+    : enrollmentCapacity(state.enrollmentCapacity), enrolledStudentCount(state.enrolledStudentCount),
+      courseLocation(StringPool::intern(state.courseLocation)), instructorName(StringPool::intern(state.instructorName)),
+      courseTimeSlot(StringPool::intern(state.courseTimeSlot)), meetingTime(TimeInterval::parse(state.courseTimeSlot)),
+      checkpointEpoch(0), changedAt(0), departmentStamp(nullptr), departmentTotals(nullptr),
+      version(0), departmentVersion(nullptr) {}
 
 
 /**
- * Enrolls a student in the course if there is space available.
+ * Enrolls a student in the course if there is space available. Concurrent callers
+ * race on a compare-and-swap of the enrolled count, so the course is never overfilled
+ * and no lock is taken.
  *
  * @return true if the student is successfully enrolled, false otherwise.
  */
 bool Course::enrollStudent() {
-    if (isCourseFull()) {       // course full, cannot enroll
-        return false; 
+    int current = enrolledStudentCount.load(std::memory_order_relaxed);
+    while (current < enrollmentCapacity) {
+        if (enrolledStudentCount.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel)) {
+            reportEnrollment(current, current + 1);
+            markChanged();
+            return true;
+        }
     }
-
-    enrolledStudentCount++; 
-    return true; 
+    return false;       // course full, cannot enroll
 }
 
 /**
- * Drops a student from the course if a student is enrolled.
+ * Drops a student from the course if a student is enrolled, using the same
+ * compare-and-swap loop as enrollStudent().
  *
  * @return true if the student is successfully dropped, false otherwise.
  */
 bool Course::dropStudent() {
-    if (enrolledStudentCount <= 0) {    // no student to drop, cannot drop
-        return false; 
+    int current = enrolledStudentCount.load(std::memory_order_relaxed);
+    while (current > 0) {
+        if (enrolledStudentCount.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel)) {
+            reportEnrollment(current, current - 1);
+            markChanged();
+            return true;
+        }
     }
-    enrolledStudentCount--; 
-    return true;
+    return false;       // no student to drop, cannot drop
 }
 
 std::string Course::getCourseLocation() const {
-    return courseLocation; 
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return *courseLocation;
 }
 
 std::string Course::getInstructorName() const {
-    return instructorName;
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return *instructorName;
 }
 
 std::string Course::getCourseTimeSlot() const {
-    return courseTimeSlot;
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return *courseTimeSlot;
+}
+
+int Course::getEnrolledStudentCount() const {
+    return enrolledStudentCount.load(std::memory_order_acquire);
+}
+
+int Course::getEnrollmentCapacity() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return enrollmentCapacity;
+}
+
+/**
+ * Gets the pooled copies of the course's location, instructor and time slot without
+ * copying the strings.
+ */
+Course::InternedStrings Course::getInternedStrings() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return InternedStrings{courseLocation, instructorName, courseTimeSlot};
+}
+
+/**
+ * Gets the parsed meeting time of the course.
+ *
+ * @return the interval its time slot covers, not valid if the slot cannot be read
+ */
+TimeInterval Course::getMeetingTime() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return meetingTime;
 }
 
 std::string Course::display() const {
-    return "\nInstructor: " + instructorName + "; Location: " + courseLocation + "; Time: " + courseTimeSlot;
+    return *displayText();
+}
+
+/**
+ * Gets the text display() returns without copying it. The text rendered last is kept
+ * and handed back as long as the course has not changed since.
+ *
+ * @return the course's instructor, location and time as display() shows them
+ */
+std::shared_ptr<const std::string> Course::displayText() const {
+    std::shared_ptr<const std::string> cached = rendered.get(version.load(std::memory_order_acquire));
+    if (cached) {
+        return cached;
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    // read under the lock, so a change to the fields cannot slip in between
+    uint64_t current = version.load(std::memory_order_acquire);
+    return rendered.put(current, "\nInstructor: " + *instructorName + "; Location: " + *courseLocation +
+                                 "; Time: " + *courseTimeSlot);
+}
+
+/**
+ * Writes the course's instructor, location, time, capacity and enrolled count as
+ * members of the JSON object being written, read together under the course's lock.
+ *
+ * @param out the writer, inside the object describing the course
+ */
+void Course::writeJsonFields(JsonWriter& out) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    out.field("instructor", *instructorName)
+        .field("location", *courseLocation)
+        .field("time", *courseTimeSlot)
+        .field("capacity", enrollmentCapacity)
+        .field("enrolled", enrolledStudentCount.load(std::memory_order_acquire));
 }
 
 void Course::reassignInstructor(const std::string& newInstructorName) {
-    std::cout << "Old Instructor: " << instructorName << std::endl;
-    this->instructorName = newInstructorName; // Ensure the class member is being updated
-    std::cout << "New Instructor: " << this->instructorName << std::endl;
+    const std::string* interned = StringPool::intern(newInstructorName);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    instructorName = interned;
+    markChanged();
 }
 
 void Course::reassignLocation(const std::string& newLocation) {
-    courseLocation = newLocation;
+    const std::string* interned = StringPool::intern(newLocation);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    courseLocation = interned;
+    markChanged();
 }
 
 void Course::reassignTime(const std::string& newTime) {
-    courseTimeSlot = newTime;
+    const std::string* interned = StringPool::intern(newTime);
+    TimeInterval parsed = TimeInterval::parse(newTime);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    courseTimeSlot = interned;
+    meetingTime = parsed;
+    markChanged();
 }
 
 void Course::setEnrolledStudentCount(int count) {
-    enrolledStudentCount = count;
+    int before = enrolledStudentCount.exchange(count, std::memory_order_acq_rel);
+    reportEnrollment(before, count);
+    markChanged();
 }
 
 bool Course::isCourseFull() const {
-    return enrollmentCapacity <= enrolledStudentCount;
+    return enrollmentCapacity <= enrolledStudentCount.load(std::memory_order_acquire);
 }
 
 void Course::serialize(std::ostream& out) const {
-    out.write(reinterpret_cast<const char*>(&enrollmentCapacity), sizeof(enrollmentCapacity));
-    out.write(reinterpret_cast<const char*>(&enrolledStudentCount), sizeof(enrolledStudentCount));
+    BufferedWriter writer(out);
+    serialize(writer);
+}
 
-    size_t locationLen = courseLocation.length();
-    out.write(reinterpret_cast<const char*>(&locationLen), sizeof(locationLen));
-    out.write(courseLocation.c_str(), locationLen);
+/**
+ * Writes the course in the data file's original format: capacity, enrolled count,
+ * location, instructor and time slot.
+ *
+ * @param out the writer to append to
+ */
+void Course::serialize(BufferedWriter& out) const {
+    State state = getState();
+    out.write(state.enrollmentCapacity);
+    out.write(state.enrolledStudentCount);
+    out.writeString(state.courseLocation);
+    out.writeString(state.instructorName);
+    out.writeString(state.courseTimeSlot);
+}
 
-    size_t instructorLen = instructorName.length();
-    out.write(reinterpret_cast<const char*>(&instructorLen), sizeof(instructorLen));
-    out.write(instructorName.c_str(), instructorLen);
+void Course::deserialize(std::istream& in) {
+    BufferedReader reader(in);
+    deserialize(reader);
+}
 
-    size_t timeSlotLen = courseTimeSlot.length();
-    out.write(reinterpret_cast<const char*>(&timeSlotLen), sizeof(timeSlotLen));
-    out.write(courseTimeSlot.c_str(), timeSlotLen);
+/**
+ * Reads a course written by serialize(), replacing every field. The strings read are
+ * interned.
+ *
+ * @param in the reader positioned at the course
+ */
+void Course::deserialize(BufferedReader& in) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    int capacityBefore = enrollmentCapacity;
+    int enrolled = 0;
+    std::string text;
+    in.read(enrollmentCapacity);
+    in.read(enrolled);
+    int enrolledBefore = enrolledStudentCount.exchange(enrolled, std::memory_order_acq_rel);
+    DepartmentTotals* totals = departmentTotals.load(std::memory_order_acquire);
+    if (totals != nullptr) {
+        totals->change(capacityBefore, enrolledBefore, enrollmentCapacity, enrolled);
+    }
+    in.readString(text);
+    courseLocation = StringPool::intern(text);
+    in.readString(text);
+    instructorName = StringPool::intern(text);
+    in.readString(text);
+    courseTimeSlot = StringPool::intern(text);
+    meetingTime = TimeInterval::parse(text);
+    markChanged();
 }
 
-void Course::deserialize(std::istream& in) {
-    in.read(reinterpret_cast<char*>(&enrollmentCapacity), sizeof(enrollmentCapacity));
-    in.read(reinterpret_cast<char*>(&enrolledStudentCount), sizeof(enrolledStudentCount));
-
-    size_t locationLen;
-    in.read(reinterpret_cast<char*>(&locationLen), sizeof(locationLen));
-    courseLocation.resize(locationLen);
-    in.read(&courseLocation[0], locationLen);
-
-    size_t instructorLen;
-    in.read(reinterpret_cast<char*>(&instructorLen), sizeof(instructorLen));
-    instructorName.resize(instructorLen);
-    in.read(&instructorName[0], instructorLen);
-
-    size_t timeSlotLen;
-    in.read(reinterpret_cast<char*>(&timeSlotLen), sizeof(timeSlotLen));
-    courseTimeSlot.resize(timeSlotLen);
-    in.read(&courseTimeSlot[0], timeSlotLen);
-}
\ No newline at end of file
+/**
+ * Gets a consistent copy of every stored field of the course.
+ *
+ * @return the course's current state
+ */
+Course::State Course::getState() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return currentState();
+}
+
+/**
+ * Gets the ChangeClock tick of the course's last change, or 0 if it has not changed
+ * since it was read from a data file.
+ */
+uint64_t Course::getChangedAt() const {
+    return changedAt.load(std::memory_order_acquire);
+}
+
+/**
+ * Gets the number of changes made to the course since it was constructed. Unlike the
+ * change stamp it moves on with every change, even several within one ChangeClock tick.
+ */
+uint64_t Course::getVersion() const {
+    return version.load(std::memory_order_acquire);
+}
+
+/**
+ * Keeps a copy of the course as it is now for the checkpoint with the given epoch,
+ * unless one was already kept or the checkpoint has already read this course.
+ * Called before every change made while that checkpoint runs.
+ *
+ * @param epoch the epoch of the running checkpoint
+ */
+void Course::preserveForCheckpoint(uint64_t epoch) {
+    if (checkpointEpoch.load(std::memory_order_acquire) >= epoch) {
+        return;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (checkpointEpoch.load(std::memory_order_relaxed) >= epoch) {
+        return;
+    }
+    checkpointImage.reset(new State(currentState()));
+    checkpointEpoch.store(epoch, std::memory_order_release);
+}
+
+/**
+ * Gets the course as it was when the checkpoint with the given epoch began: the copy
+ * kept by preserveForCheckpoint() if the course has changed since, otherwise its
+ * current state. Later changes then no longer need to keep a copy.
+ *
+ * @param epoch the epoch of the running checkpoint
+ * @return the state to write to the checkpoint
+ */
+Course::State Course::stateForCheckpoint(uint64_t epoch) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (checkpointEpoch.load(std::memory_order_relaxed) < epoch || !checkpointImage) {
+        checkpointEpoch.store(epoch, std::memory_order_release);
+        checkpointImage.reset();
+        return currentState();
+    }
+    State state = std::move(*checkpointImage);
+    checkpointImage.reset();
+    return state;
+}
+
+/**
+ * Passes the course's changes on to a department's stamp, version and totals from now
+ * on, after adding the course to the totals. A course reports to the first department
+ * it is attached to only. Enrollment changes racing with the first attach may be
+ * missed by the totals, so a course is attached before it is shared.
+ *
+ * @param stamp       the department's change stamp
+ * @param deptVersion the department's version
+ * @param totals      the department's course totals
+ * @return true if the course reports to this stamp
+ */
+bool Course::attachToDepartment(const std::shared_ptr<std::atomic<uint64_t>>& stamp,
+                                const std::shared_ptr<std::atomic<uint64_t>>& deptVersion,
+                                const std::shared_ptr<DepartmentTotals>& totals) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (!departmentStampHolder) {
+        departmentStampHolder = stamp;
+        departmentStamp.store(stamp.get(), std::memory_order_release);
+        departmentVersionHolder = deptVersion;
+        departmentVersion.store(deptVersion.get(), std::memory_order_release);
+        departmentTotalsHolder = totals;
+        totals->addCourse(enrollmentCapacity, enrolledStudentCount.load(std::memory_order_acquire));
+        departmentTotals.store(totals.get(), std::memory_order_release);
+    }
+    return departmentStampHolder == stamp;
+}
+
+/**
+ * Passes a change of the enrolled count on to the department's totals.
+ */
+void Course::reportEnrollment(int before, int after) {
+    DepartmentTotals* totals = departmentTotals.load(std::memory_order_acquire);
+    if (totals != nullptr) {
+        totals->change(enrollmentCapacity, before, enrollmentCapacity, after);
+    }
+}
+
+void Course::markChanged() {
+    uint64_t tick = ChangeClock::now();
+    ChangeClock::raise(changedAt, tick);
+    std::atomic<uint64_t>* department = departmentStamp.load(std::memory_order_acquire);
+    if (department != nullptr) {
+        ChangeClock::raise(*department, tick);
+    }
+    version.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic<uint64_t>* departmentCount = departmentVersion.load(std::memory_order_acquire);
+    if (departmentCount != nullptr) {
+        departmentCount->fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * Copies the stored fields. The caller holds the course's lock.
+ */
+Course::State Course::currentState() const {
+    return State{enrollmentCapacity, enrolledStudentCount.load(std::memory_order_acquire), *courseLocation,
+                 *instructorName, *courseTimeSlot};
+}
@@ -0,0 +1,278 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "CourseAttributeIndex.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+CourseAttributeIndex::CourseAttributeIndex() {}
+
+/**
+ * Adds every course of a department.
+ *
+ * @param deptCode the key of the department
+ * @param table    the department's courses
+ */
+void CourseAttributeIndex::addDepartment(const std::string& deptCode, const CourseTable& table) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    const std::string* pooledDeptCode = StringPool::intern(deptCode);
+    for (const auto& it : table) {
+        uint32_t row = static_cast<uint32_t>(courses.size());
+        const Course* course = it.second.get();
+        Course::InternedStrings strings = course->getInternedStrings();
+        rows.emplace(course, row);
+        courses.push_back(course);
+        deptCodes.push_back(pooledDeptCode);
+        courseIds.push_back(StringPool::intern(it.first));
+        for (int attribute = 0; attribute < kAttributes; ++attribute) {
+            values[attribute].push_back(nullptr);
+            positions[attribute].push_back(0);
+            post(attribute, row, valueOf(strings, attribute));
+        }
+    }
+}
+
+/**
+ * Moves a course to the lists of its current instructor, location and time slot. A
+ * course that was never added is ignored.
+ *
+ * @param course the course that was reassigned
+ */
+void CourseAttributeIndex::refresh(const Course* course) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    auto it = rows.find(course);
+    if (it == rows.end()) {
+        return;
+    }
+    Course::InternedStrings strings = course->getInternedStrings();
+    for (int attribute = 0; attribute < kAttributes; ++attribute) {
+        const std::string* value = valueOf(strings, attribute);
+        if (values[attribute][it->second] != value) {
+            unpost(attribute, it->second);
+            post(attribute, it->second, value);
+        }
+    }
+}
+
+/**
+ * Finds the courses with the given value of an attribute.
+ *
+ * @param attribute the attribute to look up
+ * @param value     the instructor, location or time slot
+ * @return the courses, in the order they were added
+ */
+std::vector<CourseRef> CourseAttributeIndex::find(Attribute attribute, const std::string& value) const {
+    const std::string* pooled = StringPool::find(value);
+    if (pooled == nullptr) {
+        return {};
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    const Postings& lists = postings[static_cast<int>(attribute)];
+    auto it = lists.find(pooled);
+    if (it == lists.end()) {
+        return {};
+    }
+    std::vector<uint32_t> matched(it->second);
+    std::sort(matched.begin(), matched.end());
+    std::vector<CourseRef> result;
+    result.reserve(matched.size());
+    for (uint32_t row : matched) {
+        result.push_back(CourseRef{*deptCodes[row], *courseIds[row], courses[row]});
+    }
+    return result;
+}
+
+/**
+ * Finds the values of an attribute that best match partial or misspelled text, such
+ * as "Kais" or "Borowsk" for instructors. Values in which every word of the query
+ * starts a word come first, then values by the share of the query's trigrams they
+ * hold, then by the number of courses holding them.
+ *
+ * @param attribute the attribute to search
+ * @param query     the text typed so far
+ * @param limit     the most values to return
+ * @return the best matches, best first
+ */
+std::vector<CourseAttributeIndex::SearchHit> CourseAttributeIndex::search(Attribute attribute,
+                                                                          const std::string& query,
+                                                                          size_t limit) const {
+    std::vector<std::string> queryWords = wordsOf(query);
+    std::vector<uint32_t> queryTrigrams = trigramsOf(query);
+    if (queryTrigrams.empty() || limit == 0) {
+        return {};
+    }
+
+    struct Candidate {
+        const std::string* value;
+        size_t shared;
+        bool prefix;
+        size_t courseCount;
+    };
+    int index = static_cast<int>(attribute);
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    std::vector<uint8_t> shared(terms[index].size());
+    std::vector<uint32_t> touched;
+    for (uint32_t trigram : queryTrigrams) {
+        auto it = trigrams[index].find(trigram);
+        if (it == trigrams[index].end()) {
+            continue;
+        }
+        for (uint32_t term : it->second) {
+            if (shared[term] == 0) {
+                touched.push_back(term);
+            }
+            shared[term] = static_cast<uint8_t>(std::min(shared[term] + 1, 255));
+        }
+    }
+
+    std::vector<Candidate> candidates;
+    for (uint32_t term : touched) {
+        if (shared[term] * 2u < queryTrigrams.size()) {
+            continue;
+        }
+        const std::vector<std::string>& words = terms[index][term].words;
+        bool prefix = true;
+        for (const std::string& queryWord : queryWords) {
+            prefix = prefix && std::any_of(words.begin(), words.end(), [&queryWord](const std::string& word) {
+                return word.compare(0, queryWord.size(), queryWord) == 0;
+            });
+        }
+        const std::string* value = terms[index][term].value;
+        candidates.push_back(Candidate{value, shared[term], prefix, postings[index].at(value).size()});
+    }
+    lock.unlock();
+
+    auto better = [](const Candidate& a, const Candidate& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix;
+        }
+        if (a.shared != b.shared) {
+            return a.shared > b.shared;
+        }
+        if (a.courseCount != b.courseCount) {
+            return a.courseCount > b.courseCount;
+        }
+        return *a.value < *b.value;
+    };
+    size_t count = std::min(limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), better);
+    std::vector<SearchHit> hits;
+    for (size_t i = 0; i < count; ++i) {
+        hits.push_back(SearchHit{*candidates[i].value, candidates[i].courseCount});
+    }
+    return hits;
+}
+
+/**
+ * Gets the number of courses in the index.
+ */
+size_t CourseAttributeIndex::size() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return courses.size();
+}
+
+const std::string* CourseAttributeIndex::valueOf(const Course::InternedStrings& strings, int attribute) {
+    switch (static_cast<Attribute>(attribute)) {
+        case Attribute::Instructor:
+            return strings.instructorName;
+        case Attribute::Location:
+            return strings.courseLocation;
+        default:
+            return strings.courseTimeSlot;
+    }
+}
+
+/**
+ * Splits text into lowercase words of letters and digits.
+ */
+std::vector<std::string> CourseAttributeIndex::wordsOf(const std::string& text) {
+    std::vector<std::string> words(1);
+    for (char c : text) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            words.back() += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!words.back().empty()) {
+            words.emplace_back();
+        }
+    }
+    if (words.back().empty()) {
+        words.pop_back();
+    }
+    return words;
+}
+
+/**
+ * Gets the distinct trigrams of the words of text, each word padded at its start.
+ */
+std::vector<uint32_t> CourseAttributeIndex::trigramsOf(const std::string& text) {
+    std::vector<uint32_t> result;
+    for (const std::string& word : wordsOf(text)) {
+        std::string padded = "$$" + word;
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            result.push_back(static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+                             static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8 |
+                             static_cast<unsigned char>(padded[i + 2]));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+/**
+ * Appends a row to the list of a value, making the value a search term if it is
+ * its first row. The caller holds the lock exclusively.
+ */
+void CourseAttributeIndex::post(int attribute, uint32_t row, const std::string* value) {
+    auto inserted = postings[attribute].emplace(value, std::vector<uint32_t>());
+    if (inserted.second) {
+        uint32_t term = static_cast<uint32_t>(terms[attribute].size());
+        if (freeTerms[attribute].empty()) {
+            terms[attribute].emplace_back();
+        } else {
+            term = freeTerms[attribute].back();
+            freeTerms[attribute].pop_back();
+        }
+        terms[attribute][term] = Term{value, wordsOf(*value)};
+        termNumbers[attribute][value] = term;
+        for (uint32_t trigram : trigramsOf(*value)) {
+            trigrams[attribute][trigram].push_back(term);
+        }
+    }
+    std::vector<uint32_t>& list = inserted.first->second;
+    values[attribute][row] = value;
+    positions[attribute][row] = static_cast<uint32_t>(list.size());
+    list.push_back(row);
+}
+
+/**
+ * Removes a row from the list of its value by moving the list's last row into its
+ * place, and frees the value's search term if that was its last row. The
+ * caller holds the lock exclusively.
+ */
+void CourseAttributeIndex::unpost(int attribute, uint32_t row) {
+    auto it = postings[attribute].find(values[attribute][row]);
+    std::vector<uint32_t>& list = it->second;
+    uint32_t last = list.back();
+    list[positions[attribute][row]] = last;
+    positions[attribute][last] = positions[attribute][row];
+    list.pop_back();
+    if (list.empty()) {
+        auto number = termNumbers[attribute].find(it->first);
+        uint32_t term = number->second;
+        for (uint32_t trigram : trigramsOf(*it->first)) {
+            auto holders = trigrams[attribute].find(trigram);
+            holders->second.erase(std::find(holders->second.begin(), holders->second.end(), term));
+            if (holders->second.empty()) {
+                trigrams[attribute].erase(holders);
+            }
+        }
+        terms[attribute][term] = Term{nullptr, {}};
+        freeTerms[attribute].push_back(term);
+        termNumbers[attribute].erase(number);
+        postings[attribute].erase(it);
+    }
+}
@@ -0,0 +1,428 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "CourseColumns.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Clears the mask byte of every row whose value lies outside [lo, hi].
+ */
+void keepInRange(const int32_t* values, size_t count, int32_t lo, int32_t hi, uint8_t* mask) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i low = _mm_set1_epi32(lo);
+    const __m128i high = _mm_set1_epi32(hi);
+    for (; i + 16 <= count; i += 16) {
+        __m128i outside[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 4 * k));
+            outside[k] = _mm_or_si128(_mm_cmplt_epi32(x, low), _mm_cmpgt_epi32(x, high));
+        }
+        __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(outside[0], outside[1]),
+                                        _mm_packs_epi32(outside[2], outside[3]));
+        __m128i* target = reinterpret_cast<__m128i*>(mask + i);
+        _mm_storeu_si128(target, _mm_andnot_si128(bytes, _mm_loadu_si128(target)));
+    }
+#endif
+    for (; i < count; ++i) {
+        mask[i] &= values[i] >= lo && values[i] <= hi ? 0xFF : 0;
+    }
+}
+
+/**
+ * Comparisons of enrolled with threshold * capacity, in single precision both in SIMD
+ * registers and in the scalar loop so that both give the same answer.
+ */
+struct FillLess {
+#if defined(__SSE2__)
+    static __m128 simd(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
+#endif
+    static bool scalar(float a, float b) { return a < b; }
+};
+
+struct FillLessOrEqual {
+#if defined(__SSE2__)
+    static __m128 simd(__m128 a, __m128 b) { return _mm_cmple_ps(a, b); }
+#endif
+    static bool scalar(float a, float b) { return a <= b; }
+};
+
+struct FillEqual {
+#if defined(__SSE2__)
+    static __m128 simd(__m128 a, __m128 b) { return _mm_cmpeq_ps(a, b); }
+#endif
+    static bool scalar(float a, float b) { return a == b; }
+};
+
+struct FillGreaterOrEqual {
+#if defined(__SSE2__)
+    static __m128 simd(__m128 a, __m128 b) { return _mm_cmpge_ps(a, b); }
+#endif
+    static bool scalar(float a, float b) { return a >= b; }
+};
+
+struct FillGreater {
+#if defined(__SSE2__)
+    static __m128 simd(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+#endif
+    static bool scalar(float a, float b) { return a > b; }
+};
+
+/**
+ * Clears the mask byte of every row whose enrolled count fails the comparison with
+ * threshold * capacity.
+ */
+template <typename Compare>
+void keepFill(const int32_t* enrolled, const int32_t* capacity, size_t count, float threshold, uint8_t* mask) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(threshold);
+    for (; i + 16 <= count; i += 16) {
+        __m128i pass[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128 e = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(enrolled + i + 4 * k)));
+            __m128 c = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(capacity + i + 4 * k)));
+            pass[k] = _mm_castps_si128(Compare::simd(e, _mm_mul_ps(c, scale)));
+        }
+        __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(pass[0], pass[1]), _mm_packs_epi32(pass[2], pass[3]));
+        __m128i* target = reinterpret_cast<__m128i*>(mask + i);
+        _mm_storeu_si128(target, _mm_and_si128(bytes, _mm_loadu_si128(target)));
+    }
+#endif
+    for (; i < count; ++i) {
+        float limit = static_cast<float>(capacity[i]) * threshold;
+        mask[i] &= Compare::scalar(static_cast<float>(enrolled[i]), limit) ? 0xFF : 0;
+    }
+}
+
+void keepFill(CourseColumns::Comparison comparison, const int32_t* enrolled, const int32_t* capacity, size_t count,
+              float threshold, uint8_t* mask) {
+    switch (comparison) {
+        case CourseColumns::Comparison::Less:
+            keepFill<FillLess>(enrolled, capacity, count, threshold, mask);
+            break;
+        case CourseColumns::Comparison::LessOrEqual:
+            keepFill<FillLessOrEqual>(enrolled, capacity, count, threshold, mask);
+            break;
+        case CourseColumns::Comparison::Equal:
+            keepFill<FillEqual>(enrolled, capacity, count, threshold, mask);
+            break;
+        case CourseColumns::Comparison::GreaterOrEqual:
+            keepFill<FillGreaterOrEqual>(enrolled, capacity, count, threshold, mask);
+            break;
+        case CourseColumns::Comparison::Greater:
+            keepFill<FillGreater>(enrolled, capacity, count, threshold, mask);
+            break;
+    }
+}
+
+/**
+ * Turns a comparison of an integer column with a number into the inclusive range of
+ * values that pass it.
+ *
+ * @return false if no value passes
+ */
+bool integerRange(CourseColumns::Comparison comparison, double number, int32_t& lo, int32_t& hi) {
+    const double min = std::numeric_limits<int32_t>::min();
+    const double max = std::numeric_limits<int32_t>::max();
+    double low = min;
+    double high = max;
+    switch (comparison) {
+        case CourseColumns::Comparison::Less:
+            high = std::ceil(number) - 1;
+            break;
+        case CourseColumns::Comparison::LessOrEqual:
+            high = std::floor(number);
+            break;
+        case CourseColumns::Comparison::Equal:
+            low = std::ceil(number);
+            high = std::floor(number);
+            break;
+        case CourseColumns::Comparison::GreaterOrEqual:
+            low = std::ceil(number);
+            break;
+        case CourseColumns::Comparison::Greater:
+            low = std::floor(number) + 1;
+            break;
+    }
+    low = std::max(low, min);
+    high = std::min(high, max);
+    if (low > high) {
+        return false;
+    }
+    lo = static_cast<int32_t>(low);
+    hi = static_cast<int32_t>(high);
+    return true;
+}
+
+/**
+ * A condition with its operands resolved against the columns.
+ */
+struct ResolvedCondition {
+    CourseColumns::Column column;
+    CourseColumns::Comparison comparison;
+    int32_t lo;
+    int32_t hi;
+    float threshold;
+};
+
+}  // namespace
+
+/**
+ * Parses a condition such as "capacity>100", "fill>=0.9" or "dept=COMS". Columns are
+ * capacity, enrolled, fill, dept, location, instructor and time.
+ *
+ * @param condition the text of the condition
+ * @param parsed    set to the condition on success
+ * @return false if the text is not a valid condition
+ */
+bool CourseColumns::Condition::parse(const std::string& condition, Condition& parsed) {
+    size_t at = condition.find_first_of("<>=");
+    if (at == std::string::npos || at == 0) {
+        return false;
+    }
+    std::string name = condition.substr(0, at);
+    size_t length = at + 1 < condition.size() && condition[at] != '=' && condition[at + 1] == '=' ? 2 : 1;
+    std::string op = condition.substr(at, length);
+    std::string operand = condition.substr(at + length);
+
+    if (op == "<") {
+        parsed.comparison = Comparison::Less;
+    } else if (op == "<=") {
+        parsed.comparison = Comparison::LessOrEqual;
+    } else if (op == "=") {
+        parsed.comparison = Comparison::Equal;
+    } else if (op == ">=") {
+        parsed.comparison = Comparison::GreaterOrEqual;
+    } else {
+        parsed.comparison = Comparison::Greater;
+    }
+
+    if (name == "dept" || name == "location" || name == "instructor" || name == "time") {
+        parsed.column = name == "dept" ? Column::Department
+                        : name == "location" ? Column::Location
+                        : name == "instructor" ? Column::Instructor
+                                               : Column::TimeSlot;
+        parsed.text = operand;
+        parsed.number = 0;
+        return parsed.comparison == Comparison::Equal;
+    }
+    if (name == "capacity") {
+        parsed.column = Column::Capacity;
+    } else if (name == "enrolled") {
+        parsed.column = Column::Enrolled;
+    } else if (name == "fill") {
+        parsed.column = Column::Fill;
+    } else {
+        return false;
+    }
+    char* end = nullptr;
+    parsed.number = std::strtod(operand.c_str(), &end);
+    parsed.text.clear();
+    return !operand.empty() && *end == '\0' && std::isfinite(parsed.number);
+}
+
+CourseColumns::CourseColumns() {}
+
+/**
+ * Appends a row for every course of a department.
+ *
+ * @param deptCode the key of the department
+ * @param courses  the department's courses
+ */
+void CourseColumns::addDepartment(const std::string& deptCode, const CourseTable& courses) {
+    auto inserted = deptIds.emplace(deptCode, static_cast<int32_t>(deptCodes.size()));
+    if (inserted.second) {
+        deptCodes.push_back(deptCode);
+    }
+    for (const auto& it : courses) {
+        const Course* course = it.second.get();
+        Course::InternedStrings strings = course->getInternedStrings();
+        rows.emplace(course, capacity.size());
+        capacity.push_back(course->getEnrollmentCapacity());
+        enrolled.push_back(course->getEnrolledStudentCount());
+        department.push_back(inserted.first->second);
+        location.push_back(idOf(strings.courseLocation));
+        instructor.push_back(idOf(strings.instructorName));
+        timeSlot.push_back(idOf(strings.courseTimeSlot));
+        courseIds.push_back(StringPool::intern(it.first));
+    }
+    while (blockLocks.size() * kBlockRows < capacity.size()) {
+        blockLocks.emplace_back(new std::shared_timed_mutex());
+    }
+}
+
+/**
+ * Copies every field of a course into its row, if it has one.
+ *
+ * @param course the course that changed
+ */
+void CourseColumns::refresh(const Course* course) {
+    auto it = rows.find(course);
+    if (it == rows.end()) {
+        return;
+    }
+    size_t row = it->second;
+    std::unique_lock<std::shared_timed_mutex> lock(blockLock(row));
+    Course::InternedStrings strings = course->getInternedStrings();
+    capacity[row] = course->getEnrollmentCapacity();
+    enrolled[row] = course->getEnrolledStudentCount();
+    location[row] = idOf(strings.courseLocation);
+    instructor[row] = idOf(strings.instructorName);
+    timeSlot[row] = idOf(strings.courseTimeSlot);
+}
+
+/**
+ * Copies a course's enrolled count into its row, if it has one. The count is read
+ * under the row's lock, so when enrollments race the last refresh stores the latest
+ * count.
+ *
+ * @param course the course whose enrollment changed
+ */
+void CourseColumns::refreshEnrollment(const Course* course) {
+    auto it = rows.find(course);
+    if (it == rows.end()) {
+        return;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(blockLock(it->second));
+    enrolled[it->second] = course->getEnrolledStudentCount();
+}
+
+/**
+ * Finds the rows that pass every condition. Each block of rows is filtered with a
+ * byte mask: every condition clears the bytes of the rows failing it, many rows per
+ * instruction, and the rows left set are collected.
+ *
+ * @param conditions the conditions, all of which must hold
+ * @return the matching rows, in department and course ID order
+ */
+std::vector<size_t> CourseColumns::select(const std::vector<Condition>& conditions) const {
+    std::vector<ResolvedCondition> resolved;
+    for (const Condition& condition : conditions) {
+        ResolvedCondition r{condition.column, condition.comparison, 0, 0, 0};
+        switch (condition.column) {
+            case Column::Capacity:
+            case Column::Enrolled:
+                if (!integerRange(condition.comparison, condition.number, r.lo, r.hi)) {
+                    return {};
+                }
+                break;
+            case Column::Fill:
+                r.threshold = static_cast<float>(condition.number);
+                break;
+            case Column::Department: {
+                auto it = deptIds.find(condition.text);
+                if (it == deptIds.end()) {
+                    return {};
+                }
+                r.lo = r.hi = it->second;
+                break;
+            }
+            default:
+                r.lo = r.hi = findId(StringPool::find(condition.text));
+                if (r.lo < 0) {
+                    return {};
+                }
+                break;
+        }
+        resolved.push_back(r);
+    }
+
+    std::vector<size_t> matches;
+    std::vector<uint8_t> mask(kBlockRows);
+    for (size_t start = 0; start < capacity.size(); start += kBlockRows) {
+        size_t count = std::min(kBlockRows, capacity.size() - start);
+        std::shared_lock<std::shared_timed_mutex> lock(blockLock(start));
+        std::fill(mask.begin(), mask.begin() + count, 0xFF);
+        for (const ResolvedCondition& r : resolved) {
+            switch (r.column) {
+                case Column::Capacity:
+                    keepInRange(&capacity[start], count, r.lo, r.hi, mask.data());
+                    break;
+                case Column::Enrolled:
+                    keepInRange(&enrolled[start], count, r.lo, r.hi, mask.data());
+                    break;
+                case Column::Fill:
+                    keepFill(r.comparison, &enrolled[start], &capacity[start], count, r.threshold, mask.data());
+                    break;
+                case Column::Department:
+                    keepInRange(&department[start], count, r.lo, r.hi, mask.data());
+                    break;
+                case Column::Location:
+                    keepInRange(&location[start], count, r.lo, r.hi, mask.data());
+                    break;
+                case Column::Instructor:
+                    keepInRange(&instructor[start], count, r.lo, r.hi, mask.data());
+                    break;
+                case Column::TimeSlot:
+                    keepInRange(&timeSlot[start], count, r.lo, r.hi, mask.data());
+                    break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (mask[i]) {
+                matches.push_back(start + i);
+            }
+        }
+    }
+    return matches;
+}
+
+/**
+ * Gets the number of rows.
+ */
+size_t CourseColumns::size() const {
+    return capacity.size();
+}
+
+const std::string& CourseColumns::getDeptCode(size_t row) const {
+    return deptCodes[department[row]];
+}
+
+const std::string& CourseColumns::getCourseId(size_t row) const {
+    return *courseIds[row];
+}
+
+int CourseColumns::getCapacity(size_t row) const {
+    std::shared_lock<std::shared_timed_mutex> lock(blockLock(row));
+    return capacity[row];
+}
+
+int CourseColumns::getEnrolled(size_t row) const {
+    std::shared_lock<std::shared_timed_mutex> lock(blockLock(row));
+    return enrolled[row];
+}
+
+/**
+ * Gets the id of a pooled string, assigning the next id to a string not seen before.
+ */
+int32_t CourseColumns::idOf(const std::string* pooled) {
+    std::lock_guard<std::mutex> lock(stringIdsMutex);
+    return stringIds.emplace(pooled, static_cast<int32_t>(stringIds.size())).first->second;
+}
+
+/**
+ * Gets the id of a pooled string, or -1 if no row ever held it.
+ */
+int32_t CourseColumns::findId(const std::string* pooled) const {
+    std::lock_guard<std::mutex> lock(stringIdsMutex);
+    auto it = stringIds.find(pooled);
+    return it == stringIds.end() ? -1 : it->second;
+}
+
+std::shared_timed_mutex& CourseColumns::blockLock(size_t row) const {
+    return *blockLocks[row / kBlockRows];
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "CourseIndex.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The table is grown before it gets fuller than 7 slots in 10.
+const size_t kMaxLoadNumerator = 7;
+const size_t kMaxLoadDenominator = 10;
+const size_t kMinSlots = 16;
+
+// Fibonacci hashing: the upper bits of key * 2^64 / golden ratio pick the slot.
+const uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ull;
+
+/**
+ * Packs a department code of one to four bytes into the upper half of a key.
+ */
+bool packDeptCode(const std::string& deptCode, uint64_t& key) {
+    if (deptCode.empty() || deptCode.size() > 4) {
+        return false;
+    }
+    uint64_t packed = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        unsigned char c = i < deptCode.size() ? static_cast<unsigned char>(deptCode[i]) : 0;
+        if (i < deptCode.size() && c == 0) {
+            return false;
+        }
+        packed = (packed << 8) | c;
+    }
+    key = packed << 32;
+    return true;
+}
+
+}  // namespace
+
+CourseIndex::CourseIndex() : CourseIndex(0) {}
+
+/**
+ * Constructs an empty index with room for the given number of courses.
+ *
+ * @param expectedCourses the number of courses to size the table for
+ */
+CourseIndex::CourseIndex(size_t expectedCourses) : count(0) {
+    size_t capacity = kMinSlots;
+    shift = 60;
+    while (capacity * kMaxLoadNumerator < expectedCourses * kMaxLoadDenominator) {
+        capacity *= 2;
+        --shift;
+    }
+    slots.assign(capacity, Slot{0, nullptr});
+    mask = capacity - 1;
+}
+
+/**
+ * Packs a department code and a course ID into an index key. The course ID must be
+ * the decimal form of a number that fits in 32 bits, written without a sign or
+ * leading zeros.
+ *
+ * @param deptCode the department offering the course
+ * @param courseId the ID of the course within the department
+ * @param key      set to the packed key on success
+ * @return false if the course cannot be indexed
+ */
+bool CourseIndex::packKey(const std::string& deptCode, const std::string& courseId, uint64_t& key) {
+    if (courseId.empty() || courseId.size() > 10 || (courseId[0] == '0' && courseId.size() > 1)) {
+        return false;
+    }
+    uint64_t number = 0;
+    for (char c : courseId) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        number = number * 10 + (c - '0');
+    }
+    if (number > 0xFFFFFFFFull || !packDeptCode(deptCode, key)) {
+        return false;
+    }
+    key |= number;
+    return true;
+}
+
+/**
+ * Packs a department code and a course number into an index key.
+ *
+ * @param deptCode     the department offering the course
+ * @param courseNumber the course number; negative numbers cannot be indexed
+ * @param key          set to the packed key on success
+ * @return false if the course cannot be indexed
+ */
+bool CourseIndex::packKey(const std::string& deptCode, int courseNumber, uint64_t& key) {
+    if (courseNumber < 0 || !packDeptCode(deptCode, key)) {
+        return false;
+    }
+    key |= static_cast<uint32_t>(courseNumber);
+    return true;
+}
+
+/**
+ * Adds a course to the index, or replaces the course stored under the same key.
+ *
+ * @param key    a key built by packKey()
+ * @param course the course to find under it
+ */
+void CourseIndex::insert(uint64_t key, Course* course) {
+    if ((count + 1) * kMaxLoadDenominator > slots.size() * kMaxLoadNumerator) {
+        CourseIndex larger(slots.size());
+        for (const Slot& slot : slots) {
+            if (slot.key != 0) {
+                larger.insert(slot.key, slot.course);
+            }
+        }
+        *this = std::move(larger);
+    }
+    for (size_t i = slotFor(key);; i = (i + 1) & mask) {
+        if (slots[i].key == 0) {
+            slots[i] = Slot{key, course};
+            ++count;
+            return;
+        }
+        if (slots[i].key == key) {
+            slots[i].course = course;
+            return;
+        }
+    }
+}
+
+/**
+ * Looks up a course by its packed key.
+ *
+ * @param key a key built by packKey()
+ * @return the course, or nullptr if it is not in the index
+ */
+Course* CourseIndex::find(uint64_t key) const {
+    for (size_t i = slotFor(key);; i = (i + 1) & mask) {
+        if (slots[i].key == key) {
+            return slots[i].course;
+        }
+        if (slots[i].key == 0) {
+            return nullptr;
+        }
+    }
+}
+
+/**
+ * Gets the number of courses in the index.
+ */
+size_t CourseIndex::size() const {
+    return count;
+}
+
+size_t CourseIndex::slotFor(uint64_t key) const {
+    return static_cast<size_t>((key * kHashMultiplier) >> shift) & mask;
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "CourseTable.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+
+bool idLess(const CourseTable::value_type& entry, const std::string& courseId) {
+    return entry.first < courseId;
+}
+
+}  // namespace
+
+CourseTable::CourseTable() {}
+
+/**
+ * Constructs a table holding the given courses, shared with the map.
+ *
+ * @param courses the courses by ID
+ */
+CourseTable::CourseTable(const std::map<std::string, std::shared_ptr<Course>>& courses)
+    : entries(courses.begin(), courses.end()) {}
+
+/**
+ * Copies a table. The copy shares the courses but not the room reserved for more.
+ *
+ * @param other the table to copy
+ */
+CourseTable::CourseTable(const CourseTable& other) : entries(other.entries) {}
+
+CourseTable& CourseTable::operator=(const CourseTable& other) {
+    entries = other.entries;
+    block.reset();
+    return *this;
+}
+
+/**
+ * Sets aside room for the given number of courses to be built by emplace() in one
+ * allocation. Courses emplaced beyond that are allocated one at a time.
+ *
+ * @param count the number of courses about to be emplaced
+ */
+void CourseTable::reserveContiguous(size_t count) {
+    entries.reserve(entries.size() + count);
+    block = count == 0 ? nullptr : std::make_shared<Block>(count);
+}
+
+/**
+ * Builds a course in the reserved block if it has room, and on its own otherwise. A
+ * course in a block shares the block's ownership, so the block lives as long as any
+ * of its courses is held.
+ */
+template <typename... Args>
+std::shared_ptr<Course> CourseTable::makeCourse(Args&&... args) {
+    if (!block || block->isFull()) {
+        block.reset();
+        return std::make_shared<Course>(std::forward<Args>(args)...);
+    }
+    return std::shared_ptr<Course>(block, block->construct(std::forward<Args>(args)...));
+}
+
+/**
+ * Builds an empty course in the table, replacing any course with the same ID.
+ *
+ * @param courseId the ID of the new course
+ * @return the new course
+ */
+Course& CourseTable::emplace(const std::string& courseId) {
+    std::shared_ptr<Course> course = makeCourse();
+    Course& added = *course;
+    set(courseId, std::move(course));
+    return added;
+}
+
+/**
+ * Builds a course holding a state read from a data file, replacing any course with
+ * the same ID.
+ *
+ * @param courseId the ID of the new course
+ * @param state    the stored fields of the course
+ * @return the new course
+ */
+Course& CourseTable::emplace(const std::string& courseId, const Course::State& state) {
+    std::shared_ptr<Course> course = makeCourse(state);
+    Course& added = *course;
+    set(courseId, std::move(course));
+    return added;
+}
+
+/**
+ * Adds a course, or replaces the course with the same ID. Courses added in ID order
+ * are appended without searching.
+ *
+ * @param courseId the ID of the course
+ * @param course   the course
+ */
+void CourseTable::set(const std::string& courseId, std::shared_ptr<Course> course) {
+    if (entries.empty() || entries.back().first < courseId) {
+        entries.emplace_back(courseId, std::move(course));
+        return;
+    }
+    auto it = std::lower_bound(entries.begin(), entries.end(), courseId, idLess);
+    if (it != entries.end() && it->first == courseId) {
+        it->second = std::move(course);
+    } else {
+        entries.emplace(it, courseId, std::move(course));
+    }
+}
+
+/**
+ * Finds the entry of a course.
+ *
+ * @param courseId the ID of the course
+ * @return the entry, or end() if there is no such course
+ */
+CourseTable::const_iterator CourseTable::find(const std::string& courseId) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), courseId, idLess);
+    return it != entries.end() && it->first == courseId ? it : entries.end();
+}
+
+/**
+ * Finds a course.
+ *
+ * @param courseId the ID of the course
+ * @return the course, or nullptr if there is no such course
+ */
+Course* CourseTable::findCourse(const std::string& courseId) const {
+    auto it = find(courseId);
+    return it == entries.end() ? nullptr : it->second.get();
+}
+
+CourseTable::const_iterator CourseTable::begin() const {
+    return entries.begin();
+}
+
+CourseTable::const_iterator CourseTable::end() const {
+    return entries.end();
+}
+
+size_t CourseTable::size() const {
+    return entries.size();
+}
+
+bool CourseTable::empty() const {
+    return entries.empty();
+}
+
+CourseTable::Block::Block(size_t capacity) : slots(new Slot[capacity]), capacity(capacity), used(0) {}
+
+/**
+ * Destroys the courses built in the block.
+ */
+CourseTable::Block::~Block() {
+    for (size_t i = 0; i < used; ++i) {
+        reinterpret_cast<Course*>(&slots[i])->~Course();
+    }
+}
+
+bool CourseTable::Block::isFull() const {
+    return used == capacity;
+}
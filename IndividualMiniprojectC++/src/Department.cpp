@@ -2,11 +2,22 @@
 
 #include "Department.h"
 #include "Course.h"
+#include <algorithm>
 #include <map>
 #include <string>
-#include <sstream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
 
+namespace {
+
+// A course count read from an original-format file is only trusted this far when
+// setting aside room for the courses; any beyond it are allocated one at a time.
+const size_t kMaxReservedCourses = 1 << 16;
+
+}  // namespace
 
 /**
  * Constructs a new Department object with the given parameters.
@@ -18,9 +29,83 @@
  */
 Department::Department(std::string deptCode, std::map<std::string, std::shared_ptr<Course>> courses,
                        std::string departmentChair, int numberOfMajors)
-    : departmentChair(departmentChair), deptCode(deptCode), numberOfMajors(numberOfMajors), courses(courses) {}
+    : departmentChair(departmentChair), deptCode(deptCode), numberOfMajors(numberOfMajors), courses(courses),
+      coursesLoaded(true), snapshotIndex(0), checkpointEpoch(0), checkpointMajors(0),
+      changeStamp(std::make_shared<std::atomic<uint64_t>>(ChangeClock::now())),
+      version(std::make_shared<std::atomic<uint64_t>>(0)), totals(std::make_shared<DepartmentTotals>()), hasForeignCourses(false) {
+    for (const auto& it : this->courses) {
+        attachCourse(*it.second);
+    }
+}
+
+/**
+ * Constructs a department stored in a version 2 data file. Its courses stay in the
+ * file until they are first needed.
+ *
+ * @param snapshot The mapped data file, kept open while the department needs it.
+ * @param index    The index of the department in the file.
+ */
+Department::Department(std::shared_ptr<const SnapshotFile> snapshot, size_t index)
+    : numberOfMajors(snapshot->getNumberOfMajors(index)), deptCode(snapshot->getDeptCode(index)),
+      departmentChair(snapshot->getDepartmentChair(index)), coursesLoaded(false), snapshot(snapshot),
+      snapshotIndex(index), checkpointEpoch(0), checkpointMajors(0),
+      changeStamp(std::make_shared<std::atomic<uint64_t>>(0)), version(std::make_shared<std::atomic<uint64_t>>(0)),
+      totals(std::make_shared<DepartmentTotals>()), hasForeignCourses(false) {}
 
-Department::Department() : numberOfMajors(0) {}
+Department::Department()
+    : numberOfMajors(0), coursesLoaded(true), snapshotIndex(0), checkpointEpoch(0), checkpointMajors(0),
+      changeStamp(std::make_shared<std::atomic<uint64_t>>(0)), version(std::make_shared<std::atomic<uint64_t>>(0)),
+      totals(std::make_shared<DepartmentTotals>()), hasForeignCourses(false) {}
+
+/**
+ * Copies another department. The source is read under its lock; the new department
+ * shares the source's Course objects, which are read from the data file first if the
+ * source has not needed them yet. The copy shares the source's change stamp and
+ * version, so a change to a shared course marks both.
+ *
+ * @param other The department to copy.
+ */
+Department::Department(const Department& other)
+    : coursesLoaded(true), snapshotIndex(0), checkpointEpoch(0), checkpointMajors(0) {
+    other.loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(other.mutex);
+    numberOfMajors = other.numberOfMajors;
+    deptCode = other.deptCode;
+    departmentChair = other.departmentChair;
+    courses = other.courses;
+    changeStamp = other.changeStamp;
+    version = other.version;
+    totals = other.totals;
+    hasForeignCourses = other.hasForeignCourses;
+}
+
+/**
+ * Replaces this department's contents with a copy of another department.
+ *
+ * @param other The department to copy.
+ * @return This department.
+ */
+Department& Department::operator=(const Department& other) {
+    if (this == &other) {
+        return *this;
+    }
+    Department copy(other);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    numberOfMajors = copy.numberOfMajors;
+    deptCode = std::move(copy.deptCode);
+    departmentChair = std::move(copy.departmentChair);
+    courses = std::move(copy.courses);
+    changeStamp = std::move(copy.changeStamp);
+    version = std::move(copy.version);
+    totals = std::move(copy.totals);
+    hasForeignCourses = copy.hasForeignCourses;
+    coursesLoaded.store(true);
+    snapshot.reset();
+    // the cached text is tagged with a version of the old counter
+    rendered.clear();
+    markChanged();
+    return *this;
+}
 
 /**
  * Gets the number of majors in the department.
@@ -28,6 +113,7 @@ Department::Department() : numberOfMajors(0) {}
  * @return The number of majors.
  */
 int Department::getNumberOfMajors() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
     return numberOfMajors;
 }
 
@@ -37,32 +123,56 @@ int Department::getNumberOfMajors() const {
  * @return The name of the department chair.
  */
 std::string Department::getDepartmentChair() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
     return departmentChair; 
 }
 
 /**
- * Gets the courses offered by the department.
+ * Gets the courses offered by the department without copying them. The table is not
+ * locked for the caller, so it must not be iterated while courses are being added.
  *
- * @return A HashMap containing courses offered by the department.
+ * @return A reference to the table of courses offered by the department, by ID.
  */
-std::map<std::string, std::shared_ptr<Course>> Department::getCourseSelection() const {
+const CourseTable& Department::getCourseSelection() const {
+    loadCourses();
     return courses;
 }
 
+/**
+ * Looks up a single course offered by the department.
+ *
+ * @param courseId The ID of the course to find.
+ *
+ * @return A pointer to the course, or nullptr if the department does not offer it.
+ */
+Course* Department::findCourse(const std::string& courseId) const {
+    loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return courses.findCourse(courseId);
+}
+
 /**
  * Increases the number of majors in the department by one.
  */
 void Department::addPersonToMajor() {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     numberOfMajors++;
+    markChanged();
 }
 
 /**
  * Decreases the number of majors in the department by one if it's greater than zero.
+ *
+ * @return true if the number of majors was decreased, false if it was already zero.
  */
-void Department::dropPersonFromMajor() {
+bool Department::dropPersonFromMajor() {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     if (numberOfMajors > 0) {
         --numberOfMajors;
+        markChanged();
+        return true;
     }
+    return false;
 }
 
 /**
@@ -72,7 +182,11 @@ void Department::dropPersonFromMajor() {
  * @param course   The Course object to add.
  */
 void Department::addCourse(std::string courseId, std::shared_ptr<Course> course) {
-    courses[courseId] = course;
+    loadCourses();
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    attachCourse(*course);
+    courses.set(courseId, course);
+    markChanged();
 }
 
 /**
@@ -96,56 +210,267 @@ void Department::createCourse(std::string courseId, std::string instructorName,
  * @return A string representing the department.
  */
 std::string Department::display() const {
-    std::ostringstream result;
+    return *displayText();
+}
+
+/**
+ * Gets the text display() returns without copying it. The text rendered last is kept
+ * and handed back until the department or one of its courses changes; it is then
+ * rendered again from the text each course kept, so only changed courses are
+ * rendered anew.
+ *
+ * @return A string representing the department.
+ */
+std::shared_ptr<const std::string> Department::displayText() const {
+    loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    uint64_t current = currentVersion();
+    std::shared_ptr<const std::string> cached = rendered.get(current);
+    if (cached) {
+        return cached;
+    }
+    std::string result;
     for (const auto& it : courses) {
-        result << deptCode << " " << it.first << ": " << it.second->display() << "\n";
+        result.append(deptCode).append(" ").append(it.first).append(": ");
+        result.append(*it.second->displayText()).append("\n");
     }
-    return result.str(); 
+    return rendered.put(current, std::move(result));
 }
 
-void Department::serialize(std::ostream& out) const {
-    size_t deptCodeLen = deptCode.length();
-    out.write(reinterpret_cast<const char*>(&deptCodeLen), sizeof(deptCodeLen));
-    out.write(deptCode.c_str(), deptCodeLen);
-
-    size_t chairLen = departmentChair.length();
-    out.write(reinterpret_cast<const char*>(&chairLen), sizeof(chairLen));
-    out.write(departmentChair.c_str(), chairLen);
+/**
+ * Writes the department as a JSON object: its code, chair, number of majors and its
+ * courses in ID order, each with its ID and the fields Course::writeJsonFields() writes.
+ *
+ * @param out The writer to write the object with.
+ */
+void Department::writeJson(JsonWriter& out) const {
+    loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    out.beginObject()
+        .field("deptCode", deptCode)
+        .field("chair", departmentChair)
+        .field("majors", numberOfMajors)
+        .key("courses")
+        .beginArray();
+    for (const auto& it : courses) {
+        out.beginObject().field("courseCode", it.first);
+        it.second->writeJsonFields(out);
+        out.endObject();
+    }
+    out.endArray().endObject();
+}
 
-    out.write(reinterpret_cast<const char*>(&numberOfMajors), sizeof(numberOfMajors));
+void Department::serialize(std::ostream& out) const {
+    BufferedWriter writer(out);
+    serialize(writer);
+}
 
-    size_t mapSize = courses.size();
-    out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+/**
+ * Writes the department in the data file's original format: code, chair, number of
+ * majors, then each course ID followed by the course.
+ *
+ * @param out The writer to append to.
+ */
+void Department::serialize(BufferedWriter& out) const {
+    loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    out.writeString(deptCode);
+    out.writeString(departmentChair);
+    out.write(numberOfMajors);
+    out.write(courses.size());
     for (const auto& it : courses) {
-        size_t courseIdLen = it.first.length();
-        out.write(reinterpret_cast<const char*>(&courseIdLen), sizeof(courseIdLen));
-        out.write(it.first.c_str(), courseIdLen);
+        out.writeString(it.first);
         it.second->serialize(out);
     }
 }
 
 void Department::deserialize(std::istream& in) {
-    size_t deptCodeLen;
-    in.read(reinterpret_cast<char*>(&deptCodeLen), sizeof(deptCodeLen));
-    deptCode.resize(deptCodeLen);
-    in.read(&deptCode[0], deptCodeLen);
-
-    size_t chairLen;
-    in.read(reinterpret_cast<char*>(&chairLen), sizeof(chairLen));
-    departmentChair.resize(chairLen);
-    in.read(&departmentChair[0], chairLen);
-
-    in.read(reinterpret_cast<char*>(&numberOfMajors), sizeof(numberOfMajors));
-
-    size_t mapSize;
-    in.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
-    for (size_t i = 0; i < mapSize; ++i) {
-        size_t courseIdLen;
-        in.read(reinterpret_cast<char*>(&courseIdLen), sizeof(courseIdLen));
-        std::string courseId(courseIdLen, ' ');
-        in.read(&courseId[0], courseIdLen);
-        std::shared_ptr<Course> course = std::make_shared<Course>();
-        course->deserialize(in);
-        courses[courseId] = course;
+    BufferedReader reader(in);
+    deserialize(reader);
+}
+
+/**
+ * Reads a department written by serialize(). Courses are added to the ones the
+ * department already has, replacing any with the same ID.
+ *
+ * @param in The reader positioned at the department.
+ */
+void Department::deserialize(BufferedReader& in) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    in.readString(deptCode);
+    in.readString(departmentChair);
+    in.read(numberOfMajors);
+
+    snapshot.reset();
+    coursesLoaded.store(true);
+    size_t mapSize = 0;
+    in.read(mapSize);
+    courses.reserveContiguous(in.ok() ? std::min(mapSize, kMaxReservedCourses) : 0);
+    std::string courseId;
+    for (size_t i = 0; i < mapSize && in.ok(); ++i) {
+        in.readString(courseId);
+        Course& course = courses.emplace(courseId);
+        course.deserialize(in);
+        attachCourse(course);
+    }
+    markChanged();
+}
+
+/**
+ * Keeps the number of majors as it is now for the checkpoint with the given epoch,
+ * unless it was already kept. Called before every change to the major count made
+ * while that checkpoint runs.
+ *
+ * @param epoch The epoch of the running checkpoint.
+ */
+void Department::preserveForCheckpoint(uint64_t epoch) const {
+    if (checkpointEpoch.load(std::memory_order_acquire) >= epoch) {
+        return;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (checkpointEpoch.load(std::memory_order_relaxed) < epoch) {
+        checkpointMajors = numberOfMajors;
+        checkpointEpoch.store(epoch, std::memory_order_release);
+    }
+}
+
+/**
+ * Writes the department to a version 2 data file as it was when the checkpoint with
+ * the given epoch began. The course list is copied so the department is only locked
+ * briefly, and each course is written as it was through its own checkpoint copy.
+ * Courses that were never read from the mapped file are copied across without
+ * building Course objects for them.
+ *
+ * @param writer The file being written.
+ * @param key    The key of the department in the database.
+ * @param epoch  The epoch of the running checkpoint.
+ */
+void Department::writeCheckpoint(SnapshotWriter& writer, const std::string& key, uint64_t epoch) const {
+    preserveForCheckpoint(epoch);
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    writer.addDepartment(key, deptCode, departmentChair, checkpointMajors);
+    if (!coursesLoaded.load()) {
+        // unchanged since it was read, so the mapped file still holds its state
+        std::shared_ptr<const SnapshotFile> source = snapshot;
+        size_t index = snapshotIndex;
+        lock.unlock();
+        writer.copyCourses(*source, index);
+        return;
+    }
+    std::vector<CourseTable::value_type> courseList(courses.begin(), courses.end());
+    lock.unlock();
+    for (const auto& it : courseList) {
+        writer.addCourse(it.first, it.second->stateForCheckpoint(epoch));
+    }
+}
+
+/**
+ * Reads the department's courses from the data file it came from, once. Safe to call
+ * from several threads; departments can be loaded in parallel with each other.
+ */
+void Department::loadCourses() const {
+    if (coursesLoaded.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (coursesLoaded.load(std::memory_order_relaxed)) {
+        return;
+    }
+    size_t count = snapshot->getCourseCount(snapshotIndex);
+    courses.reserveContiguous(count);
+    for (size_t i = 0; i < count; ++i) {
+        attachCourse(courses.emplace(snapshot->getCourseId(snapshotIndex, i),
+                                     snapshot->getCourseState(snapshotIndex, i)));
+    }
+    coursesLoaded.store(true, std::memory_order_release);
+}
+
+/**
+ * Checks whether the department's courses are in memory.
+ */
+bool Department::isLoaded() const {
+    return coursesLoaded.load(std::memory_order_acquire);
+}
+
+/**
+ * Gets the ChangeClock tick of the latest change to the department or to any of its
+ * courses, or 0 if nothing changed since it was read from a data file. Courses report
+ * their changes to the department's stamp; only courses that were first added to an
+ * unrelated department, and so report there, have to be looked at one by one.
+ */
+uint64_t Department::getChangedAt() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    uint64_t latest = changeStamp->load(std::memory_order_acquire);
+    if (hasForeignCourses) {
+        for (const auto& it : courses) {
+            latest = std::max(latest, it.second->getChangedAt());
+        }
+    }
+    return latest;
+}
+
+/**
+ * Gets a number that moves on with every change to the department or to any of its
+ * courses. Courses report their changes to the department's version; the versions of
+ * courses that report to an unrelated department are added on.
+ */
+uint64_t Department::getVersion() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return currentVersion();
+}
+
+/**
+ * Gets the number of courses the department offers, their seats, their enrolled
+ * students and how many of them are full. Courses still in the data file are read
+ * first. The running totals answer without looking at any course as long as they
+ * count exactly the courses in the table; otherwise the courses are added up.
+ *
+ * @return The totals over the department's courses.
+ */
+DepartmentTotals::Values Department::getCourseTotals() const {
+    loadCourses();
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    DepartmentTotals::Values values = totals->get();
+    if (!hasForeignCourses && values.courseCount == courses.size()) {
+        return values;
+    }
+    values = DepartmentTotals::Values{courses.size(), 0, 0, 0};
+    for (const auto& it : courses) {
+        values.seats += it.second->getEnrollmentCapacity();
+        values.enrolled += it.second->getEnrolledStudentCount();
+        values.fullCourses += it.second->isCourseFull() ? 1 : 0;
+    }
+    return values;
+}
+
+/**
+ * Stamps the department as changed. The caller holds the department's lock.
+ */
+void Department::markChanged() {
+    ChangeClock::raise(*changeStamp, ChangeClock::now());
+    version->fetch_add(1, std::memory_order_acq_rel);
+}
+
+/**
+ * Has a course report its changes to this department. The caller holds the
+ * department's lock or has not shared the department yet.
+ */
+void Department::attachCourse(Course& course) const {
+    if (!course.attachToDepartment(changeStamp, version, totals)) {
+        hasForeignCourses = true;
+    }
+}
+
+/**
+ * Gets the department's version. Every count involved only grows, so neither does the
+ * sum. The caller holds the department's lock.
+ */
+uint64_t Department::currentVersion() const {
+    uint64_t current = version->load(std::memory_order_acquire);
+    if (hasForeignCourses) {
+        for (const auto& it : courses) {
+            current += it.second->getVersion();
+        }
     }
+    return current;
 }
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "FullCourseBitmap.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+FullCourseBitmap::FullCourseBitmap() : wordCapacity(0) {}
+
+/**
+ * Adds every course of a department, after the courses already added. A department
+ * is added once.
+ *
+ * @param deptCode the key of the department
+ * @param table    the department's courses
+ */
+void FullCourseBitmap::addDepartment(const std::string& deptCode, const CourseTable& table) {
+    size_t first = courses.size();
+    size_t needed = (first + table.size() + 63) / 64;
+    if (needed > wordCapacity) {
+        size_t capacity = std::max(needed, wordCapacity * 2);
+        std::unique_ptr<std::atomic<uint64_t>[]> grown(new std::atomic<uint64_t>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            grown[i].store(i < wordCapacity ? words[i].load(std::memory_order_relaxed) : 0,
+                           std::memory_order_relaxed);
+        }
+        words = std::move(grown);
+        wordCapacity = capacity;
+    }
+
+    const std::string* pooledDeptCode = StringPool::intern(deptCode);
+    for (const auto& it : table) {
+        size_t row = courses.size();
+        rows.emplace(it.second.get(), row);
+        courses.push_back(it.second.get());
+        deptCodes.push_back(pooledDeptCode);
+        courseIds.push_back(StringPool::intern(it.first));
+        set(row, it.second->isCourseFull());
+    }
+    deptRows[deptCode] = std::make_pair(first, courses.size());
+}
+
+/**
+ * Sets a course's bit to whether it is full now. A course that was never added is
+ * ignored.
+ *
+ * @param course the course whose enrolled count changed
+ */
+void FullCourseBitmap::refresh(const Course* course) {
+    auto it = rows.find(course);
+    if (it == rows.end()) {
+        return;
+    }
+    bool full = course->isCourseFull();
+    while (true) {
+        set(it->second, full);
+        bool now = course->isCourseFull();
+        if (now == full) {
+            return;
+        }
+        full = now;
+    }
+}
+
+/**
+ * Lists every full course.
+ *
+ * @return the full courses, in department and course ID order
+ */
+std::vector<CourseRef> FullCourseBitmap::findFull() const {
+    return collect(0, courses.size());
+}
+
+/**
+ * Lists the full courses of one department.
+ *
+ * @param deptCode the key of the department
+ * @return the department's full courses, in course ID order; none if it was not added
+ */
+std::vector<CourseRef> FullCourseBitmap::findFull(const std::string& deptCode) const {
+    auto it = deptRows.find(deptCode);
+    if (it == deptRows.end()) {
+        return {};
+    }
+    return collect(it->second.first, it->second.second);
+}
+
+/**
+ * Counts the full courses.
+ */
+size_t FullCourseBitmap::countFull() const {
+    size_t count = 0;
+    for (size_t i = 0; i < (courses.size() + 63) / 64; ++i) {
+        count += __builtin_popcountll(words[i].load(std::memory_order_relaxed));
+    }
+    return count;
+}
+
+/**
+ * Gets the number of courses in the bitmap.
+ */
+size_t FullCourseBitmap::size() const {
+    return courses.size();
+}
+
+void FullCourseBitmap::set(size_t row, bool full) {
+    uint64_t bit = uint64_t(1) << (row % 64);
+    if (full) {
+        words[row / 64].fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        words[row / 64].fetch_and(~bit, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * Lists the courses whose bits are set among rows [begin, end).
+ */
+std::vector<CourseRef> FullCourseBitmap::collect(size_t begin, size_t end) const {
+    std::vector<CourseRef> result;
+    for (size_t word = begin / 64; word * 64 < end; ++word) {
+        uint64_t bits = words[word].load(std::memory_order_acquire);
+        if (word == begin / 64) {
+            bits &= ~uint64_t(0) << (begin % 64);
+        }
+        if ((word + 1) * 64 > end) {
+            bits &= ~(~uint64_t(0) << (end % 64));
+        }
+        while (bits != 0) {
+            size_t row = word * 64 + __builtin_ctzll(bits);
+            result.push_back(CourseRef{*deptCodes[row], *courseIds[row], courses[row]});
+            bits &= bits - 1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "JsonWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/**
+ * Starts writing at the end of the given string.
+ *
+ * @param out the string to append to
+ */
+JsonWriter::JsonWriter(std::string& out) : out(out), nonEmpty(0), depth(0), afterKey(false) {}
+
+JsonWriter& JsonWriter::beginObject() {
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    close(']');
+    return *this;
+}
+
+/**
+ * Writes the name of the next member of the current object.
+ *
+ * @param name the member name, escaped as it is written
+ */
+JsonWriter& JsonWriter::key(const char* name) {
+    separate();
+    writeString(name, std::strlen(name));
+    out += ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const std::string& name) {
+    separate();
+    writeString(name.data(), name.size());
+    out += ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* text) {
+    separate();
+    writeString(text, std::strlen(text));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::string& text) {
+    separate();
+    writeString(text.data(), text.size());
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out += flag ? "true" : "false";
+    return *this;
+}
+
+/**
+ * Writes a number with up to six significant digits, or null if it is not finite,
+ * since JSON has no way to write infinities or NaN.
+ */
+JsonWriter& JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separate();
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.6g", number);
+    out.append(digits, static_cast<size_t>(length));
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::writeSigned(long long number) {
+    if (number >= 0) {
+        return writeUnsigned(static_cast<unsigned long long>(number));
+    }
+    separate();
+    out += '-';
+    appendDigits(0 - static_cast<unsigned long long>(number));
+    return *this;
+}
+
+JsonWriter& JsonWriter::writeUnsigned(unsigned long long number) {
+    separate();
+    appendDigits(number);
+    return *this;
+}
+
+/**
+ * Appends the decimal digits of a number, formatted from the end of a stack buffer.
+ */
+void JsonWriter::appendDigits(unsigned long long number) {
+    char digits[20];
+    char* first = digits + sizeof(digits);
+    do {
+        *--first = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    out.append(first, static_cast<size_t>(digits + sizeof(digits) - first));
+}
+
+/**
+ * Puts a comma before every value of an object or array but the first; a value that
+ * follows its key gets none.
+ */
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth == 0) {
+        return;
+    }
+    uint64_t bit = uint64_t(1) << (depth - 1);
+    if (nonEmpty & bit) {
+        out += ',';
+    }
+    nonEmpty |= bit;
+}
+
+void JsonWriter::open(char bracket) {
+    separate();
+    out += bracket;
+    ++depth;
+    nonEmpty &= ~(uint64_t(1) << (depth - 1));
+}
+
+void JsonWriter::close(char bracket) {
+    --depth;
+    out += bracket;
+}
+
+/**
+ * Writes a quoted string, escaping quotes, backslashes and control characters. Runs of
+ * characters that need no escaping are copied in one append.
+ */
+void JsonWriter::writeString(const char* text, size_t length) {
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    size_t run = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(text + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xf];
+        }
+    }
+    out.append(text + run, length - run);
+    out += '"';
+}
@@ -0,0 +1,569 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "MutationLog.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const char kLogHeader[] = "CRSWAL01";
+const size_t kLogHeaderSize = sizeof(kLogHeader) - 1;
+
+// Each record is [u32 body length][u32 crc32 of body][body]. The body is
+// [u64 lsn][u8 type][u16 len][deptCode][u16 len][courseId][i32 value][u16 len][text].
+// A batch is one record whose body is [u64 lsn][u8 kBatchType][u32 count] followed by
+// count bodies without their LSN, so the checksum covers the whole batch.
+const size_t kRecordPrefixSize = 8;
+const uint8_t kBatchType = 0xFF;
+
+using RecordVisitor = std::function<void(uint64_t lsn, const std::vector<MutationRecord>& records,
+                                         const char* frame, size_t frameLength)>;
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+uint32_t crc32(const char* data, size_t length) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& value) {
+    if (value.size() > UINT16_MAX) {
+        throw std::length_error("mutation field too long for the log: " + value.substr(0, 32));
+    }
+    put<uint16_t>(out, static_cast<uint16_t>(value.size()));
+    out.append(value);
+}
+
+template <typename T>
+bool get(const char*& cursor, const char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return true;
+}
+
+bool getString(const char*& cursor, const char* end, std::string& value) {
+    uint16_t length;
+    if (!get(cursor, end, length) || static_cast<size_t>(end - cursor) < length) {
+        return false;
+    }
+    value.assign(cursor, length);
+    cursor += length;
+    return true;
+}
+
+void encodeFields(std::string& body, const MutationRecord& record) {
+    put<uint8_t>(body, static_cast<uint8_t>(record.type));
+    putString(body, record.deptCode);
+    putString(body, record.courseId);
+    put<int32_t>(body, record.value);
+    putString(body, record.text);
+}
+
+void encodeFrame(std::string& out, const std::string& body) {
+    put<uint32_t>(out, static_cast<uint32_t>(body.size()));
+    put<uint32_t>(out, crc32(body.data(), body.size()));
+    out.append(body);
+}
+
+void encodeRecord(std::string& out, uint64_t lsn, const MutationRecord& record) {
+    std::string body;
+    put<uint64_t>(body, lsn);
+    encodeFields(body, record);
+    encodeFrame(out, body);
+}
+
+void encodeBatch(std::string& out, uint64_t lsn, const std::vector<MutationRecord>& records) {
+    std::string body;
+    put<uint64_t>(body, lsn);
+    put<uint8_t>(body, kBatchType);
+    put<uint32_t>(body, static_cast<uint32_t>(records.size()));
+    for (const MutationRecord& record : records) {
+        encodeFields(body, record);
+    }
+    encodeFrame(out, body);
+}
+
+bool decodeFields(const char*& cursor, const char* end, MutationRecord& record) {
+    uint8_t type;
+    if (!get(cursor, end, type) || !getString(cursor, end, record.deptCode) ||
+        !getString(cursor, end, record.courseId) || !get(cursor, end, record.value) ||
+        !getString(cursor, end, record.text)) {
+        return false;
+    }
+    record.type = static_cast<MutationType>(type);
+    return true;
+}
+
+/**
+ * Decodes a record body into the one change it holds, or every change of a batch.
+ */
+bool decodeRecords(const char* body, size_t length, uint64_t& lsn, std::vector<MutationRecord>& records) {
+    const char* cursor = body;
+    const char* end = body + length;
+    records.clear();
+    if (!get(cursor, end, lsn) || cursor == end) {
+        return false;
+    }
+    uint32_t count = 1;
+    if (static_cast<uint8_t>(*cursor) == kBatchType) {
+        ++cursor;
+        if (!get(cursor, end, count)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        MutationRecord record;
+        if (!decodeFields(cursor, end, record)) {
+            return false;
+        }
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+/**
+ * Walks the records of a log image, stopping at the first torn or corrupt record. A
+ * batch is visited once, with all of its changes.
+ *
+ * @return the number of bytes, header included, that hold complete valid records
+ */
+size_t scanRecords(const std::string& data, const RecordVisitor& visit) {
+    if (data.size() < kLogHeaderSize || data.compare(0, kLogHeaderSize, kLogHeader) != 0) {
+        return 0;
+    }
+    size_t offset = kLogHeaderSize;
+    std::vector<MutationRecord> records;
+    while (data.size() - offset >= kRecordPrefixSize) {
+        uint32_t length;
+        uint32_t checksum;
+        std::memcpy(&length, data.data() + offset, sizeof(length));
+        std::memcpy(&checksum, data.data() + offset + 4, sizeof(checksum));
+        const char* body = data.data() + offset + kRecordPrefixSize;
+        if (data.size() - offset - kRecordPrefixSize < length || crc32(body, length) != checksum) {
+            break;
+        }
+        uint64_t lsn;
+        if (!decodeRecords(body, length, lsn, records)) {
+            break;
+        }
+        visit(lsn, records, data.data() + offset, kRecordPrefixSize + length);
+        offset += kRecordPrefixSize + length;
+    }
+    return offset;
+}
+
+std::string readWholeFile(const std::string& filePath) {
+    std::ifstream inFile(filePath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Makes a rename in the directory holding the given file durable.
+ */
+void syncDirectoryOf(const std::string& filePath) {
+    size_t slash = filePath.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : filePath.substr(0, slash + 1);
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+}  // namespace
+
+MutationRecord MutationRecord::forDepartment(MutationType type, const std::string& deptCode) {
+    return MutationRecord{type, deptCode, "", 0, ""};
+}
+
+MutationRecord MutationRecord::forCourse(MutationType type, const std::string& deptCode, const std::string& courseId,
+                                         int32_t value, const std::string& text) {
+    return MutationRecord{type, deptCode, courseId, value, text};
+}
+
+/**
+ * Opens the log for appending, creating it if needed. A torn record left at the end
+ * by a crash is cut off so new records follow the last complete one.
+ *
+ * @param filePath  path of the log file
+ * @param options   how appended records are made durable
+ * @param lastLsn   the highest LSN already used, by the log or by the snapshot it
+ *                  extends; new records are numbered after it
+ */
+MutationLog::MutationLog(const std::string& filePath, const Options& options, uint64_t lastLsn)
+    : filePath(filePath), options(options), fd(-1), lastLsn(lastLsn), durableLsn(lastLsn), syncCount(0),
+      flushing(false), stopping(false) {
+    std::string existing = readWholeFile(filePath);
+    size_t validLength = scanRecords(existing, [](uint64_t, const std::vector<MutationRecord>&, const char*, size_t) {});
+
+    fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open mutation log " + filePath);
+    }
+    if (validLength == 0) {
+        if (::ftruncate(fd, 0) != 0) {
+            throw std::runtime_error("cannot reset mutation log " + filePath);
+        }
+        writeAndSync(std::string(kLogHeader, kLogHeaderSize));
+    } else if (validLength < existing.size() && ::ftruncate(fd, validLength) != 0) {
+        throw std::runtime_error("cannot trim mutation log " + filePath);
+    }
+
+    if (options.policy == SyncPolicy::Interval) {
+        flusher = std::thread(&MutationLog::flushLoop, this);
+    }
+}
+
+/**
+ * Makes every appended record durable and closes the log.
+ */
+MutationLog::~MutationLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    durableChanged.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // nothing more can be done for records that cannot be written at shutdown
+    }
+    ::close(fd);
+}
+
+/**
+ * Assigns the record the next LSN and adds it to the log. Under the EveryWrite policy
+ * the record is durable on return; otherwise call waitDurable() with the returned LSN.
+ *
+ * @param record the change to log
+ * @return the LSN of the record
+ */
+uint64_t MutationLog::append(const MutationRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t lsn = ++lastLsn;
+    encodeRecord(pending, lsn, record);
+    if (options.policy == SyncPolicy::EveryWrite) {
+        writeAndSync(pending);
+        pending.clear();
+        durableLsn = lsn;
+        ++syncCount;
+    }
+    return lsn;
+}
+
+/**
+ * Assigns a batch of changes one LSN and adds them to the log as a single record, so
+ * replay applies either all of them or, if the record was torn by a crash, none.
+ * Durability is as for append().
+ *
+ * @param records the changes to log, in the order they were applied
+ * @return the LSN of the batch
+ */
+uint64_t MutationLog::appendBatch(const std::vector<MutationRecord>& records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t lsn = ++lastLsn;
+    encodeBatch(pending, lsn, records);
+    if (options.policy == SyncPolicy::EveryWrite) {
+        writeAndSync(pending);
+        pending.clear();
+        durableLsn = lsn;
+        ++syncCount;
+    }
+    return lsn;
+}
+
+/**
+ * Blocks until the record with the given LSN is on disk. Under EveryBatch the first
+ * caller to find no sync in progress writes the whole pending batch, so concurrent
+ * callers share one fsync. Under Interval this returns immediately.
+ *
+ * @param lsn the LSN returned by append()
+ */
+void MutationLog::waitDurable(uint64_t lsn) {
+    if (options.policy == SyncPolicy::Interval) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    while (durableLsn < lsn) {
+        if (flushing) {
+            durableChanged.wait(lock);
+            continue;
+        }
+        flushing = true;
+        std::string batch;
+        batch.swap(pending);
+        uint64_t batchLsn = lastLsn;
+        lock.unlock();
+        try {
+            writeAndSync(batch);
+        } catch (...) {
+            // keep the records for the next attempt, ahead of any appended since
+            lock.lock();
+            pending.insert(0, batch);
+            flushing = false;
+            durableChanged.notify_all();
+            throw;
+        }
+        lock.lock();
+        flushing = false;
+        durableLsn = batchLsn;
+        ++syncCount;
+        durableChanged.notify_all();
+    }
+}
+
+/**
+ * Makes every record appended so far durable, whatever the policy.
+ */
+void MutationLog::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (flushing) {
+        durableChanged.wait(lock);
+    }
+    if (durableLsn < lastLsn) {
+        writeAndSync(pending);
+        pending.clear();
+        durableLsn = lastLsn;
+        ++syncCount;
+        durableChanged.notify_all();
+    }
+}
+
+/**
+ * Drops the records a snapshot already contains. If the snapshot covers the whole log
+ * the log is simply emptied. Otherwise the newer records are copied to a new file that
+ * then replaces the log; appends only wait while the records written during the copy
+ * are moved across, not for the copy itself.
+ *
+ * @param snapshotLsn the LSN of the last change included in the snapshot
+ * @return true if any records were dropped
+ */
+bool MutationLog::discardThrough(uint64_t snapshotLsn) {
+    off_t copiedLength;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (flushing) {
+            durableChanged.wait(lock);
+        }
+        if (lastLsn <= snapshotLsn) {
+            if (::ftruncate(fd, kLogHeaderSize) != 0 || ::fsync(fd) != 0) {
+                throw std::runtime_error("cannot truncate mutation log " + filePath);
+            }
+            pending.clear();
+            durableLsn = lastLsn;
+            return true;
+        }
+        copiedLength = ::lseek(fd, 0, SEEK_END);
+    }
+
+    std::string existing = readWholeFile(filePath);
+    existing.resize(std::min(existing.size(), static_cast<size_t>(copiedLength)));
+    std::string kept(kLogHeader, kLogHeaderSize);
+    bool discarded = false;
+    scanRecords(existing, [&](uint64_t lsn, const std::vector<MutationRecord>&, const char* frame,
+                              size_t frameLength) {
+        if (lsn > snapshotLsn) {
+            kept.append(frame, frameLength);
+        } else {
+            discarded = true;
+        }
+    });
+    if (!discarded) {
+        return false;
+    }
+
+    std::string tempPath = filePath + ".tmp";
+    int tempFd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (tempFd < 0) {
+        throw std::runtime_error("cannot create " + tempPath);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    while (flushing) {
+        durableChanged.wait(lock);
+    }
+    std::ifstream inFile(filePath, std::ios::binary);
+    inFile.seekg(copiedLength);
+    kept.append(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    int logFd = fd;
+    fd = tempFd;
+    try {
+        writeAndSync(kept);
+    } catch (...) {
+        fd = logFd;
+        ::close(tempFd);
+        ::unlink(tempPath.c_str());
+        throw;
+    }
+    if (::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        fd = logFd;
+        ::close(tempFd);
+        ::unlink(tempPath.c_str());
+        throw std::runtime_error("cannot replace mutation log " + filePath);
+    }
+    syncDirectoryOf(filePath);
+    ::close(logFd);
+    return true;
+}
+
+uint64_t MutationLog::getLastLsn() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastLsn;
+}
+
+/**
+ * Gets the number of fsync calls issued for records, for measuring group commit.
+ */
+uint64_t MutationLog::getSyncCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncCount;
+}
+
+/**
+ * Parses a sync policy given on the command line: "write", "batch", or an interval
+ * such as "5ms".
+ *
+ * @param policy the policy name
+ * @return the matching options
+ */
+MutationLog::Options MutationLog::parseOptions(const std::string& policy) {
+    Options options;
+    if (policy == "write") {
+        options.policy = SyncPolicy::EveryWrite;
+    } else if (policy == "batch") {
+        options.policy = SyncPolicy::EveryBatch;
+    } else if (policy.size() > 2 && policy.compare(policy.size() - 2, 2, "ms") == 0) {
+        options.policy = SyncPolicy::Interval;
+        options.intervalMs = std::stoi(policy.substr(0, policy.size() - 2));
+        if (options.intervalMs <= 0) {
+            throw std::invalid_argument("sync interval must be positive: " + policy);
+        }
+    } else {
+        throw std::invalid_argument("unknown sync policy: " + policy);
+    }
+    return options;
+}
+
+/**
+ * Applies every complete record in a log whose LSN is greater than afterLsn, in log
+ * order; the changes of a batch are applied one by one, in order. A missing log is
+ * treated as empty.
+ *
+ * @param filePath  path of the log file
+ * @param afterLsn  the LSN already reflected in the loaded snapshot
+ * @param apply     called for each record to replay
+ * @return the highest LSN seen in the log or afterLsn, whichever is greater
+ */
+uint64_t MutationLog::replay(const std::string& filePath, uint64_t afterLsn,
+                             const std::function<void(const MutationRecord&)>& apply) {
+    uint64_t highestLsn = afterLsn;
+    scanRecords(readWholeFile(filePath), [&](uint64_t lsn, const std::vector<MutationRecord>& records, const char*,
+                                             size_t) {
+        if (lsn > afterLsn) {
+            for (const MutationRecord& record : records) {
+                apply(record);
+            }
+        }
+        highestLsn = std::max(highestLsn, lsn);
+    });
+    return highestLsn;
+}
+
+/**
+ * Writes records to the end of the log and syncs them. If the write or the sync fails,
+ * the file is cut back to where the records began, so a partly written record does not
+ * stop replay of the records written after it once the caller tries again.
+ */
+void MutationLog::writeAndSync(const std::string& batch) {
+    off_t start = ::lseek(fd, 0, SEEK_END);
+    size_t written = 0;
+    bool synced = false;
+    while (written < batch.size()) {
+        ssize_t n = ::write(fd, batch.data() + written, batch.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (written == batch.size()) {
+        int result;
+        do {
+            result = ::fsync(fd);
+        } while (result != 0 && errno == EINTR);
+        synced = result == 0;
+    }
+    if (!synced) {
+        if (start >= 0) {
+            (void)::ftruncate(fd, start);
+        }
+        throw std::runtime_error("cannot write mutation log " + filePath);
+    }
+}
+
+void MutationLog::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        durableChanged.wait_for(lock, std::chrono::milliseconds(options.intervalMs), [this]() { return stopping; });
+        if (stopping || flushing || durableLsn == lastLsn) {
+            continue;
+        }
+        flushing = true;
+        std::string batch;
+        batch.swap(pending);
+        uint64_t batchLsn = lastLsn;
+        lock.unlock();
+        try {
+            writeAndSync(batch);
+        } catch (const std::exception&) {
+            // keep the records for the next attempt
+            lock.lock();
+            pending.insert(0, batch);
+            flushing = false;
+            durableChanged.notify_all();
+            continue;
+        }
+        lock.lock();
+        flushing = false;
+        durableLsn = batchLsn;
+        ++syncCount;
+        durableChanged.notify_all();
+    }
+}
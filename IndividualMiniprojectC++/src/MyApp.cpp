@@ -1,19 +1,38 @@
 // Copyright (c) 2024 Annie Xu @ Columbia University
 
 #include "MyApp.h"
+#include <cstdio>
 #include <iostream>
 
 MyFileDatabase* MyApp::myFileDatabase = nullptr;
 bool MyApp::saveData = false;
 
-void MyApp::run(const std::string& mode) {
+namespace {
+
+const char kSnapshotFile[] = "testfile.bin";
+const char kMutationLogFile[] = "testfile.wal";
+
+}  // namespace
+
+/**
+ * Loads the database, or recreates it from the built-in data in "setup" mode, starts
+ * logging mutations and starts checkpointing the data file in the background.
+ *
+ * @param mode        "setup" to reset the data file, anything else to load it
+ * @param syncPolicy  when logged mutations are fsynced: "write", "batch" or an
+ *                    interval such as "5ms" (see MutationLog::parseOptions)
+ */
+void MyApp::run(const std::string& mode, const std::string& syncPolicy) {
     saveData = true;
+    MutationLog::Options logOptions = MutationLog::parseOptions(syncPolicy);
     if (mode == "setup") {
-        setupDatabase();
+        setupDatabase(logOptions);
         std::cout << "System Setup" << std::endl;
         return;
     }
-    myFileDatabase = new MyFileDatabase(0, "testfile.bin");
+    myFileDatabase = new MyFileDatabase(0, kSnapshotFile);
+    myFileDatabase->enableMutationLog(kMutationLogFile, logOptions);
+    myFileDatabase->startCheckpointer(MyFileDatabase::CheckpointOptions());
     std::cout << "Start up" << std::endl;
 }
 
@@ -36,9 +55,17 @@ MyFileDatabase *MyApp::getDatabase() {
     return myFileDatabase;
 }
 
-void MyApp::setupDatabase() {
-    myFileDatabase = new MyFileDatabase(1, "testfile.bin");
+/**
+ * Replaces the data file with the built-in data. The fresh snapshot is written before
+ * logging starts so that the old log can never be replayed on top of it.
+ */
+void MyApp::setupDatabase(const MutationLog::Options& logOptions) {
+    myFileDatabase = new MyFileDatabase(1, kSnapshotFile);
     resetDataFile();
+    std::remove(kMutationLogFile);
+    myFileDatabase->saveContentsToFile();
+    myFileDatabase->enableMutationLog(kMutationLogFile, logOptions);
+    myFileDatabase->startCheckpointer(MyFileDatabase::CheckpointOptions());
 }
 
 void MyApp::resetDataFile() {
@@ -1,87 +1,1287 @@
 // Copyright (c) 2024 Annie Xu @ Columbia University
 
 #include "MyFileDatabase.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Trailer after the departments of a file in the original format: [u64 snapshot lsn]
+// [u64 magic]. Readers of that format stop after the last department and never see it.
+const uint64_t kSnapshotFooterMagic = 0x3152544F4F464244ull;  // "DBFOOTR1"
+
+// Files in the original format are read 1 MiB at a time.
+const size_t kLoadChunkSize = 1 << 20;
+
+// Checkpoint epochs are unique across every database in the process, since databases
+// built from the same mapping share their Course objects.
+std::atomic<uint64_t> lastCheckpointEpoch(0);
+
+bool syncFile(const std::string& filePath) {
+    int fd = ::open(filePath.c_str(), O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+/**
+ * Makes a rename in the directory holding the given file durable.
+ */
+void syncDirectoryOf(const std::string& filePath) {
+    size_t slash = filePath.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : filePath.substr(0, slash + 1);
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+/**
+ * Reads the manifest at a data path, or returns an empty one if there is none or it
+ * cannot be read.
+ */
+SnapshotManifest manifestOnDisk(const std::string& filePath) {
+    SnapshotManifest manifest;
+    try {
+        if (SnapshotManifest::read(filePath, manifest)) {
+            return manifest;
+        }
+    } catch (const std::runtime_error&) {
+    }
+    return SnapshotManifest();
+}
+
+/**
+ * Runs the same work on the given number of threads, counting the caller, and waits
+ * for all of them.
+ */
+void runInParallel(unsigned threads, const std::function<void()>& work) {
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace
 
 /**
  * Constructs a MyFileDatabase object and loads up the data structure with
  * the contents of the file.
  *
- * @param flag     used to distinguish mode of database
- * @param filePath the path to the file containing the entries of the database
+ * @param flag       used to distinguish mode of database
+ * @param filePath   the path to the file containing the entries of the database
+ * @param shardCount the number of shards to split the departments across
  */
-MyFileDatabase::MyFileDatabase(int flag, const std::string& filePath) : filePath(filePath) {
+MyFileDatabase::MyFileDatabase(int flag, const std::string& filePath, size_t shardCount)
+    : viewsComplete(false), mappingGeneration(0), catalogVersion(0), filePath(filePath), snapshotLsn(0), checkpointCutPending(false), mutationsInFlight(0),
+      activeCheckpointEpoch(0), checkpointCount(0), mutationsSinceCheckpoint(0), mappingReplaced(true), lastSavedTick(0),
+      lastSaveBytes(0), checkpointerStopping(false) {
+    for (size_t i = 0; i < std::max<size_t>(1, shardCount); ++i) {
+        shards.emplace_back(new Shard());
+    }
     if (flag == 0) {
         deSerializeObjectFromFile();
     }
 }
 
+/**
+ * Stops the background checkpointer, if any. Unsaved changes stay in the mutation log.
+ */
+MyFileDatabase::~MyFileDatabase() {
+    stopCheckpointer();
+}
+
 /**
  * Sets the department mapping of the database.
  *
  * @param mapping the mapping of department names to Department objects
  */
 void MyFileDatabase::setMapping(const std::map<std::string, Department>& mapping) {
-    departmentMapping = mapping;
+    auto locks = lockAllExclusive();
+    for (const auto& shard : shards) {
+        shard->departments.clear();
+    }
+    for (const auto& it : mapping) {
+        shardFor(it.first).departments.emplace(it.first, it.second);
+    }
+    courseIndex = buildCourseIndex();
+    buildCourseViews();
+    ++mappingGeneration;
+    ++catalogVersion;
+    mappingReplaced.store(true);
 }
 
 /**
- * Gets the department mapping of the database.
+ * Gets a copy of the department mapping, gathered from every shard. The copied
+ * departments share their Course objects with the database, and departments whose
+ * courses were still in the mapped data file are loaded to be copied.
  *
  * @return the department mapping
  */
 std::map<std::string, Department> MyFileDatabase::getDepartmentMapping() const {
-    return departmentMapping;
+    auto locks = lockAllShared();
+    std::map<std::string, Department> mapping;
+    for (const auto& shard : shards) {
+        mapping.insert(shard->departments.begin(), shard->departments.end());
+    }
+    return mapping;
+}
+
+/**
+ * Gets the number of departments across every shard.
+ */
+size_t MyFileDatabase::getDepartmentCount() const {
+    auto locks = lockAllShared();
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        count += shard->departments.size();
+    }
+    return count;
+}
+
+/**
+ * Looks up a single department.
+ *
+ * @param deptCode the code of the department to find
+ * @return a pointer to the department, or nullptr if it does not exist
+ */
+const Department* MyFileDatabase::findDepartment(const std::string& deptCode) const {
+    Shard& shard = shardFor(deptCode);
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto it = shard.departments.find(deptCode);
+    if (it == shard.departments.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+/**
+ * Looks up a single department for modification.
+ *
+ * @param deptCode the code of the department to find
+ * @return a pointer to the department, or nullptr if it does not exist
+ */
+Department* MyFileDatabase::findDepartment(const std::string& deptCode) {
+    Shard& shard = shardFor(deptCode);
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto it = shard.departments.find(deptCode);
+    if (it == shard.departments.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+/**
+ * Looks up a single course without copying any department or course data. The course
+ * index is probed first; a course it does not hold is looked up in its department.
+ *
+ * @param deptCode the code of the department offering the course
+ * @param courseId the ID of the course within that department
+ * @return a pointer to the course, or nullptr if either does not exist
+ */
+Course* MyFileDatabase::findCourse(const std::string& deptCode, const std::string& courseId) const {
+    uint64_t key;
+    if (CourseIndex::packKey(deptCode, courseId, key)) {
+        if (Course* course = findIndexedCourse(deptCode, key)) {
+            return course;
+        }
+    }
+    const Department* dept = findDepartment(deptCode);
+    if (dept == nullptr) {
+        return nullptr;
+    }
+    return dept->findCourse(courseId);
+}
+
+/**
+ * Looks up a single course by its number, as parsed from a request, without turning
+ * the number back into a course ID unless the course index does not hold it.
+ *
+ * @param deptCode     the code of the department offering the course
+ * @param courseNumber the number of the course within that department
+ * @return a pointer to the course, or nullptr if either does not exist
+ */
+Course* MyFileDatabase::findCourse(const std::string& deptCode, int courseNumber) const {
+    uint64_t key;
+    if (CourseIndex::packKey(deptCode, courseNumber, key)) {
+        if (Course* course = findIndexedCourse(deptCode, key)) {
+            return course;
+        }
+    }
+    const Department* dept = findDepartment(deptCode);
+    if (dept == nullptr) {
+        return nullptr;
+    }
+    return dept->findCourse(std::to_string(courseNumber));
 }
 
 /**
- * Saves the contents of the internal data structure to the file. Contents of the file are
- * overwritten with this operation.
+ * Looks up a batch of courses in one pass. The lookups are grouped by shard and each
+ * shard's lock is taken once for all of its lookups; a course is found through the
+ * course index, or through its department if the index does not hold it.
+ *
+ * @param lookups the courses to find; the department and course of each are filled
+ *                in, or left nullptr if they do not exist
  */
-void MyFileDatabase::saveContentsToFile() const {
-    std::ofstream outFile(filePath, std::ios::binary);
-    size_t mapSize = departmentMapping.size();
-    outFile.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
-    for (const auto& it : departmentMapping) {
-        size_t keyLen = it.first.length();
-        outFile.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-        outFile.write(it.first.c_str(), keyLen);
-        it.second.serialize(outFile);
+void MyFileDatabase::findCourses(std::vector<CourseLookup>& lookups) const {
+    std::vector<std::pair<size_t, size_t>> order;
+    order.reserve(lookups.size());
+    for (size_t i = 0; i < lookups.size(); ++i) {
+        order.emplace_back(shardIndexFor(lookups[i].deptCode), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    size_t next = 0;
+    while (next < order.size()) {
+        const Shard& shard = *shards[order[next].first];
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        for (size_t shardIndex = order[next].first; next < order.size() && order[next].first == shardIndex; ++next) {
+            CourseLookup& lookup = lookups[order[next].second];
+            auto it = shard.departments.find(lookup.deptCode);
+            lookup.department = it == shard.departments.end() ? nullptr : &it->second;
+            lookup.course = nullptr;
+            if (lookup.department == nullptr) {
+                continue;
+            }
+            uint64_t key;
+            if (CourseIndex::packKey(lookup.deptCode, lookup.courseNumber, key)) {
+                lookup.course = courseIndex.find(key);
+            }
+            if (lookup.course == nullptr) {
+                lookup.course = lookup.department->findCourse(std::to_string(lookup.courseNumber));
+            }
+        }
+    }
+}
+
+/**
+ * Saves the contents of the internal data structure to the file. The save is a
+ * checkpoint of the state at the moment it starts: mutations are paused only until the
+ * checkpoint's LSN is chosen, and any department or course changed while the file is
+ * written is saved as it was before the change.
+ *
+ * Only the departments changed since the last save are written, as a new segment in
+ * the version 2 format (see SnapshotFile); if none changed, no segment is written. A
+ * full save writes every department instead. The manifest naming the segments is then
+ * written to a temporary path and renamed over the old one, so a crash leaves either
+ * the old or the new set of segments. The manifest records the LSN of the last logged
+ * change the segments hold, and the mutation log then drops every record up to it.
+ *
+ * @param full true to write every department even if few changed
+ */
+void MyFileDatabase::saveContentsToFile(bool full) const {
+    std::lock_guard<std::mutex> oneCheckpoint(checkpointMutex);
+    auto locks = lockAllShared();
+
+    uint64_t epoch = ++lastCheckpointEpoch;
+    checkpointCutPending.store(true);
+    while (mutationsInFlight.load() != 0) {
+        std::this_thread::yield();
+    }
+    uint64_t tick = ChangeClock::advance();
+    uint64_t lsn = mutationLog ? mutationLog->getLastLsn() : snapshotLsn;
+    mutationsSinceCheckpoint.store(0);
+    activeCheckpointEpoch.store(epoch);
+    checkpointCutPending.store(false);
+
+    uint64_t changedBytes = 0;
+    for (size_t i = 1; i < manifest.segments.size(); ++i) {
+        changedBytes += manifest.segments[i].size;
+    }
+    full = full || mappingReplaced.load() || manifest.segments.empty() || manifest.segments.size() >= kMaxSegments ||
+           changedBytes * 2 > manifest.segments[0].size;
+    DepartmentList toWrite;
+    for (const auto& it : sortedDepartments()) {
+        if (full || it.second->getChangedAt() > lastSavedTick) {
+            toWrite.push_back(it);
+        }
+    }
+
+    // a database that has not loaded or saved segments yet still numbers its segments
+    // after, and on success deletes, any that an earlier database left at this path
+    SnapshotManifest previous = manifest.segments.empty() ? manifestOnDisk(filePath) : manifest;
+    SnapshotManifest next = previous;
+    next.lsn = lsn;
+    std::string segmentPath = SnapshotManifest::segmentPath(filePath, next.nextSegment);
+    if (full || !toWrite.empty()) {
+        bool written;
+        SnapshotManifest::Segment segment{next.nextSegment++, 0};
+        try {
+            SnapshotWriter writer(segmentPath);
+            for (const auto& it : toWrite) {
+                it.second->writeCheckpoint(writer, *it.first, epoch);
+            }
+            written = writer.finish(lsn);
+            segment.size = writer.getFileSize();
+        } catch (...) {
+            activeCheckpointEpoch.store(0);
+            std::remove(segmentPath.c_str());
+            throw;
+        }
+        if (!written || !syncFile(segmentPath)) {
+            activeCheckpointEpoch.store(0);
+            std::remove(segmentPath.c_str());
+            return;
+        }
+        if (full) {
+            next.segments.clear();
+        }
+        next.segments.push_back(segment);
+    }
+    activeCheckpointEpoch.store(0);
+
+    std::string tempPath = filePath + ".tmp";
+    if (!next.write(tempPath) || !syncFile(tempPath) || std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        std::remove(segmentPath.c_str());
+        return;
+    }
+    syncDirectoryOf(filePath);
+    if (full) {
+        for (const auto& segment : previous.segments) {
+            std::remove(SnapshotManifest::segmentPath(filePath, segment.number).c_str());
+        }
+    }
+    uint64_t bytes = next.getFileSize() + (next.nextSegment != previous.nextSegment ? next.segments.back().size : 0);
+    manifest = next;
+    mappingReplaced.store(false);
+    lastSavedTick = tick;
+    lastSaveBytes.store(bytes);
+    ++checkpointCount;
+    if (mutationLog) {
+        mutationLog->discardThrough(lsn);
     }
-    outFile.close();
 }
 
 /**
- * Deserializes the object from the file and returns the department mapping.
+ * Deserializes the object from the file and returns the department mapping. Segments
+ * named by a manifest, and a single version 2 file, are mapped into memory and only
+ * their department tables are read; each department's courses are read from the last
+ * segment holding the department when first needed. A file in the original format is
+ * read in full.
  *
  * @return the deserialized department mapping
+ * @throws std::runtime_error if a segment named by the manifest is missing
  */
 void MyFileDatabase::deSerializeObjectFromFile() {
+    std::lock_guard<std::mutex> oneCheckpoint(checkpointMutex);
+    auto locks = lockAllExclusive();
+    SnapshotManifest saved;
+    if (SnapshotManifest::read(filePath, saved)) {
+        std::vector<std::shared_ptr<const SnapshotFile>> segments;
+        std::map<std::string, std::pair<size_t, size_t>> latest;
+        for (const auto& segment : saved.segments) {
+            std::string segmentPath = SnapshotManifest::segmentPath(filePath, segment.number);
+            segments.push_back(SnapshotFile::open(segmentPath));
+            if (!segments.back()) {
+                throw std::runtime_error("missing segment " + segmentPath);
+            }
+            for (size_t i = 0; i < segments.back()->getDepartmentCount(); ++i) {
+                latest[segments.back()->getDepartmentKey(i)] = std::make_pair(segments.size() - 1, i);
+            }
+        }
+        for (const auto& it : latest) {
+            shardFor(it.first).departments.emplace(std::piecewise_construct, std::forward_as_tuple(it.first),
+                                                   std::forward_as_tuple(segments[it.second.first], it.second.second));
+        }
+        snapshotLsn = saved.lsn;
+        manifest = saved;
+        mappingReplaced.store(false);
+        lastSavedTick = 0;
+        courseIndex = CourseIndex();
+        buildCourseViews();
+        ++mappingGeneration;
+        ++catalogVersion;
+        return;
+    }
+
+    std::shared_ptr<const SnapshotFile> snapshot = SnapshotFile::open(filePath);
+    if (snapshot) {
+        for (size_t i = 0; i < snapshot->getDepartmentCount(); ++i) {
+            std::string key = snapshot->getDepartmentKey(i);
+            shardFor(key).departments.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                              std::forward_as_tuple(snapshot, i));
+        }
+        snapshotLsn = snapshot->getLsn();
+        courseIndex = CourseIndex();
+        buildCourseViews();
+        ++mappingGeneration;
+        ++catalogVersion;
+        return;
+    }
+
     std::ifstream inFile(filePath, std::ios::binary);
-    size_t mapSize;
-    inFile.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
-    for (size_t i = 0; i < mapSize; ++i) {
-        size_t keyLen;
-        inFile.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
-        std::string key(keyLen, ' ');
-        inFile.read(&key[0], keyLen);
-        Department dept; 
-        dept.deserialize(inFile);
-        departmentMapping[key] = dept;
+    BufferedReader reader(inFile, kLoadChunkSize);
+    size_t mapSize = 0;
+    reader.read(mapSize);
+    std::string key;
+    for (size_t i = 0; i < mapSize && reader.ok(); ++i) {
+        reader.readString(key);
+        Department& dept = shardFor(key).departments[key];
+        dept.deserialize(reader);
+    }
+
+    uint64_t footer[2] = {0, 0};
+    if (reader.read(footer) && footer[1] == kSnapshotFooterMagic) {
+        snapshotLsn = footer[0];
+    }
+    courseIndex = buildCourseIndex();
+    buildCourseViews();
+    ++mappingGeneration;
+    ++catalogVersion;
+}
+
+/**
+ * Reads the courses of every department that is still only in the mapped data file.
+ * The file's department table says where each department's courses are, so departments
+ * are decoded independently: worker threads take the next unloaded department until
+ * none are left. Lookups can run meanwhile; a department being decoded makes its own
+ * lookups wait until it is done. The course index is then rebuilt to hold every
+ * course, and swapped in unless the mapping was replaced in the meantime. The course
+ * columns and indexes are rebuilt with every shard locked exclusively, so that no
+ * change made while they are read is copied into the old ones instead.
+ *
+ * @param threads the number of threads to decode with, counting the caller; 0 for one
+ *                per hardware thread
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+void MyFileDatabase::loadAllDepartments(unsigned threads) {
+    auto locks = lockAllShared();
+    uint64_t generation = mappingGeneration;
+    std::vector<const Department*> departments;
+    for (const auto& shard : shards) {
+        for (const auto& it : shard->departments) {
+            if (!it.second.isLoaded()) {
+                departments.push_back(&it.second);
+            }
+        }
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, departments.size()));
+
+    std::atomic<size_t> next(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+        try {
+            for (size_t i = next++; i < departments.size(); i = next++) {
+                departments[i]->loadCourses();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> errorLock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(departments.size());
+        }
+    };
+    runInParallel(threads, work);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    CourseIndex index = buildCourseIndex();
+    locks.clear();
+    auto exclusive = lockAllExclusive();
+    if (mappingGeneration == generation) {
+        courseIndex = std::move(index);
+        buildCourseViews();
     }
-    inFile.close();
 }
 
 /**
- * Returns a string representation of the database.
+ * Gets the number of bytes the last save wrote: its segment, if it wrote one, and the
+ * manifest.
+ */
+uint64_t MyFileDatabase::getLastSaveBytes() const {
+    return lastSaveBytes.load();
+}
+
+/**
+ * Deletes a database's data file and, if it is a manifest, the segments it names.
+ *
+ * @param filePath the data path of the database
+ */
+void MyFileDatabase::removeDataFiles(const std::string& filePath) {
+    for (const auto& segment : manifestOnDisk(filePath).segments) {
+        std::remove(SnapshotManifest::segmentPath(filePath, segment.number).c_str());
+    }
+    std::remove(filePath.c_str());
+}
+
+/**
+ * Returns a string representation of the database. The shards are rendered on
+ * parallel threads and the parts put back in department order.
  *
  * @return a string representation of the database
  */
 std::string MyFileDatabase::display() const {
+    auto locks = lockAllShared();
+    std::vector<std::vector<std::pair<const std::string*, std::string>>> rendered(shards.size());
+    std::atomic<size_t> next(0);
+    unsigned threads = static_cast<unsigned>(
+        std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), shards.size()));
+    runInParallel(threads, [&]() {
+        for (size_t i = next++; i < shards.size(); i = next++) {
+            for (const auto& it : shards[i]->departments) {
+                rendered[i].emplace_back(&it.first,
+                                         "For the " + it.first + " department:\n" + it.second.display() + "\n");
+            }
+        }
+    });
+
+    std::vector<std::pair<const std::string*, std::string>> parts;
+    for (auto& shardParts : rendered) {
+        std::move(shardParts.begin(), shardParts.end(), std::back_inserter(parts));
+    }
+    std::sort(parts.begin(), parts.end(), [](const std::pair<const std::string*, std::string>& a,
+                                             const std::pair<const std::string*, std::string>& b) {
+        return *a.first < *b.first;
+    });
     std::string result;
-    for (const auto& it : departmentMapping) {
-        result += "For the " + it.first + " department:\n" + it.second.display() + "\n";
+    for (const auto& part : parts) {
+        result += part.second;
     }
     return result;
 }
+
+/**
+ * Writes the database as a JSON object with one member per department, in department
+ * order, as Department::writeJson() writes it. Unlike display() the departments are
+ * written one after another straight into the output, with no part built on the side.
+ *
+ * @param out the writer to write the object with
+ */
+void MyFileDatabase::writeJson(JsonWriter& out) const {
+    auto locks = lockAllShared();
+    out.beginObject();
+    for (const auto& it : sortedDepartments()) {
+        out.key(*it.first);
+        it.second->writeJson(out);
+    }
+    out.endObject();
+}
+
+/**
+ * Finds every course passing all of the given conditions, scanning the course columns.
+ * Departments still in the mapped data file are loaded first.
+ *
+ * @param conditions the conditions, all of which must hold; none matches every course
+ * @return the matching courses, in department and course ID order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseMatch> MyFileDatabase::queryCourses(const std::vector<CourseColumns::Condition>& conditions) {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    std::vector<CourseMatch> matches;
+    for (size_t row : courseColumns->select(conditions)) {
+        matches.push_back(CourseMatch{courseColumns->getDeptCode(row), courseColumns->getCourseId(row),
+                                      courseColumns->getCapacity(row), courseColumns->getEnrolled(row)});
+    }
+    return matches;
+}
+
+/**
+ * Finds every course with the given instructor, location or time slot through the
+ * attribute index. Departments still in the mapped data file are loaded first.
+ *
+ * @param attribute the attribute to match
+ * @param value     the value it must have
+ * @return the matching courses, in department and course ID order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseRef> MyFileDatabase::findCoursesBy(CourseAttributeIndex::Attribute attribute,
+                                                     const std::string& value) {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    return attributeIndex->find(attribute, value);
+}
+
+/**
+ * Finds the instructors, locations or time slots best matching partly typed or
+ * misspelled text through the attribute index. Departments still in the mapped data
+ * file are loaded first.
+ *
+ * @param attribute the attribute to search
+ * @param query     the text typed so far
+ * @param limit     the most values to return
+ * @return the best matches with their course counts, best first
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseAttributeIndex::SearchHit> MyFileDatabase::searchValues(CourseAttributeIndex::Attribute attribute,
+                                                                          const std::string& query, size_t limit) {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    return attributeIndex->search(attribute, query, limit);
+}
+
+/**
+ * Finds every course meeting during any part of a range of the day through the time
+ * range index. Departments still in the mapped data file are loaded first.
+ *
+ * @param range the minutes to look for, start inclusive and end exclusive
+ * @return the matching courses, in department and course ID order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseRef> MyFileDatabase::findCoursesMeeting(const TimeInterval& range) {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    return timeRangeIndex->find(range);
+}
+
+/**
+ * Finds the rooms no course holds during any part of a range of the day. Departments
+ * still in the mapped data file are loaded first.
+ *
+ * @param range the minutes the room must be free, start inclusive and end exclusive
+ * @return the free rooms, in name order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<std::string> MyFileDatabase::findFreeRooms(const TimeInterval& range) {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    return roomOccupancy->findFreeRooms(range);
+}
+
+/**
+ * Lists every full course from the full course bitmap. Departments still in the mapped
+ * data file are loaded first.
+ *
+ * @return the full courses, in department and course ID order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseRef> MyFileDatabase::findFullCourses() {
+    loadCourseViews();
+    auto locks = lockAllShared();
+    return fullCourses->findFull();
+}
+
+/**
+ * Lists the full courses of one department from the full course bitmap.
+ *
+ * @param deptCode the code of the department
+ * @return the department's full courses, in course ID order
+ * @throws std::runtime_error if a department's section of the file is corrupt
+ */
+std::vector<CourseRef> MyFileDatabase::findFullCourses(const std::string& deptCode) {
+    loadCourseViews();
+    std::shared_lock<std::shared_timed_mutex> lock(shardFor(deptCode).mutex);
+    return fullCourses->findFull(deptCode);
+}
+
+/**
+ * Gets a number that moves on after every change made through commitMutation() or
+ * commitMutations() and whenever the mapping is replaced or loaded. Courses changed
+ * directly, not through the database, do not move it.
+ */
+uint64_t MyFileDatabase::getVersion() const {
+    return catalogVersion.load();
+}
+
+/**
+ * Gets the number of times the mapping was replaced or loaded. Department and course
+ * versions are only comparable between reads made within one generation.
+ */
+uint64_t MyFileDatabase::getMappingGeneration() const {
+    return mappingGeneration.load();
+}
+
+/**
+ * Replays the mutation log on top of the loaded snapshot and keeps the log open so
+ * later calls to commitMutation() append to it.
+ *
+ * @param logPath  the path of the log file, created if missing
+ * @param options  how appended records are made durable
+ */
+void MyFileDatabase::enableMutationLog(const std::string& logPath, const MutationLog::Options& options) {
+    uint64_t lastLsn = MutationLog::replay(logPath, snapshotLsn, [this](const MutationRecord& record) {
+        applyMutation(record, true);
+    });
+    ++catalogVersion;
+    mutationLog.reset(new MutationLog(logPath, options, lastLsn));
+}
+
+/**
+ * Applies a mutation, logs it if it changed anything, and waits until the log record
+ * is as durable as the sync policy promises.
+ *
+ * Every change is applied and appended under a lock striped by department and course,
+ * so that the log holds changes to the same record in the order they were applied.
+ * Enrolls and drops are replayed as increments, which give the same result in any
+ * order, so they share the lock with each other; every other change, an assignment to
+ * the enrolled count included, holds it alone. A location or time change is rejected if it would clash with another course
+ * in the same room; departments still in the mapped data file are loaded first so
+ * that every course's room is known.
+ *
+ * A running checkpoint only holds mutations back while it picks its LSN, so each
+ * change is either entirely before the checkpoint, applied and logged with a smaller
+ * LSN, or entirely after it.
+ *
+ * @param record the mutation to perform
+ * @return what happened to it
+ */
+MutationResult MyFileDatabase::commitMutation(const MutationRecord& record) {
+    uint64_t lsn = 0;
+    MutationResult result;
+    bool commutative = record.type == MutationType::EnrollStudent || record.type == MutationType::DropStudent;
+    if (record.type == MutationType::SetCourseLocation || record.type == MutationType::SetCourseTime) {
+        loadCourseViews();
+    }
+    enterMutation();
+    try {
+        std::shared_timed_mutex& stripe = orderingStripeFor(record);
+        std::shared_lock<std::shared_timed_mutex> sharedOrder(stripe, std::defer_lock);
+        std::unique_lock<std::shared_timed_mutex> order(stripe, std::defer_lock);
+        if (commutative) {
+            sharedOrder.lock();
+        } else {
+            order.lock();
+        }
+        result = applyMutation(record, false);
+        if (result == MutationResult::Applied && mutationLog) {
+            lsn = mutationLog->append(record);
+        }
+        if (result == MutationResult::Applied) {
+            ++catalogVersion;
+        }
+    } catch (...) {
+        exitMutation();
+        throw;
+    }
+    exitMutation();
+
+    if (result == MutationResult::Applied &&
+        mutationsSinceCheckpoint.fetch_add(1) + 1 == checkpointOptions.everyMutations) {
+        std::lock_guard<std::mutex> lock(checkpointerMutex);
+        checkpointerWakeup.notify_one();
+    }
+    if (lsn != 0) {
+        mutationLog->waitDurable(lsn);
+    }
+    return result;
+}
+
+/**
+ * Applies a batch of course changes all or nothing, logs them as one record and waits
+ * until it is as durable as the sync policy promises.
+ *
+ * Only enrolled count, location, instructor and time changes can be batched. The
+ * ordering stripes of every change are taken first, in stripe order, then the lock of
+ * every shard the batch touches, in shard order, each once for the whole batch. A
+ * batch naming a missing department or course, or moving courses so that a room
+ * would be held twice at once, changes nothing. A course changed more than once ends
+ * up as the last of its changes leaves it.
+ *
+ * @param records the changes to make, in order
+ * @return Applied, or what stopped the batch; Unchanged for an empty batch
+ */
+BatchResult MyFileDatabase::commitMutations(const std::vector<MutationRecord>& records) {
+    bool moving = false;
+    for (size_t i = 0; i < records.size(); ++i) {
+        switch (records[i].type) {
+            case MutationType::SetCourseLocation:
+            case MutationType::SetCourseTime:
+                moving = true;
+                break;
+            case MutationType::SetEnrollmentCount:
+            case MutationType::SetCourseInstructor:
+                break;
+            default:
+                return BatchResult{MutationResult::Rejected, i};
+        }
+    }
+    if (records.empty()) {
+        return BatchResult{MutationResult::Unchanged, 0};
+    }
+    if (moving) {
+        loadCourseViews();
+    }
+
+    std::vector<std::shared_timed_mutex*> stripes;
+    std::vector<size_t> shardIndexes;
+    for (const MutationRecord& record : records) {
+        stripes.push_back(&orderingStripeFor(record));
+        shardIndexes.push_back(shardIndexFor(record.deptCode));
+    }
+    std::sort(stripes.begin(), stripes.end());
+    stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+    std::sort(shardIndexes.begin(), shardIndexes.end());
+    shardIndexes.erase(std::unique(shardIndexes.begin(), shardIndexes.end()), shardIndexes.end());
+
+    uint64_t lsn = 0;
+    BatchResult result;
+    enterMutation();
+    try {
+        std::vector<std::unique_lock<std::shared_timed_mutex>> order;
+        for (std::shared_timed_mutex* stripe : stripes) {
+            order.emplace_back(*stripe);
+        }
+        std::vector<std::shared_lock<std::shared_timed_mutex>> locks;
+        for (size_t shardIndex : shardIndexes) {
+            locks.emplace_back(shards[shardIndex]->mutex);
+        }
+        result = applyBatch(records);
+        if (result.result == MutationResult::Applied && mutationLog) {
+            lsn = mutationLog->appendBatch(records);
+        }
+        if (result.result == MutationResult::Applied) {
+            ++catalogVersion;
+        }
+    } catch (...) {
+        exitMutation();
+        throw;
+    }
+    exitMutation();
+
+    if (result.result == MutationResult::Applied) {
+        uint64_t before = mutationsSinceCheckpoint.fetch_add(records.size());
+        if (before < checkpointOptions.everyMutations && before + records.size() >= checkpointOptions.everyMutations) {
+            std::lock_guard<std::mutex> lock(checkpointerMutex);
+            checkpointerWakeup.notify_one();
+        }
+    }
+    if (lsn != 0) {
+        mutationLog->waitDurable(lsn);
+    }
+    return result;
+}
+
+/**
+ * Gets the mutation log, or nullptr if logging is not enabled.
+ */
+MutationLog* MyFileDatabase::getMutationLog() const {
+    return mutationLog.get();
+}
+
+/**
+ * Performs a single mutation on the in-memory state. During replay enrollment changes
+ * are applied as plain increments, since they were already checked when first made.
+ */
+MutationResult MyFileDatabase::applyMutation(const MutationRecord& record, bool replaying) {
+    uint64_t checkpointEpoch = replaying ? 0 : activeCheckpointEpoch.load(std::memory_order_acquire);
+    if (record.type == MutationType::AddMajor || record.type == MutationType::RemoveMajor) {
+        Department* dept = findDepartment(record.deptCode);
+        if (dept == nullptr) {
+            return MutationResult::DepartmentNotFound;
+        }
+        if (checkpointEpoch != 0) {
+            dept->preserveForCheckpoint(checkpointEpoch);
+        }
+        if (record.type == MutationType::AddMajor) {
+            dept->addPersonToMajor();
+            return MutationResult::Applied;
+        }
+        return dept->dropPersonFromMajor() ? MutationResult::Applied : MutationResult::Unchanged;
+    }
+
+    Course* course = findCourse(record.deptCode, record.courseId);
+    if (course == nullptr) {
+        return findDepartment(record.deptCode) == nullptr ? MutationResult::DepartmentNotFound
+                                                          : MutationResult::CourseNotFound;
+    }
+    if (checkpointEpoch != 0) {
+        course->preserveForCheckpoint(checkpointEpoch);
+    }
+    switch (record.type) {
+        case MutationType::SetEnrollmentCount:
+            course->setEnrolledStudentCount(record.value);
+            break;
+        case MutationType::SetCourseLocation:
+        case MutationType::SetCourseTime:
+            if (!moveCourse(record, course, replaying)) {
+                return MutationResult::Rejected;
+            }
+            break;
+        case MutationType::SetCourseInstructor:
+            course->reassignInstructor(record.text);
+            break;
+        case MutationType::EnrollStudent:
+            if (replaying) {
+                course->setEnrolledStudentCount(course->getEnrolledStudentCount() + 1);
+            } else if (!course->enrollStudent()) {
+                return MutationResult::Rejected;
+            }
+            break;
+        case MutationType::DropStudent:
+            if (replaying) {
+                course->setEnrolledStudentCount(course->getEnrolledStudentCount() - 1);
+            } else if (!course->dropStudent()) {
+                return MutationResult::Rejected;
+            }
+            break;
+        default:
+            return MutationResult::Rejected;
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(shardFor(record.deptCode).mutex);
+    if (record.type == MutationType::SetEnrollmentCount || record.type == MutationType::EnrollStudent ||
+        record.type == MutationType::DropStudent) {
+        courseColumns->refreshEnrollment(course);
+        fullCourses->refresh(course);
+    } else {
+        courseColumns->refresh(course);
+        attributeIndex->refresh(course);
+        if (record.type == MutationType::SetCourseTime) {
+            timeRangeIndex->refresh(course);
+        }
+    }
+    return MutationResult::Applied;
+}
+
+/**
+ * Changes a course's location or time slot, first claiming its new room and time in
+ * the room occupancy. The shard lock is held throughout, so the occupancy is not
+ * rebuilt between the claim and the change. A new location is not interned unless
+ * the move is made, so a rejected move leaves nothing in the string pool. During
+ * replay the room is claimed without checking for clashes.
+ *
+ * @return false, changing nothing, if another course holds the room at that time
+ */
+bool MyFileDatabase::moveCourse(const MutationRecord& record, Course* course, bool replaying) {
+    bool relocating = record.type == MutationType::SetCourseLocation;
+    std::shared_lock<std::shared_timed_mutex> lock(shardFor(record.deptCode).mutex);
+    TimeInterval meeting = relocating ? course->getMeetingTime() : TimeInterval::parse(record.text);
+    RoomOccupancy::Move move{course, course->getInternedStrings().courseLocation, meeting};
+    if (relocating) {
+        move.room = &record.text;
+        move.pooled = false;
+    }
+    size_t clash = 0;
+    if (replaying) {
+        roomOccupancy->place(course, move.pooled ? move.room : StringPool::intern(record.text), meeting);
+    } else if (!roomOccupancy->tryPlaceAll({move}, clash)) {
+        return false;
+    }
+    if (relocating) {
+        course->reassignLocation(record.text);
+    } else {
+        course->reassignTime(record.text);
+    }
+    return true;
+}
+
+/**
+ * Performs a batch of course changes on the in-memory state, after finding every
+ * course and claiming the rooms and times of every moved course in one step. New
+ * locations are only interned once the claim succeeds. The
+ * caller holds the ordering stripe of every change and the lock of every shard the
+ * batch touches.
+ */
+BatchResult MyFileDatabase::applyBatch(const std::vector<MutationRecord>& records) {
+    std::vector<Course*> courses(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Shard& shard = shardFor(records[i].deptCode);
+        auto dept = shard.departments.find(records[i].deptCode);
+        if (dept == shard.departments.end()) {
+            return BatchResult{MutationResult::DepartmentNotFound, i};
+        }
+        uint64_t key;
+        if (CourseIndex::packKey(records[i].deptCode, records[i].courseId, key)) {
+            courses[i] = courseIndex.find(key);
+        }
+        if (courses[i] == nullptr) {
+            courses[i] = dept->second.findCourse(records[i].courseId);
+        }
+        if (courses[i] == nullptr) {
+            return BatchResult{MutationResult::CourseNotFound, i};
+        }
+    }
+
+    std::vector<RoomOccupancy::Move> moves;
+    std::vector<size_t> lastChange;
+    std::unordered_map<const Course*, size_t> moveOf;
+    for (size_t i = 0; i < records.size(); ++i) {
+        bool relocating = records[i].type == MutationType::SetCourseLocation;
+        if (!relocating && records[i].type != MutationType::SetCourseTime) {
+            continue;
+        }
+        auto found = moveOf.emplace(courses[i], moves.size());
+        size_t m = found.first->second;
+        if (found.second) {
+            moves.push_back(RoomOccupancy::Move{courses[i], courses[i]->getInternedStrings().courseLocation,
+                                                courses[i]->getMeetingTime()});
+            lastChange.push_back(i);
+        }
+        if (relocating) {
+            moves[m].room = &records[i].text;
+            moves[m].pooled = false;
+        } else {
+            moves[m].meeting = TimeInterval::parse(records[i].text);
+        }
+        lastChange[m] = i;
+    }
+    size_t clash = 0;
+    if (!moves.empty() && !roomOccupancy->tryPlaceAll(moves, clash)) {
+        return BatchResult{MutationResult::Rejected, lastChange[clash]};
+    }
+
+    uint64_t checkpointEpoch = activeCheckpointEpoch.load(std::memory_order_acquire);
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (checkpointEpoch != 0) {
+            courses[i]->preserveForCheckpoint(checkpointEpoch);
+        }
+        switch (records[i].type) {
+            case MutationType::SetEnrollmentCount:
+                courses[i]->setEnrolledStudentCount(records[i].value);
+                break;
+            case MutationType::SetCourseLocation:
+                courses[i]->reassignLocation(records[i].text);
+                break;
+            case MutationType::SetCourseInstructor:
+                courses[i]->reassignInstructor(records[i].text);
+                break;
+            default:
+                courses[i]->reassignTime(records[i].text);
+                break;
+        }
+    }
+
+    std::sort(courses.begin(), courses.end());
+    courses.erase(std::unique(courses.begin(), courses.end()), courses.end());
+    for (Course* course : courses) {
+        courseColumns->refresh(course);
+        attributeIndex->refresh(course);
+        fullCourses->refresh(course);
+    }
+    for (const RoomOccupancy::Move& move : moves) {
+        timeRangeIndex->refresh(move.course);
+    }
+    return BatchResult{MutationResult::Applied, 0};
+}
+
+/**
+ * Finds the position of the shard owning a department code.
+ */
+size_t MyFileDatabase::shardIndexFor(const std::string& deptCode) const {
+    return std::hash<std::string>()(deptCode) % shards.size();
+}
+
+/**
+ * Finds the shard owning a department code.
+ */
+MyFileDatabase::Shard& MyFileDatabase::shardFor(const std::string& deptCode) const {
+    return *shards[shardIndexFor(deptCode)];
+}
+
+/**
+ * Takes every shard's lock in shared mode, always in shard order.
+ */
+std::vector<std::shared_lock<std::shared_timed_mutex>> MyFileDatabase::lockAllShared() const {
+    std::vector<std::shared_lock<std::shared_timed_mutex>> locks;
+    locks.reserve(shards.size());
+    for (const auto& shard : shards) {
+        locks.emplace_back(shard->mutex);
+    }
+    return locks;
+}
+
+/**
+ * Takes every shard's lock exclusively, always in shard order.
+ */
+std::vector<std::unique_lock<std::shared_timed_mutex>> MyFileDatabase::lockAllExclusive() const {
+    std::vector<std::unique_lock<std::shared_timed_mutex>> locks;
+    locks.reserve(shards.size());
+    for (const auto& shard : shards) {
+        locks.emplace_back(shard->mutex);
+    }
+    return locks;
+}
+
+/**
+ * Lists every department in key order. The caller holds every shard's lock.
+ */
+MyFileDatabase::DepartmentList MyFileDatabase::sortedDepartments() const {
+    DepartmentList departments;
+    for (const auto& shard : shards) {
+        for (const auto& it : shard->departments) {
+            departments.emplace_back(&it.first, &it.second);
+        }
+    }
+    std::sort(departments.begin(), departments.end(),
+              [](const DepartmentList::value_type& a, const DepartmentList::value_type& b) {
+                  return *a.first < *b.first;
+              });
+    return departments;
+}
+
+/**
+ * Builds a course index over every department whose courses are in memory. The caller
+ * holds every shard's lock.
+ */
+CourseIndex MyFileDatabase::buildCourseIndex() const {
+    size_t courseCount = 0;
+    for (const auto& shard : shards) {
+        for (const auto& it : shard->departments) {
+            courseCount += it.second.isLoaded() ? it.second.getCourseSelection().size() : 0;
+        }
+    }
+    CourseIndex index(courseCount);
+    uint64_t key;
+    for (const auto& shard : shards) {
+        for (const auto& it : shard->departments) {
+            if (!it.second.isLoaded()) {
+                continue;
+            }
+            for (const auto& course : it.second.getCourseSelection()) {
+                if (CourseIndex::packKey(it.first, course.first, key)) {
+                    index.insert(key, course.second.get());
+                }
+            }
+        }
+    }
+    return index;
+}
+
+/**
+ * Rebuilds the course columns, attribute index, time range index, room occupancy and
+ * full course bitmap from every department whose courses are in memory, in key order.
+ * The caller holds every shard's lock exclusively.
+ */
+void MyFileDatabase::buildCourseViews() {
+    courseColumns.reset(new CourseColumns());
+    attributeIndex.reset(new CourseAttributeIndex());
+    timeRangeIndex.reset(new TimeRangeIndex());
+    roomOccupancy.reset(new RoomOccupancy());
+    fullCourses.reset(new FullCourseBitmap());
+    viewsComplete = true;
+    for (const auto& it : sortedDepartments()) {
+        if (it.second->isLoaded()) {
+            courseColumns->addDepartment(*it.first, it.second->getCourseSelection());
+            attributeIndex->addDepartment(*it.first, it.second->getCourseSelection());
+            timeRangeIndex->addDepartment(*it.first, it.second->getCourseSelection());
+            roomOccupancy->addDepartment(it.second->getCourseSelection());
+            fullCourses->addDepartment(*it.first, it.second->getCourseSelection());
+        } else {
+            viewsComplete = false;
+        }
+    }
+}
+
+/**
+ * Loads every department still in the mapped data file, unless the course columns
+ * and indexes already hold every department.
+ */
+void MyFileDatabase::loadCourseViews() {
+    bool complete;
+    {
+        auto locks = lockAllShared();
+        complete = viewsComplete;
+    }
+    if (!complete) {
+        loadAllDepartments(0);
+    }
+}
+
+/**
+ * Probes the course index under the lock of the shard owning a department.
+ */
+Course* MyFileDatabase::findIndexedCourse(const std::string& deptCode, uint64_t key) const {
+    std::shared_lock<std::shared_timed_mutex> lock(shardFor(deptCode).mutex);
+    return courseIndex.find(key);
+}
+
+std::shared_timed_mutex& MyFileDatabase::orderingStripeFor(const MutationRecord& record) {
+    size_t hash = std::hash<std::string>()(record.deptCode) * 31 + std::hash<std::string>()(record.courseId);
+    return orderingStripes[hash % kOrderingStripes];
+}
+
+/**
+ * Registers a mutation as in progress, first waiting out a checkpoint that is choosing
+ * its LSN.
+ */
+void MyFileDatabase::enterMutation() {
+    while (true) {
+        mutationsInFlight.fetch_add(1);
+        if (!checkpointCutPending.load()) {
+            return;
+        }
+        mutationsInFlight.fetch_sub(1);
+        while (checkpointCutPending.load()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void MyFileDatabase::exitMutation() {
+    mutationsInFlight.fetch_sub(1);
+}
+
+/**
+ * Starts a background thread that saves the file every options.intervalMs, or sooner
+ * once options.everyMutations changes have been made since the last save. Nothing is
+ * written while no changes are made.
+ *
+ * @param options when to checkpoint
+ */
+void MyFileDatabase::startCheckpointer(const CheckpointOptions& options) {
+    stopCheckpointer();
+    checkpointOptions = options;
+    checkpointerStopping = false;
+    checkpointer = std::thread(&MyFileDatabase::checkpointLoop, this);
+}
+
+/**
+ * Stops the background checkpointer, waiting for a checkpoint in progress to finish.
+ */
+void MyFileDatabase::stopCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointerMutex);
+        checkpointerStopping = true;
+    }
+    checkpointerWakeup.notify_all();
+    if (checkpointer.joinable()) {
+        checkpointer.join();
+    }
+}
+
+/**
+ * Gets the number of checkpoints written so far, by saveContentsToFile() or by the
+ * background checkpointer.
+ */
+uint64_t MyFileDatabase::getCheckpointCount() const {
+    return checkpointCount.load();
+}
+
+void MyFileDatabase::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(checkpointerMutex);
+    while (!checkpointerStopping) {
+        checkpointerWakeup.wait_for(lock, std::chrono::milliseconds(checkpointOptions.intervalMs), [this]() {
+            return checkpointerStopping || (checkpointOptions.everyMutations != 0 &&
+                                            mutationsSinceCheckpoint.load() >= checkpointOptions.everyMutations);
+        });
+        if (checkpointerStopping || mutationsSinceCheckpoint.load() == 0) {
+            continue;
+        }
+        lock.unlock();
+        try {
+            saveContentsToFile();
+        } catch (const std::exception& e) {
+            std::cerr << "Checkpoint failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
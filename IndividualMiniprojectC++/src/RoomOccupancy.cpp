@@ -0,0 +1,260 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "RoomOccupancy.h"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool intersects(const RoomOccupancy::Bitmap& a, const RoomOccupancy::Bitmap& b) {
+    uint64_t any = 0;
+    for (int w = 0; w < RoomOccupancy::kWords; ++w) {
+        any |= a[w] & b[w];
+    }
+    return any != 0;
+}
+
+}  // namespace
+
+RoomOccupancy::RoomOccupancy() {}
+
+/**
+ * Turns a meeting time into the bitmap of the slots it touches.
+ *
+ * @param meeting the meeting time
+ * @return the slots, none if the meeting time is not valid
+ */
+RoomOccupancy::Bitmap RoomOccupancy::slotsOf(const TimeInterval& meeting) {
+    Bitmap slots{};
+    if (!meeting.isValid()) {
+        return slots;
+    }
+    int first = meeting.start / kSlotMinutes;
+    int last = (meeting.end - 1) / kSlotMinutes;
+    for (int w = first / 64; w <= last / 64; ++w) {
+        int lo = std::max(first, w * 64) - w * 64;
+        int hi = std::min(last, w * 64 + 63) - w * 64;
+        uint64_t upToHi = hi == 63 ? ~0ull : (1ull << (hi + 1)) - 1;
+        slots[w] = upToHi & ~((1ull << lo) - 1);
+    }
+    return slots;
+}
+
+/**
+ * Places every course of a department in its room, without checking for clashes.
+ *
+ * @param courses the department's courses
+ */
+void RoomOccupancy::addDepartment(const CourseTable& courses) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    for (const auto& it : courses) {
+        const Course* course = it.second.get();
+        placeLocked(course, course->getInternedStrings().courseLocation, course->getMeetingTime());
+    }
+}
+
+/**
+ * Checks whether moving a course to a room and meeting time would make it share the
+ * room with another course. The course's own current placement does not count.
+ *
+ * @param course  the course to move
+ * @param room    the pooled location it would have
+ * @param meeting the meeting time it would have
+ * @return true if another course holds the room during any of the meeting's slots
+ */
+bool RoomOccupancy::wouldConflict(const Course* course, const std::string* room, const TimeInterval& meeting) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return conflictsLocked(course, room, slotsOf(meeting));
+}
+
+/**
+ * Moves a course to a room and meeting time unless another course holds the room
+ * during any of its slots. The check and the move are one step.
+ *
+ * @param course  the course to move
+ * @param room    the pooled location it gets
+ * @param meeting the meeting time it gets
+ * @return false, leaving the course where it was, if the room is taken
+ */
+bool RoomOccupancy::tryPlace(const Course* course, const std::string* room, const TimeInterval& meeting) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (conflictsLocked(course, room, slotsOf(meeting))) {
+        return false;
+    }
+    placeLocked(course, room, meeting);
+    return true;
+}
+
+/**
+ * Moves several courses at once unless any of them would then share a room with
+ * another course, or with each other. Their current slots are released before the new
+ * ones are checked, so courses can swap rooms or times in one call.
+ *
+ * A room not yet in the string pool is held by no course, so it can only clash with
+ * the other moves. Such rooms are checked under a stand-in key, the move's own string,
+ * and interned only once every move fits, so a rejected call leaves nothing pooled.
+ *
+ * @param moves  the courses to move and where to, each course at most once
+ * @param clash  set to the position of the first move that clashes
+ * @return false, leaving every course where it was, if any move clashes
+ */
+bool RoomOccupancy::tryPlaceAll(const std::vector<Move>& moves, size_t& clash) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    std::vector<const std::string*> keys(moves.size());
+    std::vector<bool> standsIn(moves.size(), false);
+    std::unordered_map<std::string, const std::string*> standIns;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        keys[i] = moves[i].room;
+        if (!moves[i].pooled) {
+            keys[i] = StringPool::find(*moves[i].room);
+            if (keys[i] == nullptr) {
+                keys[i] = standIns.emplace(*moves[i].room, moves[i].room).first->second;
+                standsIn[i] = true;
+            }
+        }
+    }
+    std::vector<std::pair<const Course*, Placement>> previous;
+    for (const Move& move : moves) {
+        auto placed = placements.find(move.course);
+        if (placed != placements.end()) {
+            previous.emplace_back(placed->first, placed->second);
+            releaseLocked(move.course);
+        }
+    }
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (conflictsLocked(moves[i].course, keys[i], slotsOf(moves[i].meeting))) {
+            for (size_t j = 0; j < i; ++j) {
+                releaseLocked(moves[j].course);
+            }
+            for (const auto& it : previous) {
+                hold(rooms[it.second.room], it.second.slots, 1);
+                placements.emplace(it.first, it.second);
+            }
+            for (const auto& it : standIns) {
+                rooms.erase(it.second);
+            }
+            clash = i;
+            return false;
+        }
+        placeLocked(moves[i].course, keys[i], moves[i].meeting);
+    }
+    if (!standIns.empty()) {
+        for (size_t i = 0; i < moves.size(); ++i) {
+            if (standsIn[i]) {
+                placeLocked(moves[i].course, StringPool::intern(*keys[i]), moves[i].meeting);
+            }
+        }
+        for (const auto& it : standIns) {
+            rooms.erase(it.second);
+        }
+    }
+    return true;
+}
+
+/**
+ * Moves a course to a room and meeting time without checking for clashes.
+ *
+ * @param course  the course to move
+ * @param room    the pooled location it gets
+ * @param meeting the meeting time it gets
+ */
+void RoomOccupancy::place(const Course* course, const std::string* room, const TimeInterval& meeting) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    placeLocked(course, room, meeting);
+}
+
+/**
+ * Finds the rooms no course holds during any part of a range.
+ *
+ * @param range the minutes the room must be free, start inclusive and end exclusive
+ * @return the free rooms, in name order
+ */
+std::vector<std::string> RoomOccupancy::findFreeRooms(const TimeInterval& range) const {
+    Bitmap slots = slotsOf(range);
+    std::vector<std::string> free;
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    for (const auto& it : rooms) {
+        if (!intersects(it.second.occupied, slots)) {
+            free.push_back(*it.first);
+        }
+    }
+    lock.unlock();
+    std::sort(free.begin(), free.end());
+    return free;
+}
+
+/**
+ * Gets the number of rooms any course has been placed in.
+ */
+size_t RoomOccupancy::getRoomCount() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return rooms.size();
+}
+
+/**
+ * Checks for a clash in a room, leaving out the course's own slots if it is already
+ * in that room: a slot clashes if two courses hold it, or if one does and it is not
+ * one of the course's own. The caller holds the lock.
+ */
+bool RoomOccupancy::conflictsLocked(const Course* course, const std::string* room, const Bitmap& slots) const {
+    auto found = rooms.find(room);
+    if (found == rooms.end()) {
+        return false;
+    }
+    Bitmap own{};
+    auto placed = placements.find(course);
+    if (placed != placements.end() && placed->second.room == room) {
+        own = placed->second.slots;
+    }
+    const Room& held = found->second;
+    uint64_t clash = 0;
+    for (int w = 0; w < kWords; ++w) {
+        clash |= slots[w] & (held.shared[w] | (held.occupied[w] & ~own[w]));
+    }
+    return clash != 0;
+}
+
+/**
+ * Releases the course's current slots, if any, and holds its new ones. The caller
+ * holds the lock exclusively.
+ */
+void RoomOccupancy::placeLocked(const Course* course, const std::string* room, const TimeInterval& meeting) {
+    releaseLocked(course);
+    if (!meeting.isValid() || room == nullptr || room->empty()) {
+        return;
+    }
+    Placement placement{room, slotsOf(meeting)};
+    hold(rooms[room], placement.slots, 1);
+    placements.emplace(course, placement);
+}
+
+/**
+ * Releases the course's current slots, if any. The caller holds the lock exclusively.
+ */
+void RoomOccupancy::releaseLocked(const Course* course) {
+    auto placed = placements.find(course);
+    if (placed != placements.end()) {
+        hold(rooms[placed->second.room], placed->second.slots, -1);
+        placements.erase(placed);
+    }
+}
+
+/**
+ * Adds delta to a room's count in each of the given slots and updates its bitmaps.
+ */
+void RoomOccupancy::hold(Room& room, const Bitmap& slots, int delta) {
+    for (int w = 0; w < kWords; ++w) {
+        for (uint64_t bits = slots[w]; bits != 0; bits &= bits - 1) {
+            int bit = __builtin_ctzll(bits);
+            int count = room.counts[w * 64 + bit] += delta;
+            uint64_t mask = 1ull << bit;
+            room.occupied[w] = count >= 1 ? room.occupied[w] | mask : room.occupied[w] & ~mask;
+            room.shared[w] = count >= 2 ? room.shared[w] | mask : room.shared[w] & ~mask;
+        }
+    }
+}
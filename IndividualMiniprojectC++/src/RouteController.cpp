@@ -1,14 +1,20 @@
 // Copyright (c) 2024 Annie Xu @ Columbia University
 
 // C++ System Header
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <map>
 #include <string>
+#include <vector>
 #include <exception>
 #include <iostream>
 
 // Project Header
 #include "RouteController.h"
 #include "Globals.h"
+#include "JsonWriter.h"
 #include "MyFileDatabase.h"
 
 // Third-party Header
@@ -20,6 +26,229 @@ crow::response handleException(const std::exception& e) {
     return crow::response{500, "An error has occurred"};
 }
 
+// Utility function to tell whether the client asked for JSON, with format=json or with
+// an Accept header naming application/json
+bool wantsJson(const crow::request& req) {
+    auto format = req.url_params.get("format");
+    if (format != nullptr) {
+        return std::strcmp(format, "json") == 0;
+    }
+    return req.get_header_value("Accept").find("application/json") != std::string::npos;
+}
+
+// Utility function to start a JSON response; the writer appends straight to the body
+JsonWriter jsonBody(crow::response& res) {
+    res.set_header("Content-Type", "application/json");
+    return JsonWriter(res.body);
+}
+
+// Utility function to write an error message as plain text, or as {"error": message}
+void writeError(crow::response& res, int code, const std::string& message, bool json) {
+    res.code = code;
+    if (json) {
+        jsonBody(res).beginObject().field("error", message).endObject();
+    } else {
+        res.write(message);
+    }
+}
+
+// Utility function to write the department and course a course route was asked about
+void writeCourseKey(JsonWriter& out, const char* deptCode, const char* courseCode) {
+    out.field("deptCode", deptCode).field("courseCode", courseCode);
+}
+
+// Utility function to build the entity tag of a response from the version of what it
+// shows; versions start over when the mapping is replaced, so the generation is part of
+// it, and the JSON form of a response is tagged apart from the text form
+std::string makeETag(const MyFileDatabase* database, uint64_t version, bool json) {
+    return "\"" + std::to_string(database->getMappingGeneration()) + "-" + std::to_string(version) +
+           (json ? "j\"" : "\"");
+}
+
+// Utility function to tag a response and answer 304 Not Modified, with no body, if the
+// tag is one of those in the request's If-None-Match header
+bool notModified(const crow::request& req, crow::response& res, const std::string& etag) {
+    res.set_header("ETag", etag);
+    res.set_header("Vary", "Accept");
+    const std::string& ifNoneMatch = req.get_header_value("If-None-Match");
+    size_t start = 0;
+    while (start < ifNoneMatch.size()) {
+        size_t comma = ifNoneMatch.find(',', start);
+        if (comma == std::string::npos) {
+            comma = ifNoneMatch.size();
+        }
+        size_t first = ifNoneMatch.find_first_not_of(" \t", start);
+        size_t last = ifNoneMatch.find_last_not_of(" \t", comma - 1);
+        if (first != std::string::npos && first < comma && last >= first) {
+            if (ifNoneMatch.compare(first, 2, "W/") == 0) {
+                first += 2;
+            }
+            if (ifNoneMatch.compare(first, last + 1 - first, "*") == 0 ||
+                ifNoneMatch.compare(first, last + 1 - first, etag) == 0) {
+                res.code = 304;
+                return true;
+            }
+        }
+        start = comma + 1;
+    }
+    return false;
+}
+
+// Utility function to turn the outcome of a committed mutation into a response
+void writeMutationResponse(MutationResult result, crow::response& res, const std::string& successMessage,
+                           const std::string& rejectedMessage = "") {
+    switch (result) {
+        case MutationResult::Applied:
+        case MutationResult::Unchanged:
+            res.code = 200;
+            res.write(successMessage);
+            break;
+        case MutationResult::Rejected:
+            res.code = 400;
+            res.write(rejectedMessage);
+            break;
+        case MutationResult::DepartmentNotFound:
+            res.code = 404;
+            res.write("Department Not Found");
+            break;
+        case MutationResult::CourseNotFound:
+            res.code = 404;
+            res.write("Course Not Found");
+            break;
+    }
+}
+
+// Utility function to list the courses found through one of the course indexes
+void writeCourseList(const std::vector<CourseRef>& courses, crow::response& res, bool json) {
+    if (courses.empty()) {
+        writeError(res, 404, "No Courses Found", json);
+        return;
+    }
+    res.code = 200;
+    if (json) {
+        JsonWriter out = jsonBody(res);
+        out.beginObject().key("courses").beginArray();
+        for (const CourseRef& ref : courses) {
+            out.beginObject().field("deptCode", ref.deptCode).field("courseCode", ref.courseId);
+            ref.course->writeJsonFields(out);
+            out.endObject();
+        }
+        out.endArray().endObject();
+        return;
+    }
+    std::string result;
+    for (const CourseRef& ref : courses) {
+        result += ref.deptCode + " " + ref.courseId + ": " + ref.course->display() + "\n";
+    }
+    res.write(result);
+}
+
+// Utility function to answer a lookup through one of the course attribute indexes
+void writeCourseList(MyFileDatabase* database, CourseAttributeIndex::Attribute attribute, const char* value,
+                     const std::string& parameter, const crow::request& req, crow::response& res) {
+    bool json = wantsJson(req);
+    if (value == nullptr) {
+        writeError(res, 400, "Missing " + parameter, json);
+        return;
+    }
+    if (notModified(req, res, makeETag(database, database->getVersion(), json))) {
+        return;
+    }
+    writeCourseList(database->findCoursesBy(attribute, value), res, json);
+}
+
+// Fields /retrieveCourses can show for each course, in the order they are shown
+const char* const kCourseFields[] = {"details", "location", "time", "instructor", "full"};
+const int kCourseFieldCount = 5;
+const size_t kMaxBatchCourses = 200;
+const size_t kMaxBatchChanges = 10000;
+
+// Utility function to read a comma separated list, skipping empty items
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) {
+            comma = text.size();
+        }
+        if (comma > start) {
+            items.push_back(text.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return items;
+}
+
+// Utility function to read a course code of up to nine digits
+bool parseCourseNumber(const std::string& text, int& number) {
+    if (text.empty() || text.size() > 9) {
+        return false;
+    }
+    number = 0;
+    for (char digit : text) {
+        if (digit < '0' || digit > '9') {
+            return false;
+        }
+        number = number * 10 + (digit - '0');
+    }
+    return true;
+}
+
+// Utility function to read a DEPT:courseCode item of a /retrieveCourses batch
+bool parseCourseItem(const std::string& item, CourseLookup& lookup) {
+    size_t colon = item.find(':');
+    int number;
+    if (colon == std::string::npos || colon == 0 || !parseCourseNumber(item.substr(colon + 1), number)) {
+        return false;
+    }
+    lookup = CourseLookup{item.substr(0, colon), number, nullptr, nullptr};
+    return true;
+}
+
+// Utility function to read one line of a /batchUpdate body, written as the path and
+// query string of the route that makes the change alone
+bool parseChangeLine(const std::string& line, MutationRecord& record) {
+    static const struct {
+        const char* path;
+        MutationType type;
+        const char* parameter;
+    } kChanges[] = {
+        {"changeCourseLocation", MutationType::SetCourseLocation, "location"},
+        {"changeCourseTeacher", MutationType::SetCourseInstructor, "instructor"},
+        {"changeCourseTime", MutationType::SetCourseTime, "time"},
+        {"setEnrollmentCount", MutationType::SetEnrollmentCount, "count"},
+    };
+    size_t query = line.find('?');
+    if (query == std::string::npos) {
+        return false;
+    }
+    std::string path = line.substr(line[0] == '/' ? 1 : 0, query - (line[0] == '/' ? 1 : 0));
+    crow::query_string params(line);
+    auto deptCode = params.get("deptCode");
+    auto courseCode = params.get("courseCode");
+    int number;
+    if (deptCode == nullptr || courseCode == nullptr || !parseCourseNumber(courseCode, number)) {
+        return false;
+    }
+    for (const auto& change : kChanges) {
+        auto value = params.get(change.parameter);
+        if (path != change.path || value == nullptr) {
+            continue;
+        }
+        record = MutationRecord::forCourse(change.type, deptCode, std::to_string(number));
+        if (change.type != MutationType::SetEnrollmentCount) {
+            record.text = value;
+            return true;
+        }
+        char* end;
+        long count = std::strtol(value, &end, 10);
+        record.value = static_cast<int32_t>(count);
+        return *value != '\0' && *end == '\0' && count >= 0 && count <= INT32_MAX;
+    }
+    return false;
+}
+
 /**
  * Redirects to the homepage.
  *
@@ -43,15 +272,19 @@ void RouteController::index(crow::response& res) {
 void RouteController::retrieveDepartment(const crow::request& req, crow::response& res) {
     try {
         auto deptCode = req.url_params.get("deptCode");
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
+        auto dept = myFileDatabase->findDepartment(deptCode);
+        bool json = wantsJson(req);
 
-        auto it = departmentMapping.find(deptCode);
-        if (it == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
+        if (dept == nullptr) {
+            writeError(res, 404, "Department Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, dept->getVersion(), json))) {
             res.code = 200;
-            res.write(it->second.display()); // Use dot operator to access method
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                dept->writeJson(out);
+            } else {
+                res.write(*dept->displayText());
+            }
         }
         res.end();
     } catch (const std::exception& e) {
@@ -77,23 +310,23 @@ void RouteController::retrieveCourse(const crow::request& req, crow::response& r
     try {
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        Course* course = myFileDatabase->findCourse(deptCode, courseCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
+        if (course == nullptr) {
+            writeError(res, 404, myFileDatabase->findDepartment(deptCode) == nullptr ? "Department Not Found"
+                                                                                     : "Course Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, course->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                out.beginObject();
+                writeCourseKey(out, deptCode, req.url_params.get("courseCode"));
+                course->writeJsonFields(out);
+                out.endObject();
             } else {
-                res.code = 200;
-                res.write(courseIt->second->display()); // Use dot operator to access method
+                res.write(*course->displayText());
             }
         }
         res.end();
@@ -119,24 +352,23 @@ void RouteController::isCourseFull(const crow::request& req, crow::response& res
     try {
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
+        Course* course = myFileDatabase->findCourse(deptCode, courseCode);
 
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
+        if (course == nullptr) {
+            writeError(res, 404, myFileDatabase->findDepartment(deptCode) == nullptr ? "Department Not Found"
+                                                                                     : "Course Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, course->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                out.beginObject();
+                writeCourseKey(out, deptCode, req.url_params.get("courseCode"));
+                out.field("full", course->isCourseFull());
+                out.endObject();
             } else {
-                auto course = courseIt->second;
-                res.code = 200;
-                res.write(course->isCourseFull() ? "true" : "false"); // Use dot operator to call method
+                res.write(course->isCourseFull() ? "true" : "false");
             }
         }
         res.end();
@@ -158,16 +390,73 @@ void RouteController::isCourseFull(const crow::request& req, crow::response& res
 void RouteController::getMajorCountFromDept(const crow::request& req, crow::response& res) {
     try {
         auto deptCode = req.url_params.get("deptCode");
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        auto dept = myFileDatabase->findDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
+        if (dept == nullptr) {
+            writeError(res, 404, "Department Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, dept->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                jsonBody(res)
+                    .beginObject()
+                    .field("deptCode", deptCode)
+                    .field("majors", dept->getNumberOfMajors())
+                    .endObject();
+            } else {
+                res.write("There are: " + std::to_string(dept->getNumberOfMajors()) + " majors in the department");
+            }
+        }
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays the number of courses, seats, enrolled students and full courses in the
+ * specified department, and the share of its seats taken, from the department's
+ * running totals.
+ *
+ * @param deptCode     A {@code string} representing the department the user wishes
+ *                     to find the totals for.
+ *
+ * @return             A crow::response object containing either one total per line for
+ *                     the specified department and an HTTP 200 response or, an
+ *                     appropriate message indicating the proper response.
+ */
+void RouteController::getDeptStats(const crow::request& req, crow::response& res) {
+    try {
+        auto deptCode = req.url_params.get("deptCode");
+        bool json = wantsJson(req);
+
+        auto dept = myFileDatabase->findDepartment(deptCode);
+
+        if (dept == nullptr) {
+            writeError(res, 404, "Department Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, dept->getVersion(), json))) {
+            DepartmentTotals::Values totals = dept->getCourseTotals();
             res.code = 200;
-            res.write("There are: " + std::to_string(deptIt->second.getNumberOfMajors()) + " majors in the department"); // Use dot operator to call method
+            if (json) {
+                jsonBody(res)
+                    .beginObject()
+                    .field("deptCode", deptCode)
+                    .field("courses", totals.courseCount)
+                    .field("seats", totals.seats)
+                    .field("enrolled", totals.enrolled)
+                    .field("fullCourses", totals.fullCourses)
+                    .field("fillRate", totals.getFillRate())
+                    .endObject();
+            } else {
+                char fillRate[16];
+                std::snprintf(fillRate, sizeof(fillRate), "%.1f%%", totals.getFillRate() * 100);
+                res.write("Courses: " + std::to_string(totals.courseCount) + "\n" +
+                          "Seats: " + std::to_string(totals.seats) + "\n" +
+                          "Enrolled: " + std::to_string(totals.enrolled) + "\n" +
+                          "Full courses: " + std::to_string(totals.fullCourses) + "\n" +
+                          "Fill rate: " + fillRate + "\n");
+            }
         }
         res.end();
     } catch (const std::exception& e) {
@@ -188,16 +477,23 @@ void RouteController::getMajorCountFromDept(const crow::request& req, crow::resp
 void RouteController::identifyDeptChair(const crow::request& req, crow::response& res) {
     try {
         auto deptCode = req.url_params.get("deptCode");
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        auto dept = myFileDatabase->findDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
+        if (dept == nullptr) {
+            writeError(res, 404, "Department Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, dept->getVersion(), json))) {
             res.code = 200;
-            res.write(deptIt->second.getDepartmentChair() + " is the department chair."); // Use dot operator to call method
+            if (json) {
+                jsonBody(res)
+                    .beginObject()
+                    .field("deptCode", deptCode)
+                    .field("chair", dept->getDepartmentChair())
+                    .endObject();
+            } else {
+                res.write(dept->getDepartmentChair() + " is the department chair.");
+            }
         }
         res.end();
     } catch (const std::exception& e) {
@@ -222,24 +518,23 @@ void RouteController::findCourseLocation(const crow::request& req, crow::respons
     try {
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        Course* course = myFileDatabase->findCourse(deptCode, courseCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
+        if (course == nullptr) {
+            writeError(res, 404, myFileDatabase->findDepartment(deptCode) == nullptr ? "Department Not Found"
+                                                                                     : "Course Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, course->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                out.beginObject();
+                writeCourseKey(out, deptCode, req.url_params.get("courseCode"));
+                out.field("location", *course->getInternedStrings().courseLocation);
+                out.endObject();
             } else {
-                auto course = courseIt->second;
-                res.code = 200;
-                res.write(course->getCourseLocation() + " is where the course is located."); // Use dot operator to call method
+                res.write(course->getCourseLocation() + " is where the course is located.");
             }
         }
         res.end();
@@ -265,24 +560,23 @@ void RouteController::findCourseInstructor(const crow::request& req, crow::respo
     try {
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        Course* course = myFileDatabase->findCourse(deptCode, courseCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
+        if (course == nullptr) {
+            writeError(res, 404, myFileDatabase->findDepartment(deptCode) == nullptr ? "Department Not Found"
+                                                                                     : "Course Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, course->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                out.beginObject();
+                writeCourseKey(out, deptCode, req.url_params.get("courseCode"));
+                out.field("instructor", *course->getInternedStrings().instructorName);
+                out.endObject();
             } else {
-                auto course = courseIt->second;
-                res.code = 200;
-                res.write(course->getInstructorName() + " is the instructor for the course."); // Use dot operator to call method
+                res.write(course->getInstructorName() + " is the instructor for the course.");
             }
         }
         res.end();
@@ -308,26 +602,220 @@ void RouteController::findCourseTime(const crow::request& req, crow::response& r
     try {
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
+        bool json = wantsJson(req);
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        Course* course = myFileDatabase->findCourse(deptCode, courseCode);
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
+        if (course == nullptr) {
+            writeError(res, 404, myFileDatabase->findDepartment(deptCode) == nullptr ? "Department Not Found"
+                                                                                     : "Course Not Found", json);
+        } else if (!notModified(req, res, makeETag(myFileDatabase, course->getVersion(), json))) {
+            res.code = 200;
+            if (json) {
+                JsonWriter out = jsonBody(res);
+                out.beginObject();
+                writeCourseKey(out, deptCode, req.url_params.get("courseCode"));
+                out.field("time", *course->getInternedStrings().courseTimeSlot);
+                out.endObject();
             } else {
-                auto course = courseIt->second;
-                res.code = 200;
-                res.write("The course meets at: " + course->getCourseTimeSlot()); 
+                res.write("The course meets at: " + course->getCourseTimeSlot());
+            }
+        }
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays several courses at once, for pages that would otherwise make one request per
+ * course and field. Every course is looked up in a single pass over the store.
+ *
+ * @param courses    A {@code string} listing the courses as comma separated
+ *                   deptCode:courseCode pairs, such as COMS:4156,PHYS:1221.
+ *
+ * @param fields     An optional {@code string} listing the fields to show for each
+ *                   course, comma separated, out of details, location, time,
+ *                   instructor and full. Only details are shown by default.
+ *
+ * @return           A crow::response object containing, for every course in the order
+ *                   asked, a line naming the course followed by one line per field, or
+ *                   an error line if the department or course does not exist, and an
+ *                   HTTP 200 response or, an HTTP 400 response if the list cannot be
+ *                   read.
+ */
+void RouteController::retrieveCourses(const crow::request& req, crow::response& res) {
+    try {
+        auto courses = req.url_params.get("courses");
+        auto fields = req.url_params.get("fields");
+        bool json = wantsJson(req);
+        if (courses == nullptr) {
+            writeError(res, 400, "Missing courses", json);
+            res.end();
+            return;
+        }
+
+        bool wanted[kCourseFieldCount] = {fields == nullptr};
+        for (const std::string& field : splitList(fields != nullptr ? fields : "")) {
+            int f = 0;
+            while (f < kCourseFieldCount && field != kCourseFields[f]) {
+                ++f;
+            }
+            if (f == kCourseFieldCount) {
+                writeError(res, 400, "Invalid field: " + field, json);
+                res.end();
+                return;
+            }
+            wanted[f] = true;
+        }
+
+        std::vector<std::string> items = splitList(courses);
+        if (items.empty() || items.size() > kMaxBatchCourses) {
+            writeError(res, 400, items.empty() ? "Missing courses" : "Too many courses", json);
+            res.end();
+            return;
+        }
+        std::vector<CourseLookup> lookups(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!parseCourseItem(items[i], lookups[i])) {
+                writeError(res, 400, "Invalid course: " + items[i], json);
+                res.end();
+                return;
+            }
+        }
+        myFileDatabase->findCourses(lookups);
+        // each version only grows, so the sum moves on whenever any of the courses changes
+        uint64_t version = 0;
+        for (const CourseLookup& lookup : lookups) {
+            version += lookup.course != nullptr ? lookup.course->getVersion() : 0;
+        }
+        if (notModified(req, res, makeETag(myFileDatabase, version, json))) {
+            res.end();
+            return;
+        }
+
+        res.code = 200;
+        if (json) {
+            JsonWriter out = jsonBody(res);
+            out.beginObject().key("courses").beginArray();
+            for (size_t i = 0; i < lookups.size(); ++i) {
+                const CourseLookup& lookup = lookups[i];
+                out.beginObject().field("deptCode", lookup.deptCode);
+                out.field("courseCode", items[i].c_str() + lookup.deptCode.size() + 1);
+                if (lookup.course == nullptr) {
+                    out.field("error", lookup.department == nullptr ? "Department Not Found" : "Course Not Found");
+                } else {
+                    // details stand for the instructor, location and time together
+                    Course::InternedStrings strings = lookup.course->getInternedStrings();
+                    if (wanted[0] || wanted[3]) {
+                        out.field("instructor", *strings.instructorName);
+                    }
+                    if (wanted[0] || wanted[1]) {
+                        out.field("location", *strings.courseLocation);
+                    }
+                    if (wanted[0] || wanted[2]) {
+                        out.field("time", *strings.courseTimeSlot);
+                    }
+                    if (wanted[4]) {
+                        out.field("full", lookup.course->isCourseFull());
+                    }
+                }
+                out.endObject();
+            }
+            out.endArray().endObject();
+            res.end();
+            return;
+        }
+        std::string result;
+        for (size_t i = 0; i < lookups.size(); ++i) {
+            const CourseLookup& lookup = lookups[i];
+            result += lookup.deptCode + " " + items[i].substr(lookup.deptCode.size() + 1) + "\n";
+            if (lookup.course == nullptr) {
+                result += lookup.department == nullptr ? "error: Department Not Found\n" : "error: Course Not Found\n";
+                continue;
+            }
+            if (wanted[0]) {
+                result += "details: " + lookup.course->display().substr(1) + "\n";
+            }
+            if (wanted[1]) {
+                result += "location: " + lookup.course->getCourseLocation() + "\n";
+            }
+            if (wanted[2]) {
+                result += "time: " + lookup.course->getCourseTimeSlot() + "\n";
+            }
+            if (wanted[3]) {
+                result += "instructor: " + lookup.course->getInstructorName() + "\n";
+            }
+            if (wanted[4]) {
+                result += std::string("full: ") + (lookup.course->isCourseFull() ? "true" : "false") + "\n";
             }
         }
+        res.write(result);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Makes many course changes at once, all or nothing, for term setup that would
+ * otherwise send thousands of single changes. Every change is checked before any is
+ * made, and the batch is logged as one.
+ *
+ * @param body       A {@code string} holding one change per line, written as the
+ *                   path and query string of the route that makes it alone:
+ *                   changeCourseLocation, changeCourseTeacher, changeCourseTime or
+ *                   setEnrollmentCount, such as
+ *                   /setEnrollmentCount?deptCode=COMS&courseCode=4156&count=100.
+ *
+ * @return           A crow::response object containing the number of changes made
+ *                   and an HTTP 200 response or, a message naming the line that
+ *                   stopped the batch and the proper status code, in which case
+ *                   nothing was changed.
+ */
+void RouteController::batchUpdate(const crow::request& req, crow::response& res) {
+    try {
+        std::vector<MutationRecord> records;
+        std::vector<size_t> lineNumbers;
+        size_t start = 0;
+        for (size_t lineNumber = 1; start < req.body.size(); ++lineNumber) {
+            size_t newline = req.body.find('\n', start);
+            if (newline == std::string::npos) {
+                newline = req.body.size();
+            }
+            std::string line = req.body.substr(start, newline - start);
+            start = newline + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            MutationRecord record;
+            if (!parseChangeLine(line, record)) {
+                res.code = 400;
+                res.write("Line " + std::to_string(lineNumber) + ": Invalid change");
+                res.end();
+                return;
+            }
+            records.push_back(record);
+            lineNumbers.push_back(lineNumber);
+        }
+        if (records.empty() || records.size() > kMaxBatchChanges) {
+            res.code = 400;
+            res.write(records.empty() ? "Missing changes" : "Too many changes");
+            res.end();
+            return;
+        }
+
+        BatchResult result = myFileDatabase->commitMutations(records);
+        if (result.result == MutationResult::Applied) {
+            res.code = 200;
+            res.write(std::to_string(records.size()) + " changes applied");
+        } else {
+            res.write("Line " + std::to_string(lineNumbers[result.failedIndex]) + ": ");
+            writeMutationResponse(result.result, res, "", "Room is already in use at that time");
+        }
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -347,17 +835,8 @@ void RouteController::addMajorToDept(const crow::request& req, crow::response& r
     try {
         auto deptCode = req.url_params.get("deptCode");
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            deptIt->second.addPersonToMajor(); // Use dot operator to call method
-            res.code = 200;
-            res.write("Attribute was updated successfully");
-        }
+        auto result = myFileDatabase->commitMutation(MutationRecord::forDepartment(MutationType::AddMajor, deptCode));
+        writeMutationResponse(result, res, "Attribute was updated successfully");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -371,25 +850,9 @@ void RouteController::setEnrollmentCount(const crow::request& req, crow::respons
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
         auto count = std::stoi(req.url_params.get("count"));
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->setEnrolledStudentCount(count);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
-        }
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::SetEnrollmentCount, deptCode, std::to_string(courseCode), count));
+        writeMutationResponse(result, res, "Attribute was updated successfully.");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -403,25 +866,10 @@ void RouteController::setCourseLocation(const crow::request& req, crow::response
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
         auto location = req.url_params.get("location");
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignLocation(location);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
-        }
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::SetCourseLocation, deptCode, std::to_string(courseCode), 0, location));
+        writeMutationResponse(result, res, "Attribute was updated successfully.",
+                              "Room is already in use at that time");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -435,26 +883,10 @@ void RouteController::setCourseInstructor(const crow::request& req, crow::respon
         auto instructor = req.url_params.get("instructor");
 
         int courseCode = std::stoi(courseCodeStr);
-    
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignInstructor(instructor);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
-        }
+
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::SetCourseInstructor, deptCode, std::to_string(courseCode), 0, instructor));
+        writeMutationResponse(result, res, "Attribute was updated successfully.");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -468,25 +900,10 @@ void RouteController::setCourseTime(const crow::request& req, crow::response& re
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
         auto time = req.url_params.get("time");
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignTime(time);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
-        }
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::SetCourseTime, deptCode, std::to_string(courseCode), 0, time));
+        writeMutationResponse(result, res, "Attribute was updated successfully.",
+                              "Room is already in use at that time");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -507,17 +924,35 @@ void RouteController::removeMajorFromDept(const crow::request& req, crow::respon
     try {
         auto deptCode = req.url_params.get("deptCode");
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        auto result = myFileDatabase->commitMutation(MutationRecord::forDepartment(MutationType::RemoveMajor, deptCode));
+        writeMutationResponse(result, res, "Attribute was updated successfully");
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            deptIt->second.dropPersonFromMajor();
-            res.code = 200;
-            res.write("Attribute was updated successfully");
-        }
+/**
+ * Attempts to enroll a student in the specified course. Enrollment never takes the
+ * course beyond its capacity, even under concurrent requests.
+ *
+ * @param deptCode       A {@code String} representing the department.
+ *
+ * @param courseCode     A {@code int} representing the course the user wishes
+ *                       to enroll in.
+ *
+ * @return               A crow::response object containing an HTTP 200
+ *                       response with an appropriate message or the proper status
+ *                       code in tune with what has happened.
+ */
+void RouteController::enrollStudentInCourse(const crow::request& req, crow::response& res) {
+    try {
+        auto deptCode = req.url_params.get("deptCode");
+        auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::EnrollStudent, deptCode, std::to_string(courseCode)));
+        writeMutationResponse(result, res, "Student has been enrolled", "Student has not been enrolled");
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -541,30 +976,342 @@ void RouteController::dropStudentFromCourse(const crow::request& req, crow::resp
         auto deptCode = req.url_params.get("deptCode");
         auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        auto result = myFileDatabase->commitMutation(MutationRecord::forCourse(
+            MutationType::DropStudent, deptCode, std::to_string(courseCode)));
+        writeMutationResponse(result, res, "Student has been dropped", "Student has not been dropped");
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
 
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
+/**
+ * Lists the courses passing every condition in the query string, such as
+ * {@code capacity>100&fill>0.9&dept=COMS}.
+ *
+ * @param conditions     Any number of conditions of the form column, comparison,
+ *                       value. Number columns are capacity, enrolled and fill
+ *                       (enrolled / capacity) and take <, <=, =, >= or >; dept,
+ *                       location, instructor and time only take =.
+ *
+ * @return               A crow::response object containing the matching courses,
+ *                       one per line, and an HTTP 200 response or, an HTTP 400
+ *                       response naming a condition that cannot be read.
+ */
+void RouteController::queryCourses(const crow::request& req, crow::response& res) {
+    try {
+        std::vector<CourseColumns::Condition> conditions;
+        bool json = wantsJson(req);
+        for (const std::string& key : req.url_params.keys()) {
+            if (key == "format") {
+                continue;
+            }
+            std::string value = req.url_params.get(key);
+            std::string text = value.empty() ? key : key + "=" + value;
+            CourseColumns::Condition condition;
+            if (!CourseColumns::Condition::parse(text, condition)) {
+                writeError(res, 400, "Invalid condition: " + text, json);
+                res.end();
+                return;
+            }
+            conditions.push_back(condition);
+        }
+        if (notModified(req, res, makeETag(myFileDatabase, myFileDatabase->getVersion(), json))) {
+            res.end();
+            return;
+        }
+
+        std::vector<CourseMatch> matches = myFileDatabase->queryCourses(conditions);
+        res.code = 200;
+        if (json) {
+            JsonWriter out = jsonBody(res);
+            out.beginObject().field("count", matches.size()).key("courses").beginArray();
+            for (const CourseMatch& match : matches) {
+                out.beginObject()
+                    .field("deptCode", match.deptCode)
+                    .field("courseCode", match.courseId)
+                    .field("enrolled", match.enrolledStudentCount)
+                    .field("capacity", match.enrollmentCapacity)
+                    .endObject();
+            }
+            out.endArray().endObject();
+            res.end();
+            return;
+        }
+        std::string result = std::to_string(matches.size()) + " matching courses\n";
+        for (const CourseMatch& match : matches) {
+            result += match.deptCode + " " + match.courseId + ": " + std::to_string(match.enrolledStudentCount) +
+                      "/" + std::to_string(match.enrollmentCapacity) + " enrolled\n";
+        }
+        res.write(result);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists every course taught by the specified instructor.
+ *
+ * @param instructor     A {@code string} naming the instructor.
+ *
+ * @return               A crow::response object containing the courses, one per
+ *                       line as retrieveDept shows them, and an HTTP 200 response
+ *                       or, an appropriate message indicating the proper response.
+ */
+void RouteController::findCoursesByInstructor(const crow::request& req, crow::response& res) {
+    try {
+        writeCourseList(myFileDatabase, CourseAttributeIndex::Attribute::Instructor,
+                        req.url_params.get("instructor"), "instructor", req, res);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists every course held in the specified location.
+ *
+ * @param location       A {@code string} naming the room.
+ *
+ * @return               A crow::response object containing the courses, one per
+ *                       line as retrieveDept shows them, and an HTTP 200 response
+ *                       or, an appropriate message indicating the proper response.
+ */
+void RouteController::findCoursesByLocation(const crow::request& req, crow::response& res) {
+    try {
+        writeCourseList(myFileDatabase, CourseAttributeIndex::Attribute::Location,
+                        req.url_params.get("location"), "location", req, res);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists every course meeting at the specified time slot.
+ *
+ * @param time           A {@code string} giving the time slot, such as 10:10-11:25.
+ *
+ * @return               A crow::response object containing the courses, one per
+ *                       line as retrieveDept shows them, and an HTTP 200 response
+ *                       or, an appropriate message indicating the proper response.
+ */
+void RouteController::findCoursesByTime(const crow::request& req, crow::response& res) {
+    try {
+        writeCourseList(myFileDatabase, CourseAttributeIndex::Attribute::TimeSlot,
+                        req.url_params.get("time"), "time", req, res);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Suggests instructors for a partly typed or misspelled name, such as Kais or Borowsk,
+ * for a search box that asks again on every keystroke.
+ *
+ * @param q              A {@code string} giving the text typed so far.
+ *
+ * @param limit          An optional {@code int} giving the most instructors to list,
+ *                       10 by default and at most 100.
+ *
+ * @return               A crow::response object containing the instructors, best
+ *                       match first, one per line with the number of courses they
+ *                       teach, and an HTTP 200 response or, an HTTP 400 response if
+ *                       the query is missing or the limit is invalid.
+ */
+void RouteController::searchInstructors(const crow::request& req, crow::response& res) {
+    try {
+        auto query = req.url_params.get("q");
+        auto limit = req.url_params.get("limit");
+        bool json = wantsJson(req);
+        if (query == nullptr || std::string(query).empty()) {
+            writeError(res, 400, "Missing q", json);
+            res.end();
+            return;
+        }
+        int count = 10;
+        if (limit != nullptr && !parseCourseNumber(limit, count)) {
+            count = 0;
+        }
+        if (count < 1 || count > 100) {
+            writeError(res, 400, "Invalid limit", json);
+            res.end();
+            return;
+        }
+        if (notModified(req, res, makeETag(myFileDatabase, myFileDatabase->getVersion(), json))) {
+            res.end();
+            return;
+        }
+
+        auto hits = myFileDatabase->searchValues(CourseAttributeIndex::Attribute::Instructor, query,
+                                                 static_cast<size_t>(count));
+        res.code = 200;
+        if (json) {
+            JsonWriter out = jsonBody(res);
+            out.beginObject().key("instructors").beginArray();
+            for (const auto& hit : hits) {
+                out.beginObject().field("name", hit.value).field("courses", hit.courseCount).endObject();
+            }
+            out.endArray().endObject();
+            res.end();
+            return;
+        }
+        std::string result;
+        for (const auto& hit : hits) {
+            result += hit.value + ": " + std::to_string(hit.courseCount) +
+                      (hit.courseCount == 1 ? " course\n" : " courses\n");
+        }
+        res.write(result);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists every course that meets during any part of the specified range of the day.
+ *
+ * @param start          A {@code string} giving the start of the range, such as 10:00.
+ *
+ * @param end            A {@code string} giving the end of the range, such as 12:00.
+ *                       Hours 1 to 7 are read as afternoon and evening hours.
+ *
+ * @return               A crow::response object containing the courses, one per
+ *                       line as retrieveDept shows them, and an HTTP 200 response
+ *                       or, an appropriate message indicating the proper response.
+ */
+void RouteController::findCoursesMeetingBetween(const crow::request& req, crow::response& res) {
+    try {
+        auto start = req.url_params.get("start");
+        auto end = req.url_params.get("end");
+        bool json = wantsJson(req);
+        int startMinutes = 0;
+        int endMinutes = 0;
+        if (start == nullptr || end == nullptr || !TimeInterval::parseClock(start, startMinutes) ||
+            !TimeInterval::parseClock(end, endMinutes) || endMinutes <= startMinutes) {
+            writeError(res, 400, "Invalid time range", json);
+            res.end();
+            return;
+        }
+
+        if (!notModified(req, res, makeETag(myFileDatabase, myFileDatabase->getVersion(), json))) {
+            TimeInterval range{static_cast<int16_t>(startMinutes), static_cast<int16_t>(endMinutes)};
+            writeCourseList(myFileDatabase->findCoursesMeeting(range), res, json);
+        }
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists the rooms that no course holds at the specified time, or during the specified
+ * range of the day.
+ *
+ * @param time           A {@code string} giving a time such as 10:30, or
+ *
+ * @param start, end     {@code string}s giving a range such as 10:00 and 12:00.
+ *                       Hours 1 to 7 are read as afternoon and evening hours.
+ *
+ * @return               A crow::response object containing the free rooms, one per
+ *                       line, and an HTTP 200 response or, an HTTP 400 response if
+ *                       the time cannot be read.
+ */
+void RouteController::findFreeRooms(const crow::request& req, crow::response& res) {
+    try {
+        auto time = req.url_params.get("time");
+        auto start = time != nullptr ? time : req.url_params.get("start");
+        auto end = req.url_params.get("end");
+        bool json = wantsJson(req);
+        int startMinutes = 0;
+        int endMinutes = 0;
+        bool valid = start != nullptr && TimeInterval::parseClock(start, startMinutes);
+        if (time != nullptr) {
+            endMinutes = startMinutes + 1;
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(std::to_string(courseCode));
+            valid = valid && end != nullptr && TimeInterval::parseClock(end, endMinutes) && endMinutes > startMinutes;
+        }
+        if (!valid) {
+            writeError(res, 400, "Invalid time range", json);
+            res.end();
+            return;
+        }
 
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
-            } else {
-                bool isStudentDropped = courseIt->second->dropStudent();
-                if (isStudentDropped) {
-                    res.code = 200;
-                    res.write("Student has been dropped"); 
-                } else {
-                    res.code = 400;
-                    res.write("Student has not been dropped"); 
-                }
+        if (notModified(req, res, makeETag(myFileDatabase, myFileDatabase->getVersion(), json))) {
+            res.end();
+            return;
+        }
+
+        TimeInterval range{static_cast<int16_t>(startMinutes), static_cast<int16_t>(endMinutes)};
+        std::vector<std::string> rooms = myFileDatabase->findFreeRooms(range);
+        res.code = 200;
+        if (json) {
+            JsonWriter out = jsonBody(res);
+            out.beginObject().key("rooms").beginArray();
+            for (const std::string& room : rooms) {
+                out.value(room);
             }
+            out.endArray().endObject();
+            res.end();
+            return;
         }
+        std::string result;
+        for (const std::string& room : rooms) {
+            result += room + "\n";
+        }
+        res.write(result);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Lists the courses that are full, in the whole catalog or in one department, without
+ * asking each course whether it is full.
+ *
+ * @param deptCode       An optional {@code string} naming the department to list.
+ *
+ * @return               A crow::response object containing the number of full
+ *                       courses, then one per line, and an HTTP 200 response or, an
+ *                       HTTP 404 response if the department does not exist.
+ */
+void RouteController::findFullCourses(const crow::request& req, crow::response& res) {
+    try {
+        auto deptCode = req.url_params.get("deptCode");
+        bool json = wantsJson(req);
+        const Department* dept = deptCode != nullptr ? myFileDatabase->findDepartment(deptCode) : nullptr;
+        if (deptCode != nullptr && dept == nullptr) {
+            writeError(res, 404, "Department Not Found", json);
+            res.end();
+            return;
+        }
+        uint64_t version = dept != nullptr ? dept->getVersion() : myFileDatabase->getVersion();
+        if (notModified(req, res, makeETag(myFileDatabase, version, json))) {
+            res.end();
+            return;
+        }
+
+        std::vector<CourseRef> full = deptCode != nullptr ? myFileDatabase->findFullCourses(deptCode)
+                                                          : myFileDatabase->findFullCourses();
+        res.code = 200;
+        if (json) {
+            JsonWriter out = jsonBody(res);
+            out.beginObject().field("count", full.size()).key("courses").beginArray();
+            for (const CourseRef& course : full) {
+                out.beginObject().field("deptCode", course.deptCode).field("courseCode", course.courseId).endObject();
+            }
+            out.endArray().endObject();
+            res.end();
+            return;
+        }
+        std::string result = std::to_string(full.size()) + " full courses\n";
+        for (const CourseRef& course : full) {
+            result += course.deptCode + " " + course.courseId + "\n";
+        }
+        res.write(result);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -598,6 +1345,11 @@ void RouteController::initRoutes(crow::App<>& app) {
             getMajorCountFromDept(req, res);
         });
 
+    CROW_ROUTE(app, "/deptStats")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            getDeptStats(req, res);
+        });
+
     CROW_ROUTE(app, "/idDeptChair")
         .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
             identifyDeptChair(req, res);
@@ -618,6 +1370,11 @@ void RouteController::initRoutes(crow::App<>& app) {
             findCourseTime(req, res);
         });
 
+    CROW_ROUTE(app, "/retrieveCourses")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveCourses(req, res);
+        });
+
     CROW_ROUTE(app, "/addMajorToDept")
         .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
             addMajorToDept(req, res);
@@ -647,6 +1404,61 @@ void RouteController::initRoutes(crow::App<>& app) {
         .methods(crow::HTTPMethod::PATCH)([this](const crow::request& req, crow::response& res) {
             setEnrollmentCount(req, res);
         });
+
+    CROW_ROUTE(app, "/enrollStudentInCourse")
+        .methods(crow::HTTPMethod::PATCH)([this](const crow::request& req, crow::response& res) {
+            enrollStudentInCourse(req, res);
+        });
+
+    CROW_ROUTE(app, "/dropStudentFromCourse")
+        .methods(crow::HTTPMethod::PATCH)([this](const crow::request& req, crow::response& res) {
+            dropStudentFromCourse(req, res);
+        });
+
+    CROW_ROUTE(app, "/batchUpdate")
+        .methods(crow::HTTPMethod::PATCH)([this](const crow::request& req, crow::response& res) {
+            batchUpdate(req, res);
+        });
+
+    CROW_ROUTE(app, "/queryCourses")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            queryCourses(req, res);
+        });
+
+    CROW_ROUTE(app, "/coursesByInstructor")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findCoursesByInstructor(req, res);
+        });
+
+    CROW_ROUTE(app, "/coursesByLocation")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findCoursesByLocation(req, res);
+        });
+
+    CROW_ROUTE(app, "/coursesByTime")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findCoursesByTime(req, res);
+        });
+
+    CROW_ROUTE(app, "/searchInstructors")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            searchInstructors(req, res);
+        });
+
+    CROW_ROUTE(app, "/coursesMeetingBetween")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findCoursesMeetingBetween(req, res);
+        });
+
+    CROW_ROUTE(app, "/freeRooms")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findFreeRooms(req, res);
+        });
+
+    CROW_ROUTE(app, "/fullCourses")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            findFullCourses(req, res);
+        });
 }
 
 void RouteController::setDatabase(MyFileDatabase *db) {
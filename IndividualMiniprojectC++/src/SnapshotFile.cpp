@@ -0,0 +1,382 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "SnapshotFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const char kMagic[] = "CRSSNAP2";
+const size_t kMagicSize = sizeof(kMagic) - 1;
+
+// Header: [magic][u64 lsn][u64 course table offset][u64 course count]
+//         [u64 department table offset][u64 department count]
+//         [u64 string pool offset][u64 string pool size]
+const size_t kHeaderSize = 64;
+const size_t kLsnAt = 8;
+const size_t kCourseTableAt = 16;
+const size_t kCourseCountAt = 24;
+const size_t kDepartmentTableAt = 32;
+const size_t kDepartmentCountAt = 40;
+const size_t kStringsAt = 48;
+const size_t kStringsSizeAt = 56;
+
+// A string reference is [u32 offset into the pool][u32 length].
+const size_t kStringRefSize = 8;
+
+// Department record: [key][deptCode][chair][i32 majors][u32 course count][u64 first course]
+const size_t kDepartmentRecordSize = 40;
+const size_t kDeptKeyAt = 0;
+const size_t kDeptCodeAt = 8;
+const size_t kDeptChairAt = 16;
+const size_t kDeptMajorsAt = 24;
+const size_t kDeptCourseCountAt = 28;
+const size_t kDeptFirstCourseAt = 32;
+
+// Course record: [courseId][i32 capacity][i32 enrolled][location][instructor][time slot]
+const size_t kCourseRecordSize = 40;
+const size_t kCourseIdAt = 0;
+const size_t kCourseCapacityAt = 8;
+const size_t kCourseEnrolledAt = 12;
+const size_t kCourseLocationAt = 16;
+const size_t kCourseInstructorAt = 24;
+const size_t kCourseTimeSlotAt = 32;
+
+const char kManifestMagic[] = "CRSMANI1";
+const size_t kManifestHeaderSize = 32;
+const size_t kManifestEntrySize = 16;
+
+template <typename T>
+T load(const char* at) {
+    T value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void store(char* at, T value) {
+    std::memcpy(at, &value, sizeof(value));
+}
+
+// Utility function to check that count records of the given size starting at offset
+// lie inside a file of the given size, without overflowing on corrupt values
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t recordSize, size_t size) {
+    return offset <= size && count <= (size - offset) / recordSize;
+}
+
+}  // namespace
+
+/**
+ * Maps a data file if it is in the version 2 format.
+ *
+ * @param filePath the path of the data file
+ * @return the mapped file, or nullptr if the file is missing or in the original format
+ * @throws std::runtime_error if the file claims to be version 2 but its sections do
+ *         not fit in it
+ */
+std::shared_ptr<const SnapshotFile> SnapshotFile::open(const std::string& filePath) {
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kHeaderSize) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    const char* data = static_cast<const char*>(mapped);
+    if (std::memcmp(data, kMagic, kMagicSize) != 0) {
+        ::munmap(mapped, size);
+        return nullptr;
+    }
+
+    if (!sectionFits(load<uint64_t>(data + kCourseTableAt), load<uint64_t>(data + kCourseCountAt), kCourseRecordSize,
+                     size) ||
+        !sectionFits(load<uint64_t>(data + kDepartmentTableAt), load<uint64_t>(data + kDepartmentCountAt),
+                     kDepartmentRecordSize, size) ||
+        !sectionFits(load<uint64_t>(data + kStringsAt), load<uint64_t>(data + kStringsSizeAt), 1, size)) {
+        ::munmap(mapped, size);
+        throw std::runtime_error("truncated data file " + filePath);
+    }
+    return std::shared_ptr<const SnapshotFile>(new SnapshotFile(data, size));
+}
+
+SnapshotFile::SnapshotFile(const char* data, size_t size) : data(data), size(size) {}
+
+SnapshotFile::~SnapshotFile() {
+    ::munmap(const_cast<char*>(data), size);
+}
+
+/**
+ * Gets the LSN of the last logged change included in the file.
+ */
+uint64_t SnapshotFile::getLsn() const {
+    return load<uint64_t>(data + kLsnAt);
+}
+
+size_t SnapshotFile::getDepartmentCount() const {
+    return load<uint64_t>(data + kDepartmentCountAt);
+}
+
+std::string SnapshotFile::getDepartmentKey(size_t dept) const {
+    return stringAt(departmentRecord(dept) + kDeptKeyAt);
+}
+
+std::string SnapshotFile::getDeptCode(size_t dept) const {
+    return stringAt(departmentRecord(dept) + kDeptCodeAt);
+}
+
+std::string SnapshotFile::getDepartmentChair(size_t dept) const {
+    return stringAt(departmentRecord(dept) + kDeptChairAt);
+}
+
+int SnapshotFile::getNumberOfMajors(size_t dept) const {
+    return load<int32_t>(departmentRecord(dept) + kDeptMajorsAt);
+}
+
+size_t SnapshotFile::getCourseCount(size_t dept) const {
+    return load<uint32_t>(departmentRecord(dept) + kDeptCourseCountAt);
+}
+
+std::string SnapshotFile::getCourseId(size_t dept, size_t course) const {
+    return stringAt(courseRecord(dept, course) + kCourseIdAt);
+}
+
+/**
+ * Reads every stored field of one course.
+ *
+ * @param dept   the index of the department
+ * @param course the index of the course within the department
+ * @return the course's fields
+ */
+Course::State SnapshotFile::getCourseState(size_t dept, size_t course) const {
+    const char* record = courseRecord(dept, course);
+    return Course::State{load<int32_t>(record + kCourseCapacityAt), load<int32_t>(record + kCourseEnrolledAt),
+                         stringAt(record + kCourseLocationAt), stringAt(record + kCourseInstructorAt),
+                         stringAt(record + kCourseTimeSlotAt)};
+}
+
+const char* SnapshotFile::departmentRecord(size_t dept) const {
+    return data + load<uint64_t>(data + kDepartmentTableAt) + dept * kDepartmentRecordSize;
+}
+
+/**
+ * Finds the record of a course, checking that the department's course range lies
+ * inside the course table.
+ */
+const char* SnapshotFile::courseRecord(size_t dept, size_t course) const {
+    const char* deptRecord = departmentRecord(dept);
+    uint64_t first = load<uint64_t>(deptRecord + kDeptFirstCourseAt);
+    uint64_t count = load<uint32_t>(deptRecord + kDeptCourseCountAt);
+    uint64_t courseCount = load<uint64_t>(data + kCourseCountAt);
+    if (first > courseCount || count > courseCount - first || course >= count) {
+        throw std::runtime_error("corrupt course table in data file");
+    }
+    return data + load<uint64_t>(data + kCourseTableAt) + (first + course) * kCourseRecordSize;
+}
+
+/**
+ * Copies a string out of the pool, checking that it lies inside the pool.
+ */
+std::string SnapshotFile::stringAt(const char* ref) const {
+    uint32_t offset = load<uint32_t>(ref);
+    uint32_t length = load<uint32_t>(ref + 4);
+    if (static_cast<uint64_t>(offset) + length > load<uint64_t>(data + kStringsSizeAt)) {
+        throw std::runtime_error("corrupt string reference in data file");
+    }
+    return std::string(data + load<uint64_t>(data + kStringsAt) + offset, length);
+}
+
+/**
+ * Creates the file and reserves room for the header.
+ *
+ * @param filePath the path of the file to write
+ */
+SnapshotWriter::SnapshotWriter(const std::string& filePath)
+    : out(filePath, std::ios::binary | std::ios::trunc), courseCount(0), departmentCount(0), fileSize(0) {
+    char header[kHeaderSize] = {};
+    out.write(header, sizeof(header));
+}
+
+/**
+ * Starts a new department. The courses added next belong to it.
+ */
+void SnapshotWriter::addDepartment(const std::string& key, const std::string& deptCode,
+                                   const std::string& departmentChair, int numberOfMajors) {
+    std::string record;
+    putString(record, key);
+    putString(record, deptCode);
+    putString(record, departmentChair);
+    record.append(kDepartmentRecordSize - record.size(), '\0');
+    store<int32_t>(&record[kDeptMajorsAt], numberOfMajors);
+    store<uint32_t>(&record[kDeptCourseCountAt], 0);
+    store<uint64_t>(&record[kDeptFirstCourseAt], courseCount);
+    departmentTable.append(record);
+    ++departmentCount;
+}
+
+/**
+ * Adds a course to the department added last.
+ */
+void SnapshotWriter::addCourse(const std::string& courseId, const Course::State& state) {
+    if (departmentCount == 0) {
+        throw std::logic_error("course added before any department");
+    }
+    std::string record;
+    putString(record, courseId);
+    record.append(8, '\0');
+    store<int32_t>(&record[kCourseCapacityAt], state.enrollmentCapacity);
+    store<int32_t>(&record[kCourseEnrolledAt], state.enrolledStudentCount);
+    putString(record, state.courseLocation);
+    putString(record, state.instructorName);
+    putString(record, state.courseTimeSlot);
+    out.write(record.data(), record.size());
+    ++courseCount;
+
+    char* counter = &departmentTable[departmentTable.size() - kDepartmentRecordSize + kDeptCourseCountAt];
+    store<uint32_t>(counter, load<uint32_t>(counter) + 1);
+}
+
+/**
+ * Adds every course of a department of another version 2 file to the department added
+ * last, without building Course objects for them.
+ */
+void SnapshotWriter::copyCourses(const SnapshotFile& from, size_t dept) {
+    size_t count = from.getCourseCount(dept);
+    for (size_t i = 0; i < count; ++i) {
+        addCourse(from.getCourseId(dept, i), from.getCourseState(dept, i));
+    }
+}
+
+/**
+ * Writes the department table, the string pool and the header.
+ *
+ * @param lsn the LSN of the last logged change included in the file
+ * @return true if everything was written
+ */
+bool SnapshotWriter::finish(uint64_t lsn) {
+    uint64_t departmentTableAt = kHeaderSize + courseCount * kCourseRecordSize;
+    uint64_t stringsAt = departmentTableAt + departmentTable.size();
+    out.write(departmentTable.data(), departmentTable.size());
+    out.write(strings.data(), strings.size());
+
+    char header[kHeaderSize];
+    std::memcpy(header, kMagic, kMagicSize);
+    store<uint64_t>(header + kLsnAt, lsn);
+    store<uint64_t>(header + kCourseTableAt, kHeaderSize);
+    store<uint64_t>(header + kCourseCountAt, courseCount);
+    store<uint64_t>(header + kDepartmentTableAt, departmentTableAt);
+    store<uint64_t>(header + kDepartmentCountAt, departmentCount);
+    store<uint64_t>(header + kStringsAt, stringsAt);
+    store<uint64_t>(header + kStringsSizeAt, strings.size());
+    out.seekp(0);
+    out.write(header, sizeof(header));
+    out.close();
+    fileSize = stringsAt + strings.size();
+    return !out.fail();
+}
+
+/**
+ * Gets the size of the file written by finish().
+ */
+uint64_t SnapshotWriter::getFileSize() const {
+    return fileSize;
+}
+
+/**
+ * Appends a reference to the string to a record, adding the string to the pool the
+ * first time it is seen.
+ */
+void SnapshotWriter::putString(std::string& record, const std::string& value) {
+    auto it = stringOffsets.find(value);
+    if (it == stringOffsets.end()) {
+        if (strings.size() + value.size() > UINT32_MAX) {
+            throw std::length_error("string pool of the data file is full");
+        }
+        it = stringOffsets.emplace(value, static_cast<uint32_t>(strings.size())).first;
+        strings.append(value);
+    }
+    char ref[kStringRefSize];
+    store<uint32_t>(ref, it->second);
+    store<uint32_t>(ref + 4, static_cast<uint32_t>(value.size()));
+    record.append(ref, sizeof(ref));
+}
+
+/**
+ * Reads a manifest.
+ *
+ * @param filePath the data path of the database
+ * @param manifest receives the manifest
+ * @return false if the file is missing or is not a manifest
+ * @throws std::runtime_error if the file is a truncated manifest
+ */
+bool SnapshotManifest::read(const std::string& filePath, SnapshotManifest& manifest) {
+    std::ifstream in(filePath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (contents.size() < kManifestHeaderSize || contents.compare(0, kMagicSize, kManifestMagic) != 0) {
+        return false;
+    }
+    const char* data = contents.data();
+    uint64_t count = load<uint64_t>(data + 24);
+    if (contents.size() != kManifestHeaderSize + count * kManifestEntrySize) {
+        throw std::runtime_error("truncated manifest " + filePath);
+    }
+    manifest.lsn = load<uint64_t>(data + 8);
+    manifest.nextSegment = load<uint64_t>(data + 16);
+    manifest.segments.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        const char* entry = data + kManifestHeaderSize + i * kManifestEntrySize;
+        manifest.segments.push_back(Segment{load<uint64_t>(entry), load<uint64_t>(entry + 8)});
+    }
+    return true;
+}
+
+/**
+ * Gets the path of a segment file.
+ *
+ * @param filePath the data path of the database
+ * @param number   the number of the segment
+ */
+std::string SnapshotManifest::segmentPath(const std::string& filePath, uint64_t number) {
+    return filePath + ".seg" + std::to_string(number);
+}
+
+/**
+ * Writes the manifest to a file, replacing it. The caller makes it durable.
+ *
+ * @param filePath the file to write
+ * @return true if everything was written
+ */
+bool SnapshotManifest::write(const std::string& filePath) const {
+    std::string contents(getFileSize(), '\0');
+    char* data = &contents[0];
+    std::memcpy(data, kManifestMagic, kMagicSize);
+    store<uint64_t>(data + 8, lsn);
+    store<uint64_t>(data + 16, nextSegment);
+    store<uint64_t>(data + 24, segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        char* entry = data + kManifestHeaderSize + i * kManifestEntrySize;
+        store<uint64_t>(entry, segments[i].number);
+        store<uint64_t>(entry + 8, segments[i].size);
+    }
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+    out.close();
+    return !out.fail();
+}
+
+uint64_t SnapshotManifest::getFileSize() const {
+    return kManifestHeaderSize + segments.size() * kManifestEntrySize;
+}
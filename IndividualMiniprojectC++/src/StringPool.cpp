@@ -0,0 +1,56 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "StringPool.h"
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+/**
+ * Finds the pooled copy of a string, adding it to the pool if it is not there yet.
+ *
+ * @param value the string to intern
+ * @return the pooled string, valid for the rest of the process
+ */
+const std::string* StringPool::intern(const std::string& value) {
+    Stripe& stripe = stripes()[std::hash<std::string>()(value) % kStripes];
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(stripe.mutex);
+        auto it = stripe.strings.find(value);
+        if (it != stripe.strings.end()) {
+            return &*it;
+        }
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(stripe.mutex);
+    return &*stripe.strings.insert(value).first;
+}
+
+/**
+ * Finds the pooled copy of a string without adding it.
+ *
+ * @param value the string to look for
+ * @return the pooled string, or nullptr if it was never interned
+ */
+const std::string* StringPool::find(const std::string& value) {
+    Stripe& stripe = stripes()[std::hash<std::string>()(value) % kStripes];
+    std::shared_lock<std::shared_timed_mutex> lock(stripe.mutex);
+    auto it = stripe.strings.find(value);
+    return it == stripe.strings.end() ? nullptr : &*it;
+}
+
+/**
+ * Gets the number of distinct strings interned so far.
+ */
+size_t StringPool::size() {
+    size_t count = 0;
+    for (size_t i = 0; i < kStripes; ++i) {
+        std::shared_lock<std::shared_timed_mutex> lock(stripes()[i].mutex);
+        count += stripes()[i].strings.size();
+    }
+    return count;
+}
+
+StringPool::Stripe* StringPool::stripes() {
+    static Stripe table[kStripes];
+    return table;
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "TimeInterval.h"
+#include <string>
+
+namespace {
+
+const int kMinutesPerDay = 24 * 60;
+const int kHalfDay = 12 * 60;
+
+}  // namespace
+
+/**
+ * Parses a time slot of the form "h:mm-h:mm".
+ *
+ * @param timeSlot the slot as stored on a course
+ * @return the interval it covers, not valid if the slot cannot be read
+ */
+TimeInterval TimeInterval::parse(const std::string& timeSlot) {
+    TimeInterval invalid{-1, -1};
+    size_t dash = timeSlot.find('-');
+    int start = 0;
+    int end = 0;
+    if (dash == std::string::npos || !parseClock(timeSlot.substr(0, dash), start) ||
+        !parseClock(timeSlot.substr(dash + 1), end)) {
+        return invalid;
+    }
+    if (end <= start) {
+        end += kHalfDay;
+    }
+    if (end <= start || end > kMinutesPerDay) {
+        return invalid;
+    }
+    return TimeInterval{static_cast<int16_t>(start), static_cast<int16_t>(end)};
+}
+
+/**
+ * Parses a clock time of the form "h:mm" or "hh:mm", reading hours 1 to 7 as
+ * afternoon and evening hours.
+ *
+ * @param text    the clock time
+ * @param minutes set to the minutes after midnight on success
+ * @return false if the text is not a clock time
+ */
+bool TimeInterval::parseClock(const std::string& text, int& minutes) {
+    size_t colon = text.find(':');
+    if (colon == 0 || colon > 2 || text.size() != colon + 3) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (i != colon && (text[i] < '0' || text[i] > '9')) {
+            return false;
+        }
+    }
+    int hours = std::stoi(text.substr(0, colon));
+    int mins = std::stoi(text.substr(colon + 1));
+    if (hours > 23 || mins > 59) {
+        return false;
+    }
+    if (hours >= 1 && hours <= 7) {
+        hours += 12;
+    }
+    minutes = hours * 60 + mins;
+    return true;
+}
+
+bool TimeInterval::isValid() const {
+    return start >= 0;
+}
+
+/**
+ * Checks whether two intervals share any minute.
+ */
+bool TimeInterval::overlaps(const TimeInterval& other) const {
+    return isValid() && other.isValid() && start < other.end && other.start < end;
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include "TimeRangeIndex.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+TimeRangeIndex::TimeRangeIndex() {}
+
+/**
+ * Adds every course of a department.
+ *
+ * @param deptCode the key of the department
+ * @param table    the department's courses
+ */
+void TimeRangeIndex::addDepartment(const std::string& deptCode, const CourseTable& table) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    size_t intervalCount = postings.size();
+    const std::string* pooledDeptCode = StringPool::intern(deptCode);
+    for (const auto& it : table) {
+        uint32_t row = static_cast<uint32_t>(courses.size());
+        const Course* course = it.second.get();
+        rows.emplace(course, row);
+        courses.push_back(course);
+        deptCodes.push_back(pooledDeptCode);
+        courseIds.push_back(StringPool::intern(it.first));
+        meetingTimes.push_back(TimeInterval{-1, -1});
+        positions.push_back(0);
+        post(row, course->getMeetingTime());
+    }
+    if (postings.size() != intervalCount) {
+        rebuildTree();
+    }
+}
+
+/**
+ * Moves a course to the list of its current meeting time. A course that was never
+ * added is ignored.
+ *
+ * @param course the course whose time slot changed
+ */
+void TimeRangeIndex::refresh(const Course* course) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    auto it = rows.find(course);
+    if (it == rows.end()) {
+        return;
+    }
+    TimeInterval interval = course->getMeetingTime();
+    const TimeInterval& current = meetingTimes[it->second];
+    if (current.start == interval.start && current.end == interval.end) {
+        return;
+    }
+    size_t intervalCount = postings.size();
+    unpost(it->second);
+    bool emptied = postings.size() != intervalCount;
+    post(it->second, interval);
+    if (emptied || postings.size() != intervalCount) {
+        rebuildTree();
+    }
+}
+
+/**
+ * Finds the courses that meet during any part of a range.
+ *
+ * @param range the minutes to look for, start inclusive and end exclusive
+ * @return the courses, in the order they were added
+ */
+std::vector<CourseRef> TimeRangeIndex::find(const TimeInterval& range) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    std::vector<size_t> found;
+    if (range.isValid()) {
+        collect(0, intervals.size(), range, found);
+    }
+    std::vector<uint32_t> matched;
+    for (size_t i : found) {
+        const std::vector<uint32_t>& list = postings.at(keyOf(intervals[i]));
+        matched.insert(matched.end(), list.begin(), list.end());
+    }
+    std::sort(matched.begin(), matched.end());
+    std::vector<CourseRef> result;
+    result.reserve(matched.size());
+    for (uint32_t row : matched) {
+        result.push_back(CourseRef{*deptCodes[row], *courseIds[row], courses[row]});
+    }
+    return result;
+}
+
+/**
+ * Gets the number of distinct meeting times in the index.
+ */
+size_t TimeRangeIndex::getIntervalCount() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    return intervals.size();
+}
+
+uint32_t TimeRangeIndex::keyOf(const TimeInterval& interval) {
+    return static_cast<uint32_t>(static_cast<uint16_t>(interval.start)) << 16 | static_cast<uint16_t>(interval.end);
+}
+
+/**
+ * Appends a row to the list of its interval, unless the interval is not valid. The
+ * caller holds the lock exclusively.
+ */
+void TimeRangeIndex::post(uint32_t row, const TimeInterval& interval) {
+    meetingTimes[row] = interval;
+    if (!interval.isValid()) {
+        return;
+    }
+    std::vector<uint32_t>& list = postings[keyOf(interval)];
+    positions[row] = static_cast<uint32_t>(list.size());
+    list.push_back(row);
+}
+
+/**
+ * Removes a row from the list of its interval by moving the list's last row into its
+ * place. The caller holds the lock exclusively.
+ */
+void TimeRangeIndex::unpost(uint32_t row) {
+    if (!meetingTimes[row].isValid()) {
+        return;
+    }
+    auto it = postings.find(keyOf(meetingTimes[row]));
+    std::vector<uint32_t>& list = it->second;
+    uint32_t last = list.back();
+    list[positions[row]] = last;
+    positions[last] = positions[row];
+    list.pop_back();
+    if (list.empty()) {
+        postings.erase(it);
+    }
+}
+
+/**
+ * Rebuilds the interval tree from the intervals that have courses. The node for the
+ * range [lo, hi) of the sorted array is its middle element, and maxEnd of that element
+ * holds the latest end in the range. The caller holds the lock exclusively.
+ */
+void TimeRangeIndex::rebuildTree() {
+    intervals.clear();
+    for (const auto& it : postings) {
+        intervals.push_back(TimeInterval{static_cast<int16_t>(it.first >> 16),
+                                         static_cast<int16_t>(it.first & 0xFFFF)});
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const TimeInterval& a, const TimeInterval& b) {
+        return a.start < b.start || (a.start == b.start && a.end < b.end);
+    });
+    maxEnd.assign(intervals.size(), 0);
+    struct Builder {
+        const std::vector<TimeInterval>& intervals;
+        std::vector<int16_t>& maxEnd;
+
+        int16_t build(size_t lo, size_t hi) {
+            if (lo >= hi) {
+                return 0;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            maxEnd[mid] = std::max({intervals[mid].end, build(lo, mid), build(mid + 1, hi)});
+            return maxEnd[mid];
+        }
+    };
+    Builder{intervals, maxEnd}.build(0, intervals.size());
+}
+
+/**
+ * Collects the intervals in [lo, hi) of the sorted array that overlap a range. A
+ * subtree is skipped when nothing in it ends after the range starts, and everything
+ * right of a node is skipped when the node starts at or after the range ends.
+ */
+void TimeRangeIndex::collect(size_t lo, size_t hi, const TimeInterval& range, std::vector<size_t>& found) const {
+    if (lo >= hi) {
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    if (maxEnd[mid] <= range.start) {
+        return;
+    }
+    collect(lo, mid, range, found);
+    if (intervals[mid].start >= range.end) {
+        return;
+    }
+    if (intervals[mid].end > range.start) {
+        found.push_back(mid);
+    }
+    collect(mid + 1, hi, range, found);
+}
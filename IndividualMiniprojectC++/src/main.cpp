@@ -29,10 +29,14 @@ void signalHandler(int signal) {
 
 /**
  *  Sets up the HTTP server and runs the program 
+ *
+ *  Usage: IndividualMiniproject [run|setup] [write|batch|<N>ms]
+ *  The second argument picks when logged mutations are fsynced.
  */
 int main(int argc, char* argv[]) {
     std::string mode = argc > 1 ? argv[1] : "run";
-    MyApp::run(mode);
+    std::string syncPolicy = argc > 2 ? argv[2] : "batch";
+    MyApp::run(mode, syncPolicy);
 
     crow::SimpleApp app;
     app.signal_clear();
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "BufferedStream.h"
+
+TEST(BufferedStreamUnitTests, RoundTripAcrossChunksTest) {
+    std::string longString(100, 'x');
+    std::ostringstream out;
+    {
+        // chunks smaller than the fields force every value across a boundary
+        BufferedWriter writer(out, 3);
+        writer.write(42);
+        writer.writeString("501 NWC");
+        writer.writeString(longString);
+        writer.write(static_cast<size_t>(7));
+        writer.writeString("");
+    }
+
+    std::istringstream in(out.str());
+    BufferedReader reader(in, 5);
+    int number = 0;
+    size_t size = 0;
+    std::string text;
+    EXPECT_TRUE(reader.read(number));
+    EXPECT_EQ(42, number);
+    EXPECT_TRUE(reader.readString(text));
+    EXPECT_EQ("501 NWC", text);
+    EXPECT_TRUE(reader.readString(text));
+    EXPECT_EQ(longString, text);
+    EXPECT_TRUE(reader.read(size));
+    EXPECT_EQ(7u, size);
+    EXPECT_TRUE(reader.readString(text));
+    EXPECT_EQ("", text);
+    EXPECT_TRUE(reader.ok());
+
+    EXPECT_FALSE(reader.read(number));
+    EXPECT_EQ(0, number);
+    EXPECT_FALSE(reader.ok());
+}
+
+TEST(BufferedStreamUnitTests, UnreadBytesAreHandedBackTest) {
+    std::ostringstream out;
+    {
+        BufferedWriter writer(out);
+        writer.writeString("COMS");
+        writer.writeString("ECON");
+    }
+
+    std::istringstream in(out.str());
+    std::string first;
+    std::string second;
+    {
+        BufferedReader reader(in);
+        reader.readString(first);
+    }
+    BufferedReader reader(in);
+    reader.readString(second);
+    EXPECT_EQ("COMS", first);
+    EXPECT_EQ("ECON", second);
+}
+
+TEST(BufferedStreamUnitTests, TruncatedStringTest) {
+    std::ostringstream out;
+    {
+        BufferedWriter writer(out);
+        writer.writeString("Gail Kaiser");
+    }
+    std::string data = out.str();
+    std::istringstream in(data.substr(0, data.size() - 3));
+    BufferedReader reader(in, 4);
+    std::string text;
+    EXPECT_FALSE(reader.readString(text));
+    EXPECT_FALSE(reader.ok());
+}
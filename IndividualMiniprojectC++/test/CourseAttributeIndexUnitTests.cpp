@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CourseAttributeIndex.h"
+#include "TestSupport.h"
+
+using testsupport::names;
+
+class CourseAttributeIndexUnitTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        coms.set("3157", std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25"));
+        coms.set("3827", std::make_shared<Course>(300, "Daniel Rubenstein", "207 Math", "10:10-11:25"));
+        coms.set("4156", std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25"));
+        phys.set("1221", std::make_shared<Course>(150, "James G. Mccann", "301 PUP", "4:10-5:25"));
+        index.addDepartment("COMS", coms);
+        index.addDepartment("PHYS", phys);
+    }
+
+    CourseTable coms;
+    CourseTable phys;
+    CourseAttributeIndex index;
+};
+
+TEST_F(CourseAttributeIndexUnitTests, FindTest) {
+    EXPECT_EQ(4u, index.size());
+    std::vector<CourseRef> kaiser = index.find(CourseAttributeIndex::Attribute::Instructor, "Gail Kaiser");
+    ASSERT_EQ(1u, kaiser.size());
+    EXPECT_EQ("COMS", kaiser[0].deptCode);
+    EXPECT_EQ("4156", kaiser[0].courseId);
+    EXPECT_EQ(coms.findCourse("4156"), kaiser[0].course);
+
+    EXPECT_EQ((std::vector<std::string>{"COMS 3157", "PHYS 1221"}),
+              names(index.find(CourseAttributeIndex::Attribute::TimeSlot, "4:10-5:25")));
+    EXPECT_EQ((std::vector<std::string>{"PHYS 1221"}),
+              names(index.find(CourseAttributeIndex::Attribute::Location, "301 PUP")));
+
+    // values of another attribute, or of no course, find nothing
+    EXPECT_TRUE(index.find(CourseAttributeIndex::Attribute::Location, "Gail Kaiser").empty());
+    EXPECT_TRUE(index.find(CourseAttributeIndex::Attribute::Instructor, "Nobody Teaches This").empty());
+}
+
+TEST_F(CourseAttributeIndexUnitTests, RefreshTest) {
+    Course* coms3157 = coms.findCourse("3157");
+    coms3157->reassignTime("10:10-11:25");
+    coms3157->reassignInstructor("Gail Kaiser");
+    index.refresh(coms3157);
+
+    EXPECT_EQ((std::vector<std::string>{"COMS 3157", "COMS 3827", "COMS 4156"}),
+              names(index.find(CourseAttributeIndex::Attribute::TimeSlot, "10:10-11:25")));
+    EXPECT_EQ((std::vector<std::string>{"PHYS 1221"}),
+              names(index.find(CourseAttributeIndex::Attribute::TimeSlot, "4:10-5:25")));
+    EXPECT_EQ((std::vector<std::string>{"COMS 3157", "COMS 4156"}),
+              names(index.find(CourseAttributeIndex::Attribute::Instructor, "Gail Kaiser")));
+    EXPECT_TRUE(index.find(CourseAttributeIndex::Attribute::Instructor, "Jae Lee").empty());
+    EXPECT_EQ((std::vector<std::string>{"COMS 3157"}),
+              names(index.find(CourseAttributeIndex::Attribute::Location, "417 IAB")));
+
+    // moving the first course of a list keeps the rest of it
+    coms.findCourse("3827")->reassignLocation("417 IAB");
+    index.refresh(coms.findCourse("3827"));
+    coms3157->reassignLocation("501 NWC");
+    index.refresh(coms3157);
+    EXPECT_EQ((std::vector<std::string>{"COMS 3827"}),
+              names(index.find(CourseAttributeIndex::Attribute::Location, "417 IAB")));
+    EXPECT_EQ((std::vector<std::string>{"COMS 3157", "COMS 4156"}),
+              names(index.find(CourseAttributeIndex::Attribute::Location, "501 NWC")));
+
+    // courses that were never added are ignored
+    Course other(10, "Jae Lee", "417 IAB", "4:10-5:25");
+    index.refresh(&other);
+    EXPECT_EQ(4u, index.size());
+}
+
+TEST_F(CourseAttributeIndexUnitTests, SearchTest) {
+    auto search = [this](const std::string& query, size_t limit) {
+        std::vector<std::string> result;
+        for (const auto& hit : index.search(CourseAttributeIndex::Attribute::Instructor, query, limit)) {
+            result.push_back(hit.value + " " + std::to_string(hit.courseCount));
+        }
+        return result;
+    };
+
+    // the start of any word of a name finds it, whatever its case
+    EXPECT_EQ((std::vector<std::string>{"Gail Kaiser 1"}), search("Kais", 10));
+    EXPECT_EQ((std::vector<std::string>{"James G. Mccann 1"}), search("mccan", 10));
+    EXPECT_EQ((std::vector<std::string>{"Jae Lee 1", "James G. Mccann 1"}), search("ja", 10));
+    EXPECT_EQ((std::vector<std::string>{"Jae Lee 1"}), search("ja", 1));
+    EXPECT_EQ((std::vector<std::string>{"Gail Kaiser 1"}), search("gail k", 10));
+
+    // names sharing most of the query's trigrams are found despite typos
+    EXPECT_EQ((std::vector<std::string>{"Gail Kaiser 1"}), search("Kaisr", 10));
+    EXPECT_EQ((std::vector<std::string>{"Daniel Rubenstein 1"}), search("Rubenstien", 10));
+    EXPECT_TRUE(search("Zhou", 10).empty());
+    EXPECT_TRUE(search("  ", 10).empty());
+    EXPECT_TRUE(search("Kais", 0).empty());
+
+    // other attributes are searched separately
+    std::vector<CourseAttributeIndex::SearchHit> rooms =
+        index.search(CourseAttributeIndex::Attribute::Location, "iab", 10);
+    ASSERT_EQ(1u, rooms.size());
+    EXPECT_EQ("417 IAB", rooms[0].value);
+
+    // reassignments move names in and out of the search
+    Course* coms3157 = coms.findCourse("3157");
+    coms3157->reassignInstructor("Gail Kaiser");
+    index.refresh(coms3157);
+    EXPECT_EQ((std::vector<std::string>{"Gail Kaiser 2"}), search("Kais", 10));
+    EXPECT_EQ((std::vector<std::string>{"James G. Mccann 1"}), search("Jae", 10));
+    coms3157->reassignInstructor("Jae Lee");
+    index.refresh(coms3157);
+    EXPECT_EQ((std::vector<std::string>{"Jae Lee 1", "James G. Mccann 1"}), search("Jae", 10));
+}
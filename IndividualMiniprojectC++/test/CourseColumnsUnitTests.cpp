@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CourseColumns.h"
+
+namespace {
+
+std::vector<CourseColumns::Condition> conditions(const std::vector<std::string>& texts) {
+    std::vector<CourseColumns::Condition> parsed;
+    for (const std::string& text : texts) {
+        CourseColumns::Condition condition;
+        EXPECT_TRUE(CourseColumns::Condition::parse(text, condition)) << text;
+        parsed.push_back(condition);
+    }
+    return parsed;
+}
+
+}  // namespace
+
+TEST(CourseColumnsUnitTests, ParseTest) {
+    CourseColumns::Condition condition;
+    ASSERT_TRUE(CourseColumns::Condition::parse("capacity>100", condition));
+    EXPECT_EQ(CourseColumns::Column::Capacity, condition.column);
+    EXPECT_EQ(CourseColumns::Comparison::Greater, condition.comparison);
+    EXPECT_EQ(100, condition.number);
+
+    ASSERT_TRUE(CourseColumns::Condition::parse("fill>=0.9", condition));
+    EXPECT_EQ(CourseColumns::Column::Fill, condition.column);
+    EXPECT_EQ(CourseColumns::Comparison::GreaterOrEqual, condition.comparison);
+    EXPECT_DOUBLE_EQ(0.9, condition.number);
+
+    ASSERT_TRUE(CourseColumns::Condition::parse("enrolled<=5", condition));
+    EXPECT_EQ(CourseColumns::Comparison::LessOrEqual, condition.comparison);
+
+    ASSERT_TRUE(CourseColumns::Condition::parse("dept=COMS", condition));
+    EXPECT_EQ(CourseColumns::Column::Department, condition.column);
+    EXPECT_EQ("COMS", condition.text);
+
+    ASSERT_TRUE(CourseColumns::Condition::parse("time=4:10-5:25", condition));
+    EXPECT_EQ(CourseColumns::Column::TimeSlot, condition.column);
+    EXPECT_EQ("4:10-5:25", condition.text);
+
+    EXPECT_FALSE(CourseColumns::Condition::parse("capacity", condition));
+    EXPECT_FALSE(CourseColumns::Condition::parse("capacity>", condition));
+    EXPECT_FALSE(CourseColumns::Condition::parse("capacity>ten", condition));
+    EXPECT_FALSE(CourseColumns::Condition::parse("seats>10", condition));
+    EXPECT_FALSE(CourseColumns::Condition::parse("dept>COMS", condition));
+    EXPECT_FALSE(CourseColumns::Condition::parse(">10", condition));
+}
+
+TEST(CourseColumnsUnitTests, SelectTest) {
+    // enough courses for whole SIMD steps and a remainder
+    CourseTable coms;
+    for (int i = 0; i < 37; ++i) {
+        auto course = std::make_shared<Course>(50 + 10 * i, i % 2 ? "Jae Lee" : "Gail Kaiser",
+                                               i % 3 ? "417 IAB" : "501 NWC", "4:10-5:25");
+        course->setEnrolledStudentCount(5 * i);
+        coms.set(std::to_string(1000 + i), course);
+    }
+    CourseTable phys;
+    phys.set("1221", std::make_shared<Course>(150, "James G. Mccann", "301 PUP", "4:10-5:25"));
+
+    CourseColumns columns;
+    columns.addDepartment("COMS", coms);
+    columns.addDepartment("PHYS", phys);
+    ASSERT_EQ(38u, columns.size());
+    EXPECT_EQ("PHYS", columns.getDeptCode(37));
+    EXPECT_EQ("1221", columns.getCourseId(37));
+
+    EXPECT_EQ(38u, columns.select({}).size());
+    EXPECT_EQ(std::vector<size_t>({36}), columns.select(conditions({"capacity>=410"})));
+    EXPECT_EQ(std::vector<size_t>({0, 1}), columns.select(conditions({"capacity<65"})));
+    EXPECT_EQ(std::vector<size_t>({2}), columns.select(conditions({"enrolled=10"})));
+    EXPECT_TRUE(columns.select(conditions({"enrolled=10.5"})).empty());
+    EXPECT_EQ(std::vector<size_t>({37}), columns.select(conditions({"dept=PHYS"})));
+    EXPECT_TRUE(columns.select(conditions({"dept=CHEM"})).empty());
+    EXPECT_TRUE(columns.select(conditions({"location=NOWHERE"})).empty());
+
+    // 5i / (50 + 10i) > 0.4 once i > 20
+    std::vector<size_t> full;
+    for (size_t i = 21; i < 37; ++i) {
+        full.push_back(i);
+    }
+    EXPECT_EQ(full, columns.select(conditions({"fill>0.4"})));
+    EXPECT_EQ(std::vector<size_t>({20}), columns.select(conditions({"fill=0.4"})));
+
+    std::vector<size_t> expected;
+    for (size_t i = 21; i < 37; ++i) {
+        if (i % 2 && i % 3 == 0) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(expected, columns.select(conditions({"fill>0.4", "instructor=Jae Lee", "location=501 NWC",
+                                                   "dept=COMS"})));
+}
+
+TEST(CourseColumnsUnitTests, RefreshTest) {
+    auto course = std::make_shared<Course>(100, "Jae Lee", "417 IAB", "4:10-5:25");
+    CourseTable table;
+    table.set("3157", course);
+    CourseColumns columns;
+    columns.addDepartment("COMS", table);
+    EXPECT_TRUE(columns.select(conditions({"enrolled>0"})).empty());
+
+    course->setEnrolledStudentCount(95);
+    EXPECT_TRUE(columns.select(conditions({"enrolled>0"})).empty());
+    columns.refreshEnrollment(course.get());
+    EXPECT_EQ(95, columns.getEnrolled(0));
+    EXPECT_EQ(1u, columns.select(conditions({"fill>0.9"})).size());
+
+    course->reassignInstructor("Tony Dear");
+    course->reassignLocation("402 CHANDLER");
+    columns.refresh(course.get());
+    EXPECT_EQ(1u, columns.select(conditions({"instructor=Tony Dear", "location=402 CHANDLER"})).size());
+    EXPECT_TRUE(columns.select(conditions({"instructor=Jae Lee"})).empty());
+
+    // courses without a row are ignored
+    Course other(10, "Jae Lee", "417 IAB", "4:10-5:25");
+    columns.refresh(&other);
+    EXPECT_EQ(1u, columns.size());
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Course.h"
+#include "CourseIndex.h"
+
+TEST(CourseIndexUnitTests, PackKeyTest) {
+    uint64_t coms4156 = 0;
+    uint64_t key = 0;
+    ASSERT_TRUE(CourseIndex::packKey("COMS", "4156", coms4156));
+    EXPECT_TRUE(CourseIndex::packKey("COMS", 4156, key));
+    EXPECT_EQ(coms4156, key);
+    EXPECT_TRUE(CourseIndex::packKey("COM", "4156", key));
+    EXPECT_NE(coms4156, key);
+    EXPECT_TRUE(CourseIndex::packKey("COMS", "0", key));
+    EXPECT_TRUE(CourseIndex::packKey("COMS", "4294967295", key));
+
+    // keys that would not round trip through a course number are refused
+    EXPECT_FALSE(CourseIndex::packKey("COMS", "04156", key));
+    EXPECT_FALSE(CourseIndex::packKey("COMS", "4156A", key));
+    EXPECT_FALSE(CourseIndex::packKey("COMS", "", key));
+    EXPECT_FALSE(CourseIndex::packKey("COMS", "4294967296", key));
+    EXPECT_FALSE(CourseIndex::packKey("COMS", -1, key));
+    EXPECT_FALSE(CourseIndex::packKey("COMPS", "4156", key));
+    EXPECT_FALSE(CourseIndex::packKey("", "4156", key));
+    EXPECT_FALSE(CourseIndex::packKey(std::string("CO\0S", 4), "4156", key));
+}
+
+TEST(CourseIndexUnitTests, FindAndGrowTest) {
+    // starts small so inserting forces the table to grow several times
+    CourseIndex index;
+    std::vector<std::unique_ptr<Course>> courses;
+    uint64_t key = 0;
+    for (int i = 0; i < 5000; ++i) {
+        courses.emplace_back(new Course(100, "Jae Lee", "417 IAB", "4:10-5:25"));
+        ASSERT_TRUE(CourseIndex::packKey(i % 2 ? "COMS" : "ECON", 1000 + i, key));
+        index.insert(key, courses.back().get());
+    }
+    EXPECT_EQ(5000u, index.size());
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(CourseIndex::packKey(i % 2 ? "COMS" : "ECON", 1000 + i, key));
+        EXPECT_EQ(courses[i].get(), index.find(key));
+    }
+    ASSERT_TRUE(CourseIndex::packKey("COMS", 1000, key));
+    EXPECT_EQ(nullptr, index.find(key));
+
+    // inserting an existing key replaces its course
+    Course replacement;
+    ASSERT_TRUE(CourseIndex::packKey("ECON", 1000, key));
+    index.insert(key, &replacement);
+    EXPECT_EQ(&replacement, index.find(key));
+    EXPECT_EQ(5000u, index.size());
+}
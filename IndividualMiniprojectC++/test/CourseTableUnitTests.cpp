@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CourseTable.h"
+
+TEST(CourseTableUnitTests, SortedLookupTest) {
+    CourseTable table;
+    table.set("4156", std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25"));
+    table.set("1004", std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55"));
+    table.set("3157", std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25"));
+
+    std::vector<std::string> ids;
+    for (const auto& it : table) {
+        ids.push_back(it.first);
+    }
+    EXPECT_EQ((std::vector<std::string>{"1004", "3157", "4156"}), ids);
+    ASSERT_NE(table.findCourse("3157"), nullptr);
+    EXPECT_EQ("Jae Lee", table.findCourse("3157")->getInstructorName());
+    EXPECT_EQ(table.end(), table.find("3158"));
+    EXPECT_EQ(nullptr, table.findCourse(""));
+
+    // setting an existing ID replaces its course
+    auto replacement = std::make_shared<Course>(10, "Tony Dear", "402 CHANDLER", "1:10-3:40");
+    table.set("1004", replacement);
+    EXPECT_EQ(3u, table.size());
+    EXPECT_EQ(replacement.get(), table.findCourse("1004"));
+}
+
+TEST(CourseTableUnitTests, ContiguousCoursesTest) {
+    std::unique_ptr<CourseTable> table(new CourseTable());
+    table->reserveContiguous(3);
+    Course& first = table->emplace("1001", Course::State{100, 10, "417 IAB", "Jae Lee", "4:10-5:25"});
+    Course& second = table->emplace("1002", Course::State{100, 20, "417 IAB", "Jae Lee", "4:10-5:25"});
+    Course& third = table->emplace("1003");
+    Course& fourth = table->emplace("1000", Course::State{100, 40, "417 IAB", "Jae Lee", "4:10-5:25"});
+
+    // reserved courses sit side by side; the one past the reservation does not
+    EXPECT_EQ(&first + 1, &second);
+    EXPECT_EQ(&second + 1, &third);
+    EXPECT_EQ(4u, table->size());
+    EXPECT_EQ("1000", table->begin()->first);
+    EXPECT_EQ(&fourth, table->findCourse("1000"));
+    EXPECT_EQ(0, table->findCourse("1003")->getEnrolledStudentCount());
+    EXPECT_EQ(0u, table->findCourse("1001")->getChangedAt());
+
+    // copies share the courses, which outlive the table they were built in
+    CourseTable copy(*table);
+    std::shared_ptr<Course> held = table->find("1002")->second;
+    table.reset();
+    EXPECT_EQ(&second, copy.findCourse("1002"));
+    EXPECT_EQ(20, held->getEnrolledStudentCount());
+
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["2000"] = held;
+    CourseTable fromMap(courses);
+    EXPECT_EQ(held.get(), fromMap.findCourse("2000"));
+}
@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include "Course.h" 
 #include <sstream>  // For std::ostringstream and std::istringstream
+#include <thread>
+#include <vector>
 
 class CourseUnitTests : public ::testing::Test {
 protected:
@@ -52,6 +54,11 @@ TEST_F(CourseUnitTests, ReassignInstructorTest) {
 TEST_F(CourseUnitTests, ReassignTimeTest) {
     coms1004->reassignTime("4:10-5:25");
     EXPECT_EQ(coms1004->getCourseTimeSlot(), "4:10-5:25");
+    EXPECT_EQ(coms1004->getMeetingTime().start, 16 * 60 + 10);
+    EXPECT_EQ(coms1004->getMeetingTime().end, 17 * 60 + 25);
+
+    coms1004->reassignTime("TBA");
+    EXPECT_FALSE(coms1004->getMeetingTime().isValid());
 }
 
 TEST_F(CourseUnitTests, ReassignLocationTest) {
@@ -79,6 +86,30 @@ TEST_F(CourseUnitTests, DropStudentTest) {
     EXPECT_FALSE(coms1004->dropStudent());
 }
 
+TEST_F(CourseUnitTests, ConcurrentEnrollTest) {
+    Course course(400, "Gail Kaiser", "501 NWC", "10:10-11:25");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&course]() {
+            for (int i = 0; i < 100; ++i) {
+                course.enrollStudent();
+                course.getCourseLocation();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(course.isCourseFull());    // 800 attempts for 400 seats
+
+    // exactly 400 students were enrolled, never more
+    for (int i = 0; i < 400; ++i) {
+        EXPECT_TRUE(course.dropStudent());
+    }
+    EXPECT_FALSE(course.dropStudent());
+}
+
 TEST_F(CourseUnitTests, SerializationDeserializationTest) {
     coms1004->setEnrolledStudentCount(10);
 
@@ -96,4 +127,46 @@ TEST_F(CourseUnitTests, SerializationDeserializationTest) {
     EXPECT_EQ(coms1004->getInstructorName(), deserializedCourse.getInstructorName());
     EXPECT_EQ(coms1004->getCourseTimeSlot(), deserializedCourse.getCourseTimeSlot());
     EXPECT_EQ(coms1004->isCourseFull(), deserializedCourse.isCourseFull());
-}
\ No newline at end of file
+}
+TEST_F(CourseUnitTests, CheckpointCopyTest) {
+    Course course(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    course.setEnrolledStudentCount(109);
+
+    // changed while checkpoint 1 runs: the checkpoint still sees the course as it was
+    course.preserveForCheckpoint(1);
+    course.reassignLocation("833 MUDD");
+    EXPECT_TRUE(course.enrollStudent());
+    course.preserveForCheckpoint(1);
+    Course::State checkpoint = course.stateForCheckpoint(1);
+    EXPECT_EQ("501 NWC", checkpoint.courseLocation);
+    EXPECT_EQ(109, checkpoint.enrolledStudentCount);
+    EXPECT_EQ(120, checkpoint.enrollmentCapacity);
+
+    // the next checkpoint reads the current state
+    Course::State nextCheckpoint = course.stateForCheckpoint(2);
+    EXPECT_EQ("833 MUDD", nextCheckpoint.courseLocation);
+    EXPECT_EQ(110, nextCheckpoint.enrolledStudentCount);
+    EXPECT_EQ("Gail Kaiser", nextCheckpoint.instructorName);
+}
+
+TEST_F(CourseUnitTests, DisplayCacheTest) {
+    Course course(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::shared_ptr<const std::string> first = course.displayText();
+    EXPECT_EQ(course.display(), *first);
+
+    // unchanged: the same buffer comes back
+    EXPECT_EQ(first.get(), course.displayText().get());
+
+    uint64_t version = course.getVersion();
+    course.reassignLocation("833 MUDD");
+    EXPECT_GT(course.getVersion(), version);
+    std::shared_ptr<const std::string> moved = course.displayText();
+    EXPECT_NE(first.get(), moved.get());
+    EXPECT_EQ("\nInstructor: Gail Kaiser; Location: 833 MUDD; Time: 10:10-11:25", *moved);
+    EXPECT_EQ("\nInstructor: Gail Kaiser; Location: 501 NWC; Time: 10:10-11:25", *first);
+
+    version = course.getVersion();
+    EXPECT_TRUE(course.enrollStudent());
+    EXPECT_GT(course.getVersion(), version);
+    EXPECT_EQ(*moved, course.display());
+}
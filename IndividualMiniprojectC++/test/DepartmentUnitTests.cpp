@@ -1,8 +1,35 @@
 // Copyright (c) 2024 Annie Xu @ Columbia University
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "Department.h"
 
+namespace {
+
+// Adds up a department's courses one by one, to check its running totals against.
+DepartmentTotals::Values recompute(const Department& dept) {
+    DepartmentTotals::Values values{0, 0, 0, 0};
+    for (const auto& it : dept.getCourseSelection()) {
+        ++values.courseCount;
+        values.seats += it.second->getEnrollmentCapacity();
+        values.enrolled += it.second->getEnrolledStudentCount();
+        values.fullCourses += it.second->isCourseFull() ? 1 : 0;
+    }
+    return values;
+}
+
+void expectTotals(const DepartmentTotals::Values& expected, const DepartmentTotals::Values& actual) {
+    EXPECT_EQ(expected.courseCount, actual.courseCount);
+    EXPECT_EQ(expected.seats, actual.seats);
+    EXPECT_EQ(expected.enrolled, actual.enrolled);
+    EXPECT_EQ(expected.fullCourses, actual.fullCourses);
+}
+
+}  // namespace
+
 class DepartmentUnitTests : public ::testing::Test {
 protected:
     static Department* phys;
@@ -66,11 +93,17 @@ TEST_F(DepartmentUnitTests, GetCourseSelectionTest) {
     expectedCourses["2000"] = phys2000;
     expectedCourses["3801"] = phys3801;
 
-    auto retrievedCourses = phys->getCourseSelection();
+    const CourseTable& table = phys->getCourseSelection();
+    std::map<std::string, std::shared_ptr<Course>> retrievedCourses(table.begin(), table.end());
 
     EXPECT_EQ(courses,retrievedCourses);
 }
 
+TEST_F(DepartmentUnitTests, FindCourseTest) {
+    EXPECT_EQ(courses["2000"].get(), phys->findCourse("2000"));
+    EXPECT_EQ(nullptr, phys->findCourse("0000"));
+}
+
 TEST_F(DepartmentUnitTests, GetDepartmentChairTest) {
     ASSERT_EQ("Marcia L. Newson", phys->getDepartmentChair());
 }
@@ -107,6 +140,24 @@ TEST_F(DepartmentUnitTests, AddPersonFromMajorTest) {
     ASSERT_EQ(200, phys->getNumberOfMajors());
 }
 
+TEST_F(DepartmentUnitTests, ConcurrentMajorUpdatesTest) {
+    Department dept("COMS", {}, "Luca Carloni", 0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&dept]() {
+            for (int i = 0; i < 1000; ++i) {
+                dept.addPersonToMajor();
+                dept.getNumberOfMajors();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(8000, dept.getNumberOfMajors());
+}
+
 TEST_F(DepartmentUnitTests, SerializationDeserializeTest) {
     // serialize object to string
     std::ostringstream outStream;
@@ -142,3 +193,176 @@ TEST_F(DepartmentUnitTests, SerializationDeserializeTest) {
         }
     }
 }
+
+TEST_F(DepartmentUnitTests, SerializedBytesMatchOriginalFormatTest) {
+    std::map<std::string, std::shared_ptr<Course>> oneCourse;
+    oneCourse["1221"] = std::make_shared<Course>(150, "James G. Mccann", "301 PUP", "4:10-5:25");
+    oneCourse["1221"]->setEnrolledStudentCount(118);
+    Department dept("PHYS", oneCourse, "Marcia L. Newson", 200);
+
+    // field by field, as the original serialize() wrote it
+    std::ostringstream expected;
+    auto putSize = [&expected](size_t value) { expected.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto putInt = [&expected](int value) { expected.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto putString = [&](const std::string& value) { putSize(value.size()); expected << value; };
+    putString("PHYS");
+    putString("Marcia L. Newson");
+    putInt(200);
+    putSize(1);
+    putString("1221");
+    putInt(150);
+    putInt(118);
+    putString("301 PUP");
+    putString("James G. Mccann");
+    putString("4:10-5:25");
+
+    std::ostringstream actual;
+    dept.serialize(actual);
+    EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST_F(DepartmentUnitTests, ChangeStampTest) {
+    std::map<std::string, std::shared_ptr<Course>> oneCourse;
+    oneCourse["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    Department coms("COMS", oneCourse, "Luca Carloni", 2700);
+    Department copy(coms);
+
+    uint64_t saved = ChangeClock::advance();
+    EXPECT_LE(coms.getChangedAt(), saved);
+    oneCourse["4156"]->reassignLocation("833 MUDD");
+    EXPECT_GT(oneCourse["4156"]->getChangedAt(), saved);
+    EXPECT_GT(coms.getChangedAt(), saved);
+    EXPECT_GT(copy.getChangedAt(), saved);
+
+    // a course first added elsewhere still marks a department it is added to later
+    Department econ("ECON", {}, "Michael Woodford", 2345);
+    econ.addCourse("4156", oneCourse["4156"]);
+    saved = ChangeClock::advance();
+    EXPECT_LE(econ.getChangedAt(), saved);
+    oneCourse["4156"]->enrollStudent();
+    EXPECT_GT(econ.getChangedAt(), saved);
+}
+
+TEST_F(DepartmentUnitTests, DisplayCacheTest) {
+    std::map<std::string, std::shared_ptr<Course>> twoCourses;
+    twoCourses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    twoCourses["3157"] = std::make_shared<Course>(200, "Jae Lee", "417 IAB", "4:10-5:25");
+    Department coms("COMS", twoCourses, "Luca Carloni", 2700);
+    Department copy(coms);
+
+    std::shared_ptr<const std::string> first = coms.displayText();
+    EXPECT_EQ(first.get(), coms.displayText().get());
+    EXPECT_EQ("COMS 3157: \nInstructor: Jae Lee; Location: 417 IAB; Time: 4:10-5:25\n"
+              "COMS 4156: \nInstructor: Gail Kaiser; Location: 501 NWC; Time: 10:10-11:25\n", *first);
+
+    // a change to a course moves the version of the department and of its copy
+    uint64_t version = coms.getVersion();
+    twoCourses["4156"]->reassignInstructor("Adam Cannon");
+    EXPECT_GT(coms.getVersion(), version);
+    std::string expected = "COMS 3157: \nInstructor: Jae Lee; Location: 417 IAB; Time: 4:10-5:25\n"
+                           "COMS 4156: \nInstructor: Adam Cannon; Location: 501 NWC; Time: 10:10-11:25\n";
+    EXPECT_EQ(expected, coms.display());
+    EXPECT_EQ(expected, copy.display());
+
+    // so does a new course, and a change to a course first added elsewhere
+    coms.createCourse("4995", "Brian Borowski", "833 MUDD", "1:10-2:25", 60);
+    EXPECT_NE(std::string::npos, coms.display().find("COMS 4995"));
+    Department econ("ECON", {}, "Michael Woodford", 2345);
+    econ.addCourse("4156", twoCourses["4156"]);
+    std::shared_ptr<const std::string> before = econ.displayText();
+    twoCourses["4156"]->reassignTime("2:40-3:55");
+    EXPECT_NE(before.get(), econ.displayText().get());
+    EXPECT_EQ("ECON 4156: \nInstructor: Adam Cannon; Location: 501 NWC; Time: 2:40-3:55\n", econ.display());
+
+    // assigning another department leaves no stale text behind
+    econ = coms;
+    EXPECT_EQ(coms.display(), econ.display());
+}
+
+TEST_F(DepartmentUnitTests, CourseTotalsTest) {
+    expectTotals(recompute(*phys), phys->getCourseTotals());
+
+    std::map<std::string, std::shared_ptr<Course>> twoCourses;
+    twoCourses["4156"] = std::make_shared<Course>(2, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    twoCourses["3157"] = std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25");
+    Department coms("COMS", twoCourses, "Luca Carloni", 2700);
+    twoCourses["4156"]->enrollStudent();
+    twoCourses["4156"]->enrollStudent();
+    twoCourses["3157"]->setEnrolledStudentCount(250);
+    DepartmentTotals::Values totals = coms.getCourseTotals();
+    EXPECT_EQ(252, totals.enrolled);
+    EXPECT_DOUBLE_EQ(252.0 / 402, totals.getFillRate());
+    EXPECT_EQ(1u, totals.fullCourses);
+    twoCourses["4156"]->dropStudent();
+    coms.createCourse("1004", "Adam Cannon", "417 IAB", "1:10-2:25", 10);
+    expectTotals(DepartmentTotals::Values{3, 412, 251, 0}, coms.getCourseTotals());
+
+    // copies share the totals of their courses
+    Department copy(coms);
+    coms.findCourse("1004")->setEnrolledStudentCount(10);
+    expectTotals(DepartmentTotals::Values{3, 412, 261, 1}, copy.getCourseTotals());
+
+    // re-reading a course moves its capacity and count
+    std::stringstream stored;
+    Course(40, "Gail Kaiser", "501 NWC", "10:10-11:25").serialize(stored);
+    twoCourses["4156"]->deserialize(stored);
+    expectTotals(DepartmentTotals::Values{3, 450, 260, 1}, coms.getCourseTotals());
+
+    // once the table holds other courses than the totals count, the courses are added up
+    coms.addCourse("4156", std::make_shared<Course>(5, "Gail Kaiser", "501 NWC", "10:10-11:25"));
+    copy.createCourse("4995", "Brian Borowski", "301 URIS", "6:10-7:25", 50);
+    expectTotals(recompute(coms), coms.getCourseTotals());
+    expectTotals(recompute(copy), copy.getCourseTotals());
+    Department econ("ECON", {}, "Michael Woodford", 2345);
+    econ.addCourse("4156", twoCourses["4156"]);
+    expectTotals(DepartmentTotals::Values{1, 40, 0, 0}, econ.getCourseTotals());
+}
+
+TEST_F(DepartmentUnitTests, ConcurrentCourseTotalsTest) {
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    for (int i = 0; i < 40; ++i) {
+        courses[std::to_string(1000 + i)] = std::make_shared<Course>(5 + i % 7, "Jae Lee", "417 IAB", "4:10-5:25");
+    }
+    Department dept("COMS", courses, "Luca Carloni", 0);
+
+    std::atomic<bool> done(false);
+    std::thread reader([&dept, &done]() {
+        while (!done.load()) {
+            DepartmentTotals::Values totals = dept.getCourseTotals();
+            EXPECT_LE(totals.fullCourses, totals.courseCount);
+            EXPECT_GE(totals.enrolled, 0);
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 6; ++t) {
+        writers.emplace_back([&dept, &courses, t]() {
+            for (int i = 0; i < 3000; ++i) {
+                Course& course = *courses.at(std::to_string(1000 + (i * 7 + t) % 40));
+                switch ((i + t) % 4) {
+                    case 0:
+                    case 1:
+                        course.enrollStudent();
+                        break;
+                    case 2:
+                        course.dropStudent();
+                        break;
+                    default:
+                        course.setEnrolledStudentCount(i % 5);
+                }
+                if (i % 500 == 0) {
+                    dept.createCourse(std::to_string(2000 + t * 10 + i / 500), "Adam Cannon", "309 HAV",
+                                      "1:10-2:25", i % 3);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    reader.join();
+
+    DepartmentTotals::Values totals = dept.getCourseTotals();
+    EXPECT_EQ(76u, totals.courseCount);
+    expectTotals(recompute(dept), totals);
+}
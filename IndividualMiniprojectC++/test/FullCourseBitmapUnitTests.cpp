@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FullCourseBitmap.h"
+#include "TestSupport.h"
+
+using testsupport::names;
+
+class FullCourseBitmapUnitTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 70 COMS courses so the department runs into a second word
+        for (int i = 0; i < 70; ++i) {
+            auto course = std::make_shared<Course>(2, "Jae Lee", "417 IAB", "4:10-5:25");
+            course->setEnrolledStudentCount(i % 30 == 0 ? 2 : 1);
+            coms.set(std::to_string(1000 + i), course);
+        }
+        phys.set("1221", std::make_shared<Course>(1, "James G. Mccann", "301 PUP", "4:10-5:25"));
+        phys.set("2000", std::make_shared<Course>(1, "Frank E. L. Banta", "402 CHANDLER", "1:10-3:40"));
+        phys.findCourse("2000")->setEnrolledStudentCount(1);
+        bitmap.addDepartment("COMS", coms);
+        bitmap.addDepartment("PHYS", phys);
+    }
+
+    CourseTable coms;
+    CourseTable phys;
+    FullCourseBitmap bitmap;
+};
+
+TEST_F(FullCourseBitmapUnitTests, FindFullTest) {
+    EXPECT_EQ(72u, bitmap.size());
+    EXPECT_EQ(4u, bitmap.countFull());
+    EXPECT_EQ((std::vector<std::string>{"COMS 1000", "COMS 1030", "COMS 1060", "PHYS 2000"}),
+              names(bitmap.findFull()));
+    EXPECT_EQ((std::vector<std::string>{"PHYS 2000"}), names(bitmap.findFull("PHYS")));
+    std::vector<CourseRef> full = bitmap.findFull("COMS");
+    ASSERT_EQ(3u, full.size());
+    EXPECT_EQ(coms.findCourse("1060"), full[2].course);
+    EXPECT_TRUE(bitmap.findFull("ECON").empty());
+}
+
+TEST_F(FullCourseBitmapUnitTests, RefreshTest) {
+    Course* coms1069 = coms.findCourse("1069");
+    coms1069->enrollStudent();
+    bitmap.refresh(coms1069);
+    coms.findCourse("1000")->dropStudent();
+    bitmap.refresh(coms.findCourse("1000"));
+    phys.findCourse("1221")->setEnrolledStudentCount(1);
+    bitmap.refresh(phys.findCourse("1221"));
+    EXPECT_EQ((std::vector<std::string>{"COMS 1030", "COMS 1060", "COMS 1069"}), names(bitmap.findFull("COMS")));
+    EXPECT_EQ((std::vector<std::string>{"PHYS 1221", "PHYS 2000"}), names(bitmap.findFull("PHYS")));
+    EXPECT_EQ(5u, bitmap.countFull());
+
+    // courses that were never added are ignored
+    Course other(1, "Jae Lee", "417 IAB", "4:10-5:25");
+    other.enrollStudent();
+    bitmap.refresh(&other);
+    EXPECT_EQ(5u, bitmap.countFull());
+}
+
+TEST_F(FullCourseBitmapUnitTests, ConcurrentRefreshTest) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([this, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                Course* course = coms.findCourse(std::to_string(1000 + (i + t) % 8));
+                if ((i + t) % 3 == 0) {
+                    course->dropStudent();
+                } else {
+                    course->enrollStudent();
+                }
+                bitmap.refresh(course);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::vector<std::string> expected;
+    for (const auto& it : coms) {
+        if (it.second->isCourseFull()) {
+            expected.push_back("COMS " + it.first);
+        }
+    }
+    EXPECT_EQ(expected, names(bitmap.findFull("COMS")));
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "JsonWriter.h"
+
+TEST(JsonWriterUnitTests, NestingTest) {
+    std::string out = "prefix ";
+    JsonWriter writer(out);
+    writer.beginObject()
+        .field("deptCode", "COMS")
+        .field("majors", 2700)
+        .key("courses")
+        .beginArray()
+        .beginObject()
+        .field("courseCode", std::string("4156"))
+        .field("full", false)
+        .endObject()
+        .beginObject()
+        .endObject()
+        .endArray()
+        .key("rooms")
+        .beginArray()
+        .endArray()
+        .key("none")
+        .null()
+        .endObject();
+    EXPECT_EQ("prefix {\"deptCode\":\"COMS\",\"majors\":2700,\"courses\":[{\"courseCode\":\"4156\",\"full\":false},{}],"
+              "\"rooms\":[],\"none\":null}", out);
+}
+
+TEST(JsonWriterUnitTests, ValueTest) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.beginArray()
+        .value(std::numeric_limits<int64_t>::min())
+        .value(std::numeric_limits<uint64_t>::max())
+        .value(size_t(0))
+        .value(true)
+        .value(0.875)
+        .value(std::numeric_limits<double>::infinity())
+        .endArray();
+    EXPECT_EQ("[-9223372036854775808,18446744073709551615,0,true,0.875,null]", out);
+}
+
+TEST(JsonWriterUnitTests, EscapeTest) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.beginObject().field("a\"b", std::string("say \"hi\"\\\n\t\x01 caf\xc3\xa9")).endObject();
+    EXPECT_EQ("{\"a\\\"b\":\"say \\\"hi\\\"\\\\\\n\\t\\u0001 caf\xc3\xa9\"}", out);
+}
@@ -0,0 +1,305 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MutationLog.h"
+#include "MyFileDatabase.h"
+
+class MutationLogUnitTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::remove(logPath);
+        MyFileDatabase::removeDataFiles(snapshotPath);
+    }
+
+    void TearDown() override {
+        std::remove(logPath);
+        MyFileDatabase::removeDataFiles(snapshotPath);
+    }
+
+    static std::vector<MutationRecord> replayAll(uint64_t afterLsn = 0) {
+        std::vector<MutationRecord> records;
+        MutationLog::replay(logPath, afterLsn, [&records](const MutationRecord& record) {
+            records.push_back(record);
+        });
+        return records;
+    }
+
+    static MyFileDatabase* makePhysDatabase() {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        courses["1221"] = std::make_shared<Course>(150, "James G. Mccann", "301 PUP", "4:10-5:25");
+        courses["1221"]->setEnrolledStudentCount(118);
+        std::map<std::string, Department> mapping;
+        mapping["PHYS"] = Department("PHYS", courses, "Marcia L. Newson", 200);
+
+        MyFileDatabase* database = new MyFileDatabase(1, snapshotPath);
+        database->setMapping(mapping);
+        return database;
+    }
+
+    static const char* logPath;
+    static const char* snapshotPath;
+};
+
+const char* MutationLogUnitTests::logPath = "mutationlog_test.wal";
+const char* MutationLogUnitTests::snapshotPath = "mutationlog_test.bin";
+
+TEST_F(MutationLogUnitTests, AppendAndReplayTest) {
+    {
+        MutationLog log(logPath, MutationLog::Options(), 0);
+        EXPECT_EQ(1u, log.append(MutationRecord::forDepartment(MutationType::AddMajor, "COMS")));
+        uint64_t lsn = log.append(MutationRecord::forCourse(MutationType::SetCourseLocation, "COMS", "4156", 0, "501 NWC"));
+        log.waitDurable(lsn);
+        EXPECT_EQ(2u, log.getLastLsn());
+    }
+
+    auto records = replayAll();
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(MutationType::AddMajor, records[0].type);
+    EXPECT_EQ("COMS", records[0].deptCode);
+    EXPECT_EQ(MutationType::SetCourseLocation, records[1].type);
+    EXPECT_EQ("4156", records[1].courseId);
+    EXPECT_EQ("501 NWC", records[1].text);
+
+    // records already in the snapshot are skipped
+    EXPECT_EQ(1u, replayAll(1).size());
+}
+
+TEST_F(MutationLogUnitTests, TornRecordIsIgnoredTest) {
+    {
+        MutationLog log(logPath, MutationLog::Options(), 0);
+        log.waitDurable(log.append(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "COMS", "4156", 42)));
+    }
+    {
+        std::ofstream out(logPath, std::ios::binary | std::ios::app);
+        out.write("\x30\x00\x00\x00garbage", 11);
+    }
+    ASSERT_EQ(1u, replayAll().size());
+
+    // reopening cuts the torn record off so new records remain reachable
+    {
+        MutationLog log(logPath, MutationLog::Options(), 1);
+        log.waitDurable(log.append(MutationRecord::forCourse(MutationType::DropStudent, "COMS", "4156")));
+    }
+    auto records = replayAll();
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(42, records[0].value);
+    EXPECT_EQ(MutationType::DropStudent, records[1].type);
+}
+
+TEST_F(MutationLogUnitTests, BatchIsReplayedWholeTest) {
+    std::vector<MutationRecord> batch = {
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "COMS", "4156", 0, "501 NWC"),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "COMS", "4156", 42),
+        MutationRecord::forCourse(MutationType::SetCourseTime, "COMS", "3157", 0, "4:10-5:25"),
+    };
+    {
+        MutationLog log(logPath, MutationLog::Options(), 0);
+        log.waitDurable(log.append(MutationRecord::forDepartment(MutationType::AddMajor, "COMS")));
+        EXPECT_EQ(2u, log.appendBatch(batch));
+        log.waitDurable(log.append(MutationRecord::forDepartment(MutationType::AddMajor, "COMS")));
+        EXPECT_TRUE(log.discardThrough(1));
+    }
+    auto records = replayAll();
+    ASSERT_EQ(4u, records.size());
+    EXPECT_EQ("501 NWC", records[0].text);
+    EXPECT_EQ(42, records[1].value);
+    EXPECT_EQ("3157", records[2].courseId);
+    EXPECT_EQ(MutationType::AddMajor, records[3].type);
+    EXPECT_EQ(1u, replayAll(2).size());
+
+    // a batch cut short by a crash is not replayed at all
+    {
+        MutationLog log(logPath, MutationLog::Options(), 3);
+        log.waitDurable(log.appendBatch(batch));
+    }
+    {
+        std::ifstream full(logPath, std::ios::binary);
+        std::string withBatch((std::istreambuf_iterator<char>(full)), std::istreambuf_iterator<char>());
+        std::ofstream out(logPath, std::ios::binary | std::ios::trunc);
+        out.write(withBatch.data(), withBatch.size() - 5);
+    }
+    EXPECT_EQ(4u, replayAll().size());
+}
+
+TEST_F(MutationLogUnitTests, SyncPolicyTest) {
+    MutationLog::Options options = MutationLog::parseOptions("write");
+    EXPECT_EQ(MutationLog::SyncPolicy::EveryWrite, options.policy);
+    EXPECT_EQ(MutationLog::SyncPolicy::EveryBatch, MutationLog::parseOptions("batch").policy);
+    options = MutationLog::parseOptions("25ms");
+    EXPECT_EQ(MutationLog::SyncPolicy::Interval, options.policy);
+    EXPECT_EQ(25, options.intervalMs);
+    EXPECT_THROW(MutationLog::parseOptions("sometimes"), std::invalid_argument);
+
+    MutationLog log(logPath, MutationLog::parseOptions("write"), 0);
+    for (int i = 0; i < 5; ++i) {
+        log.append(MutationRecord::forDepartment(MutationType::AddMajor, "COMS"));
+    }
+    EXPECT_EQ(5u, log.getSyncCount());
+}
+
+TEST_F(MutationLogUnitTests, GroupCommitTest) {
+    MutationLog log(logPath, MutationLog::parseOptions("batch"), 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&log]() {
+            for (int i = 0; i < 50; ++i) {
+                log.waitDurable(log.append(MutationRecord::forDepartment(MutationType::AddMajor, "COMS")));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(400u, log.getLastLsn());
+    EXPECT_LE(log.getSyncCount(), 400u);
+    EXPECT_EQ(400u, replayAll().size());
+}
+
+TEST_F(MutationLogUnitTests, ReplayOnTopOfSnapshotTest) {
+    MyFileDatabase* database = makePhysDatabase();
+    database->saveContentsToFile();
+    database->enableMutationLog(logPath, MutationLog::Options());
+
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "1221", 0, "402 CHANDLER")));
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(
+        MutationRecord::forCourse(MutationType::EnrollStudent, "PHYS", "1221")));
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(
+        MutationRecord::forDepartment(MutationType::AddMajor, "PHYS")));
+    EXPECT_EQ(MutationResult::CourseNotFound, database->commitMutation(
+        MutationRecord::forCourse(MutationType::EnrollStudent, "PHYS", "0000")));
+    EXPECT_EQ(3u, database->getMutationLog()->getLastLsn());
+    delete database;    // simulated crash: the snapshot was never rewritten
+
+    MyFileDatabase recovered(0, snapshotPath);
+    recovered.enableMutationLog(logPath, MutationLog::Options());
+    Course* course = recovered.findCourse("PHYS", "1221");
+    ASSERT_NE(course, nullptr);
+    EXPECT_EQ("402 CHANDLER", course->getCourseLocation());
+    EXPECT_EQ(119, course->getEnrolledStudentCount());
+    EXPECT_EQ(201, recovered.findDepartment("PHYS")->getNumberOfMajors());
+
+    // a save covers the whole log, which is then emptied and never replayed twice
+    recovered.saveContentsToFile();
+    EXPECT_TRUE(replayAll().empty());
+    MyFileDatabase reloaded(0, snapshotPath);
+    reloaded.enableMutationLog(logPath, MutationLog::Options());
+    EXPECT_EQ(119, reloaded.findCourse("PHYS", "1221")->getEnrolledStudentCount());
+    EXPECT_EQ(3u, reloaded.getMutationLog()->getLastLsn());
+}
+
+TEST_F(MutationLogUnitTests, BatchReplayOnTopOfSnapshotTest) {
+    MyFileDatabase* database = makePhysDatabase();
+    database->saveContentsToFile();
+    database->enableMutationLog(logPath, MutationLog::Options());
+    BatchResult result = database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "1221", 0, "402 CHANDLER"),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", 120),
+        MutationRecord::forCourse(MutationType::SetCourseInstructor, "PHYS", "1221", 0, "Jae Lee"),
+    });
+    EXPECT_EQ(MutationResult::Applied, result.result);
+    EXPECT_EQ(MutationResult::CourseNotFound, database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", 0),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "0000", 0),
+    }).result);
+    EXPECT_EQ(1u, database->getMutationLog()->getLastLsn());
+    delete database;    // simulated crash: the snapshot was never rewritten
+
+    MyFileDatabase recovered(0, snapshotPath);
+    recovered.enableMutationLog(logPath, MutationLog::Options());
+    Course* course = recovered.findCourse("PHYS", "1221");
+    ASSERT_NE(course, nullptr);
+    EXPECT_EQ("402 CHANDLER", course->getCourseLocation());
+    EXPECT_EQ(120, course->getEnrolledStudentCount());
+    EXPECT_EQ("Jae Lee", course->getInstructorName());
+}
+
+TEST_F(MutationLogUnitTests, DiscardThroughKeepsNewerRecordsTest) {
+    MutationLog log(logPath, MutationLog::Options(), 0);
+    for (int i = 0; i < 5; ++i) {
+        log.waitDurable(log.append(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "COMS", "4156", i)));
+    }
+    EXPECT_TRUE(log.discardThrough(3));
+    EXPECT_FALSE(log.discardThrough(3));
+
+    // the log keeps working after being replaced
+    log.waitDurable(log.append(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "COMS", "4156", 5)));
+    auto records = replayAll();
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ(3, records[0].value);
+    EXPECT_EQ(5, records[2].value);
+    EXPECT_EQ(6u, log.getLastLsn());
+}
+
+TEST_F(MutationLogUnitTests, CheckpointUnderLoadTest) {
+    MyFileDatabase* database = makePhysDatabase();
+    database->saveContentsToFile();
+    database->enableMutationLog(logPath, MutationLog::parseOptions("1ms"));
+
+    std::atomic<int> finished{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([database, &finished, t]() {
+            const std::string locations[] = {"301 PUP", "402 CHANDLER", "833 MUDD", "428 PUP"};
+            for (int i = 0; i < 5000; ++i) {
+                database->commitMutation(MutationRecord::forCourse(
+                    i % 2 ? MutationType::EnrollStudent : MutationType::DropStudent, "PHYS", "1221"));
+                database->commitMutation(MutationRecord::forCourse(
+                    MutationType::SetCourseLocation, "PHYS", "1221", 0, locations[(i + t) % 4]));
+                database->commitMutation(MutationRecord::forDepartment(MutationType::AddMajor, "PHYS"));
+            }
+            ++finished;
+        });
+    }
+    do {
+        database->saveContentsToFile();
+    } while (finished < 4);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GE(database->getCheckpointCount(), 2u);
+
+    // every checkpoint plus the records after it adds up to the live state
+    Course* live = database->findCourse("PHYS", "1221");
+    std::string location = live->getCourseLocation();
+    int enrolled = live->getEnrolledStudentCount();
+    int majors = database->findDepartment("PHYS")->getNumberOfMajors();
+    database->getMutationLog()->flush();
+    delete database;
+
+    MyFileDatabase recovered(0, snapshotPath);
+    recovered.enableMutationLog(logPath, MutationLog::Options());
+    EXPECT_EQ(location, recovered.findCourse("PHYS", "1221")->getCourseLocation());
+    EXPECT_EQ(enrolled, recovered.findCourse("PHYS", "1221")->getEnrolledStudentCount());
+    EXPECT_EQ(majors, recovered.findDepartment("PHYS")->getNumberOfMajors());
+}
+
+TEST_F(MutationLogUnitTests, BackgroundCheckpointTest) {
+    MyFileDatabase* database = makePhysDatabase();
+    database->saveContentsToFile();
+    database->enableMutationLog(logPath, MutationLog::Options());
+    MyFileDatabase::CheckpointOptions options;
+    options.everyMutations = 10;
+    database->startCheckpointer(options);
+
+    for (int i = 0; i < 10; ++i) {
+        database->commitMutation(MutationRecord::forDepartment(MutationType::AddMajor, "PHYS"));
+    }
+    for (int i = 0; i < 500 && database->getCheckpointCount() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(2u, database->getCheckpointCount());
+    EXPECT_TRUE(replayAll().empty());
+    delete database;
+
+    MyFileDatabase reloaded(0, snapshotPath);
+    EXPECT_EQ(210, reloaded.findDepartment("PHYS")->getNumberOfMajors());
+}
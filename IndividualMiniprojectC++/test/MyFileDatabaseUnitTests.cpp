@@ -46,3 +46,298 @@ TEST_F(MyFileDatabaseTest, GetDepartmentMapping) {
         EXPECT_EQ(pair.second.display(), it->second.display());
     }
 }
+
+TEST_F(MyFileDatabaseTest, FindDepartment) {
+    const Department* dept = database->findDepartment("PHYS");
+    ASSERT_NE(dept, nullptr);
+    EXPECT_EQ(dept->getDepartmentChair(), "Marcia L. Newson");
+
+    EXPECT_EQ(database->findDepartment("NOTFOUND"), nullptr);
+}
+
+TEST_F(MyFileDatabaseTest, FindCourse) {
+    Course* course = database->findCourse("PHYS", "2000");
+    ASSERT_NE(course, nullptr);
+    EXPECT_EQ(course->getInstructorName(), "Frank E. L. Banta");
+
+    // lookups return the stored course, not a copy
+    course->reassignLocation("301 PUP");
+    EXPECT_EQ(database->findCourse("PHYS", "2000")->getCourseLocation(), "301 PUP");
+
+    EXPECT_EQ(database->findCourse("PHYS", "0000"), nullptr);
+    EXPECT_EQ(database->findCourse("NOTFOUND", "2000"), nullptr);
+}
+
+TEST_F(MyFileDatabaseTest, FindCourseByNumberTest) {
+    EXPECT_EQ(database->findCourse("PHYS", "1221"), database->findCourse("PHYS", 1221));
+    ASSERT_NE(database->findCourse("PHYS", 1221), nullptr);
+    EXPECT_EQ(database->findCourse("PHYS", 1221)->getInstructorName(), "James G. Mccann");
+    EXPECT_EQ(database->findCourse("PHYS", 1222), nullptr);
+    EXPECT_EQ(database->findCourse("PHYS", -1221), nullptr);
+    EXPECT_EQ(database->findCourse("NOTFOUND", 1221), nullptr);
+
+    // courses the index does not hold are still found through their department
+    Department* phys = database->findDepartment("PHYS");
+    phys->createCourse("4040", "Jae Lee", "417 IAB", "4:10-5:25", 50);
+    phys->createCourse("0500", "Jae Lee", "417 IAB", "4:10-5:25", 50);
+    ASSERT_NE(database->findCourse("PHYS", 4040), nullptr);
+    EXPECT_EQ(database->findCourse("PHYS", 4040), database->findCourse("PHYS", "4040"));
+    ASSERT_NE(database->findCourse("PHYS", "0500"), nullptr);
+    EXPECT_EQ(database->findCourse("PHYS", 500), nullptr);
+
+    // mutations find their course through the index too
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::EnrollStudent, "PHYS", "1221")));
+    EXPECT_EQ(119, database->findCourse("PHYS", 1221)->getEnrolledStudentCount());
+    EXPECT_EQ(MutationResult::CourseNotFound, database->commitMutation(MutationRecord::forCourse(
+        MutationType::EnrollStudent, "PHYS", "1222")));
+    EXPECT_EQ(MutationResult::DepartmentNotFound, database->commitMutation(MutationRecord::forCourse(
+        MutationType::EnrollStudent, "CHEM", "1221")));
+}
+
+TEST_F(MyFileDatabaseTest, FindCoursesTest) {
+    std::vector<CourseLookup> lookups = {
+        {"PHYS", 2000, nullptr, nullptr},
+        {"CHEM", 1221, nullptr, nullptr},
+        {"PHYS", 1222, nullptr, nullptr},
+        {"PHYS", 1221, nullptr, nullptr},
+    };
+    database->findCourses(lookups);
+
+    // results stay in the order asked, whatever shard each department is in
+    EXPECT_EQ(database->findCourse("PHYS", 2000), lookups[0].course);
+    EXPECT_EQ(database->findDepartment("PHYS"), lookups[0].department);
+    EXPECT_EQ(nullptr, lookups[1].department);
+    EXPECT_EQ(nullptr, lookups[1].course);
+    EXPECT_EQ(database->findDepartment("PHYS"), lookups[2].department);
+    EXPECT_EQ(nullptr, lookups[2].course);
+    EXPECT_EQ(database->findCourse("PHYS", 1221), lookups[3].course);
+
+    // courses the index does not hold are found through their department
+    database->findDepartment("PHYS")->createCourse("4040", "Jae Lee", "417 IAB", "4:10-5:25", 50);
+    std::vector<CourseLookup> added = {{"PHYS", 4040, nullptr, nullptr}};
+    database->findCourses(added);
+    EXPECT_EQ(database->findCourse("PHYS", "4040"), added[0].course);
+}
+
+TEST_F(MyFileDatabaseTest, QueryCoursesTest) {
+    CourseColumns::Condition full;
+    ASSERT_TRUE(CourseColumns::Condition::parse("fill>0.95", full));
+    CourseColumns::Condition afternoon;
+    ASSERT_TRUE(CourseColumns::Condition::parse("time=4:10-5:25", afternoon));
+
+    std::vector<CourseMatch> matches = database->queryCourses({full});
+    ASSERT_EQ(1u, matches.size());
+    EXPECT_EQ("PHYS", matches[0].deptCode);
+    EXPECT_EQ("2000", matches[0].courseId);
+    EXPECT_EQ(98, matches[0].enrolledStudentCount);
+    EXPECT_EQ(100, matches[0].enrollmentCapacity);
+    EXPECT_EQ(2u, database->queryCourses({afternoon}).size());
+
+    // changes made through commitMutation show up in the next query
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetEnrollmentCount, "PHYS", "1221", 149)));
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseTime, "PHYS", "3801", 0, "10:10-11:25")));
+    matches = database->queryCourses({full, afternoon});
+    ASSERT_EQ(1u, matches.size());
+    EXPECT_EQ("1221", matches[0].courseId);
+    EXPECT_EQ(149, matches[0].enrolledStudentCount);
+    EXPECT_EQ(1u, database->queryCourses({afternoon}).size());
+    EXPECT_EQ(3u, database->queryCourses({}).size());
+}
+
+TEST_F(MyFileDatabaseTest, FindCoursesByTest) {
+    std::vector<CourseRef> afternoon = database->findCoursesBy(CourseAttributeIndex::Attribute::TimeSlot, "4:10-5:25");
+    ASSERT_EQ(2u, afternoon.size());
+    EXPECT_EQ("1221", afternoon[0].courseId);
+    EXPECT_EQ("3801", afternoon[1].courseId);
+    EXPECT_EQ(database->findCourse("PHYS", "3801"), afternoon[1].course);
+
+    // reassignments made through commitMutation move the course in the index
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseInstructor, "PHYS", "2000", 0, "James G. Mccann")));
+    std::vector<CourseRef> mccann = database->findCoursesBy(CourseAttributeIndex::Attribute::Instructor,
+                                                            "James G. Mccann");
+    ASSERT_EQ(2u, mccann.size());
+    EXPECT_EQ("2000", mccann[1].courseId);
+    EXPECT_TRUE(database->findCoursesBy(CourseAttributeIndex::Attribute::Instructor, "Frank E. L. Banta").empty());
+    EXPECT_EQ(1u, database->findCoursesBy(CourseAttributeIndex::Attribute::Location, "402 CHANDLER").size());
+}
+
+TEST_F(MyFileDatabaseTest, SearchValuesTest) {
+    using Attribute = CourseAttributeIndex::Attribute;
+    std::vector<CourseAttributeIndex::SearchHit> hits = database->searchValues(Attribute::Instructor, "Mc", 10);
+    ASSERT_EQ(2u, hits.size());
+    EXPECT_EQ("James G. Mccann", hits[0].value);
+    EXPECT_EQ("Katherine M. McMahon", hits[1].value);
+
+    // an instructor given a course through commitMutation can be found, and ranks by courses
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseInstructor, "PHYS", "2000", 0, "Katherine M. McMahon")));
+    hits = database->searchValues(Attribute::Instructor, "Mc", 10);
+    ASSERT_EQ(2u, hits.size());
+    EXPECT_EQ("Katherine M. McMahon", hits[0].value);
+    EXPECT_EQ(2u, hits[0].courseCount);
+    EXPECT_TRUE(database->searchValues(Attribute::Instructor, "Banta", 10).empty());
+    EXPECT_EQ("603 MUDD", database->searchValues(Attribute::Location, "mud", 10).at(0).value);
+}
+
+TEST_F(MyFileDatabaseTest, FindFullCoursesTest) {
+    EXPECT_TRUE(database->findFullCourses().empty());
+
+    // enrollment changes made through commitMutation flip the course's bit
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetEnrollmentCount, "PHYS", "2000", 99)));
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::EnrollStudent, "PHYS", "2000", 0)));
+    std::vector<CourseRef> full = database->findFullCourses();
+    ASSERT_EQ(1u, full.size());
+    EXPECT_EQ("PHYS", full[0].deptCode);
+    EXPECT_EQ("2000", full[0].courseId);
+    EXPECT_EQ(1u, database->findFullCourses("PHYS").size());
+    EXPECT_TRUE(database->findFullCourses("COMS").empty());
+
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::DropStudent, "PHYS", "2000", 0)));
+    EXPECT_TRUE(database->findFullCourses("PHYS").empty());
+}
+
+TEST_F(MyFileDatabaseTest, CommitMutationsTest) {
+    Course* phys1221 = database->findCourse("PHYS", 1221);
+    Course* phys3801 = database->findCourse("PHYS", 3801);
+
+    // PHYS 1221 and 3801 both meet 4:10-5:25; moving them into one room together clashes
+    BatchResult result = database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetCourseInstructor, "PHYS", "1221", 0, "Jae Lee"),
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "1221", 0, "417 IAB"),
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "3801", 0, "417 IAB"),
+    });
+    EXPECT_EQ(MutationResult::Rejected, result.result);
+    EXPECT_EQ(2u, result.failedIndex);
+    EXPECT_EQ("James G. Mccann", phys1221->getInstructorName());
+    EXPECT_EQ("301 PUP", phys1221->getCourseLocation());
+
+    result = database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", 150),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "0000", 1),
+    });
+    EXPECT_EQ(MutationResult::CourseNotFound, result.result);
+    EXPECT_EQ(1u, result.failedIndex);
+    EXPECT_EQ(118, phys1221->getEnrolledStudentCount());
+    EXPECT_EQ(MutationResult::Rejected, database->commitMutations({
+        MutationRecord::forCourse(MutationType::EnrollStudent, "PHYS", "1221")}).result);
+
+    // moving one of them to another time first makes room for both
+    result = database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetCourseInstructor, "PHYS", "1221", 0, "Jae Lee"),
+        MutationRecord::forCourse(MutationType::SetCourseTime, "PHYS", "3801", 0, "1:10-2:25"),
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "1221", 0, "417 IAB"),
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "3801", 0, "417 IAB"),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", 150),
+    });
+    EXPECT_EQ(MutationResult::Applied, result.result);
+    EXPECT_EQ("Jae Lee", phys1221->getInstructorName());
+    EXPECT_EQ("417 IAB", phys3801->getCourseLocation());
+    EXPECT_EQ("1:10-2:25", phys3801->getCourseTimeSlot());
+    EXPECT_EQ(1u, database->findCoursesBy(CourseAttributeIndex::Attribute::Instructor, "Jae Lee").size());
+    EXPECT_EQ(2u, database->findCoursesBy(CourseAttributeIndex::Attribute::Location, "417 IAB").size());
+    EXPECT_EQ(1u, database->findFullCourses("PHYS").size());
+    EXPECT_EQ((std::vector<std::string>{"301 PUP", "402 CHANDLER", "603 MUDD"}),
+              database->findFreeRooms(TimeInterval::parse("4:30-4:31")));
+    EXPECT_EQ(MutationResult::Rejected, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseTime, "PHYS", "1221", 0, "1:30-2:00")));
+
+    // a rejected batch leaves its new locations out of the string pool
+    size_t pooled = StringPool::size();
+    result = database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetCourseLocation, "PHYS", "2000", 0, "1 Batch Rejected Hall"),
+        MutationRecord::forCourse(MutationType::SetCourseTime, "PHYS", "1221", 0, "1:30-2:00"),
+    });
+    EXPECT_EQ(MutationResult::Rejected, result.result);
+    EXPECT_EQ(nullptr, StringPool::find("1 Batch Rejected Hall"));
+    EXPECT_EQ(pooled, StringPool::size());
+}
+
+TEST_F(MyFileDatabaseTest, FindCoursesMeetingTest) {
+    std::vector<CourseRef> afternoon = database->findCoursesMeeting(TimeInterval::parse("2:00-4:30"));
+    ASSERT_EQ(3u, afternoon.size());
+    EXPECT_EQ("1221", afternoon[0].courseId);
+    EXPECT_EQ("2000", afternoon[1].courseId);
+    EXPECT_EQ("3801", afternoon[2].courseId);
+
+    // time changes made through commitMutation move the course in the index
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseTime, "PHYS", "2000", 0, "6:10-9:50")));
+    EXPECT_EQ(2u, database->findCoursesMeeting(TimeInterval::parse("2:00-4:30")).size());
+    std::vector<CourseRef> evening = database->findCoursesMeeting(TimeInterval::parse("8:00-8:30"));
+    EXPECT_TRUE(evening.empty());
+    evening = database->findCoursesMeeting(TimeInterval::parse("20:00-20:30"));
+    ASSERT_EQ(1u, evening.size());
+    EXPECT_EQ("2000", evening[0].courseId);
+}
+
+TEST_F(MyFileDatabaseTest, RoomConflictTest) {
+    // 301 PUP holds PHYS 1221 at 4:10-5:25
+    EXPECT_EQ(MutationResult::Rejected, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseLocation, "PHYS", "3801", 0, "301 PUP")));
+    EXPECT_EQ("603 MUDD", database->findCourse("PHYS", "3801")->getCourseLocation());
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseTime, "PHYS", "2000", 0, "10:10-11:25")));
+    EXPECT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseLocation, "PHYS", "2000", 0, "301 PUP")));
+    EXPECT_EQ(MutationResult::Rejected, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetCourseTime, "PHYS", "1221", 0, "11:00-12:15")));
+    EXPECT_EQ("4:10-5:25", database->findCourse("PHYS", "1221")->getCourseTimeSlot());
+
+    std::vector<std::string> free = database->findFreeRooms(TimeInterval::parse("10:30-11:00"));
+    EXPECT_EQ((std::vector<std::string>{"402 CHANDLER", "603 MUDD"}), free);
+    free = database->findFreeRooms(TimeInterval::parse("4:30-5:00"));
+    EXPECT_EQ((std::vector<std::string>{"402 CHANDLER"}), free);
+}
+
+TEST_F(MyFileDatabaseTest, ShardedLookupAndDisplayTest) {
+    std::map<std::string, Department> many;
+    for (int i = 0; i < 200; ++i) {
+        std::string code = "D" + std::to_string(1000 + i);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        courses["1001"] = std::make_shared<Course>(10 + i, "Jae Lee", "417 IAB", "4:10-5:25");
+        many[code] = Department(code, courses, "Chair", i);
+    }
+
+    MyFileDatabase sharded(1, "", 16);
+    MyFileDatabase single(1, "", 1);
+    sharded.setMapping(many);
+    single.setMapping(many);
+    EXPECT_EQ(200u, sharded.getDepartmentCount());
+    for (int i = 0; i < 200; ++i) {
+        const Department* dept = sharded.findDepartment("D" + std::to_string(1000 + i));
+        ASSERT_NE(dept, nullptr);
+        EXPECT_EQ(i, dept->getNumberOfMajors());
+    }
+    EXPECT_EQ(nullptr, sharded.findDepartment("PHYS"));
+
+    // shards are rendered in parallel but the output stays in department order
+    EXPECT_EQ(single.display(), sharded.display());
+    EXPECT_LT(sharded.display().find("D1000"), sharded.display().find("D1199"));
+    EXPECT_EQ(200u, sharded.getDepartmentMapping().size());
+}
+
+TEST_F(MyFileDatabaseTest, WriteJsonTest) {
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::map<std::string, Department> mapping;
+    mapping["ECON"] = Department("ECON", {}, "Michael Woodford", 2345);
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    MyFileDatabase database(1, "", 4);
+    database.setMapping(mapping);
+
+    std::string out;
+    JsonWriter writer(out);
+    database.writeJson(writer);
+    EXPECT_EQ("{\"COMS\":{\"deptCode\":\"COMS\",\"chair\":\"Luca Carloni\",\"majors\":2700,\"courses\":["
+              "{\"courseCode\":\"4156\",\"instructor\":\"Gail Kaiser\",\"location\":\"501 NWC\","
+              "\"time\":\"10:10-11:25\",\"capacity\":120,\"enrolled\":0}]},"
+              "\"ECON\":{\"deptCode\":\"ECON\",\"chair\":\"Michael Woodford\",\"majors\":2345,\"courses\":[]}}",
+              out);
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RoomOccupancy.h"
+
+class RoomOccupancyUnitTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        courses.set("1004", std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55"));
+        courses.set("3157", std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25"));
+        courses.set("4156", std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25"));
+        courses.set("4995", std::make_shared<Course>(60, "Nakul Verma", "", "TBA"));
+        occupancy.addDepartment(courses);
+    }
+
+    static const std::string* room(const std::string& name) {
+        return StringPool::intern(name);
+    }
+
+    CourseTable courses;
+    RoomOccupancy occupancy;
+};
+
+TEST_F(RoomOccupancyUnitTests, SlotsTest) {
+    RoomOccupancy::Bitmap first = RoomOccupancy::slotsOf(TimeInterval{0, 5});
+    EXPECT_EQ(1u, first[0]);
+    EXPECT_EQ(0u, first[1]);
+
+    // 5:15 to 5:35 touches slots 63 to 66, across the first word boundary
+    RoomOccupancy::Bitmap across = RoomOccupancy::slotsOf(TimeInterval{315, 335});
+    EXPECT_EQ(1ull << 63, across[0]);
+    EXPECT_EQ(7u, across[1]);
+
+    RoomOccupancy::Bitmap last = RoomOccupancy::slotsOf(TimeInterval{1435, 1440});
+    EXPECT_EQ(1ull << (287 - 256), last[4]);
+
+    RoomOccupancy::Bitmap none = RoomOccupancy::slotsOf(TimeInterval::parse("TBA"));
+    for (uint64_t word : none) {
+        EXPECT_EQ(0u, word);
+    }
+}
+
+TEST_F(RoomOccupancyUnitTests, ConflictTest) {
+    EXPECT_EQ(2u, occupancy.getRoomCount());
+    Course* coms4156 = courses.findCourse("4156");
+
+    // 417 IAB is taken 11:40-12:55 and 4:10-5:25
+    EXPECT_TRUE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("12:00-1:15")));
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("10:10-11:25")));
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("12:55-2:10")));
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("833 MUDD"), TimeInterval::parse("11:40-12:55")));
+
+    // a course does not clash with itself when it moves within its room
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("501 NWC"), TimeInterval::parse("11:00-12:15")));
+
+    EXPECT_FALSE(occupancy.tryPlace(coms4156, room("417 IAB"), TimeInterval::parse("4:00-5:00")));
+    ASSERT_TRUE(occupancy.tryPlace(coms4156, room("417 IAB"), TimeInterval::parse("1:10-2:25")));
+    EXPECT_FALSE(occupancy.wouldConflict(courses.findCourse("3157"), room("501 NWC"),
+                                         TimeInterval::parse("10:10-11:25")));
+    EXPECT_TRUE(occupancy.wouldConflict(courses.findCourse("3157"), room("417 IAB"),
+                                        TimeInterval::parse("2:00-3:00")));
+
+    // once a slot is held twice, neither holder can move within it
+    occupancy.place(courses.findCourse("4995"), room("417 IAB"), TimeInterval::parse("1:10-2:25"));
+    EXPECT_TRUE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("1:10-2:25")));
+    occupancy.place(courses.findCourse("4995"), room(""), TimeInterval::parse("TBA"));
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("1:10-2:25")));
+}
+
+TEST_F(RoomOccupancyUnitTests, PlaceAllTest) {
+    Course* coms1004 = courses.findCourse("1004");
+    Course* coms3157 = courses.findCourse("3157");
+    Course* coms4156 = courses.findCourse("4156");
+    size_t clash = 0;
+
+    // two courses can swap times in the room they share
+    ASSERT_TRUE(occupancy.tryPlaceAll({{coms1004, room("417 IAB"), TimeInterval::parse("4:10-5:25")},
+                                       {coms3157, room("417 IAB"), TimeInterval::parse("11:40-12:55")}}, clash));
+    EXPECT_FALSE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("1:10-2:25")));
+
+    // moves that clash with each other or with another course change nothing
+    EXPECT_FALSE(occupancy.tryPlaceAll({{coms4156, room("417 IAB"), TimeInterval::parse("1:10-2:25")},
+                                        {coms1004, room("417 IAB"), TimeInterval::parse("2:00-3:00")}}, clash));
+    EXPECT_EQ(1u, clash);
+    EXPECT_FALSE(occupancy.tryPlaceAll({{coms1004, room("501 NWC"), TimeInterval::parse("4:10-5:25")},
+                                        {coms3157, room("501 NWC"), TimeInterval::parse("11:00-12:00")}}, clash));
+    EXPECT_EQ(1u, clash);
+    EXPECT_EQ((std::vector<std::string>{"417 IAB"}), occupancy.findFreeRooms(TimeInterval::parse("10:30-10:31")));
+    EXPECT_EQ((std::vector<std::string>{"501 NWC"}), occupancy.findFreeRooms(TimeInterval::parse("4:30-4:31")));
+    EXPECT_TRUE(occupancy.wouldConflict(coms4156, room("417 IAB"), TimeInterval::parse("12:00-12:30")));
+}
+
+TEST_F(RoomOccupancyUnitTests, UnpooledRoomTest) {
+    Course* coms1004 = courses.findCourse("1004");
+    Course* coms3157 = courses.findCourse("3157");
+    Course* coms4156 = courses.findCourse("4156");
+    size_t clash = 0;
+    std::string newRoom = "1024 Occupancy Hall";
+    size_t pooled = StringPool::size();
+
+    // two moves into the same new room clash with each other, and a move that clashes
+    // elsewhere leaves the new room out of the pool
+    EXPECT_FALSE(occupancy.tryPlaceAll({{coms1004, &newRoom, TimeInterval::parse("9:00-10:00"), false},
+                                        {coms4156, &newRoom, TimeInterval::parse("9:30-10:30"), false}}, clash));
+    EXPECT_EQ(1u, clash);
+    EXPECT_FALSE(occupancy.tryPlaceAll({{coms4156, &newRoom, TimeInterval::parse("9:00-10:00"), false},
+                                        {coms3157, room("417 IAB"), TimeInterval::parse("12:00-1:00")}}, clash));
+    EXPECT_EQ(1u, clash);
+    EXPECT_EQ(nullptr, StringPool::find(newRoom));
+    EXPECT_EQ(pooled, StringPool::size());
+    EXPECT_EQ(2u, occupancy.getRoomCount());
+
+    // once the moves fit, the room is pooled and held like any other
+    ASSERT_TRUE(occupancy.tryPlaceAll({{coms4156, &newRoom, TimeInterval::parse("9:00-10:00"), false}}, clash));
+    ASSERT_NE(nullptr, StringPool::find(newRoom));
+    EXPECT_EQ(3u, occupancy.getRoomCount());
+    EXPECT_TRUE(occupancy.wouldConflict(coms1004, room(newRoom), TimeInterval::parse("9:30-10:30")));
+    EXPECT_EQ((std::vector<std::string>{"1024 Occupancy Hall", "417 IAB", "501 NWC"}),
+              occupancy.findFreeRooms(TimeInterval::parse("10:10-10:20")));
+}
+
+TEST_F(RoomOccupancyUnitTests, FreeRoomsTest) {
+    EXPECT_EQ((std::vector<std::string>{"417 IAB"}), occupancy.findFreeRooms(TimeInterval::parse("10:30-10:31")));
+    EXPECT_EQ((std::vector<std::string>{"501 NWC"}), occupancy.findFreeRooms(TimeInterval::parse("12:00-12:01")));
+    EXPECT_EQ((std::vector<std::string>{"417 IAB", "501 NWC"}),
+              occupancy.findFreeRooms(TimeInterval::parse("8:00-9:00")));
+    EXPECT_TRUE(occupancy.findFreeRooms(TimeInterval::parse("11:00-12:00")).empty());
+
+    // a room stays known after its last course leaves
+    occupancy.place(courses.findCourse("4156"), room("417 IAB"), TimeInterval::parse("8:40-9:55"));
+    EXPECT_EQ((std::vector<std::string>{"417 IAB", "501 NWC"}),
+              occupancy.findFreeRooms(TimeInterval::parse("10:30-10:31")));
+}
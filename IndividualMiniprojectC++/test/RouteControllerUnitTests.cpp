@@ -160,6 +160,35 @@ TEST_F(RouteControllerUnitTests, GetMajorCountFromDeptTest) {
     EXPECT_EQ(res.body, "Department Not Found");
 }
 
+TEST_F(RouteControllerUnitTests, GetDeptStatsTest) {
+    // Department found, with totals matching its courses
+    const Department* dept = MyApp::getDatabase()->findDepartment("PHYS");
+    ASSERT_NE(dept, nullptr);
+    int seats = 0;
+    int enrolled = 0;
+    int full = 0;
+    for (const auto& it : dept->getCourseSelection()) {
+        seats += it.second->getEnrollmentCapacity();
+        enrolled += it.second->getEnrolledStudentCount();
+        full += it.second->isCourseFull() ? 1 : 0;
+    }
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.getDeptStats(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find("Courses: " + std::to_string(dept->getCourseSelection().size()) + "\n" +
+                            "Seats: " + std::to_string(seats) + "\n" +
+                            "Enrolled: " + std::to_string(enrolled) + "\n" +
+                            "Full courses: " + std::to_string(full) + "\n" +
+                            "Fill rate: "), 0u);
+    res = crow::response();
+
+    // Department not found
+    req.url_params = crow::query_string{"?deptCode=NOTFOUND"};
+    routeController.getDeptStats(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Department Not Found");
+}
+
 TEST_F(RouteControllerUnitTests, IdentifyDeptChairTest) {
     // Department found
     req.url_params = crow::query_string{"?deptCode=PHYS"};
@@ -289,6 +318,52 @@ TEST_F(RouteControllerUnitTests, FindCourseTimeTest) {
     res = crow::response();
 }
 
+TEST_F(RouteControllerUnitTests, RetrieveCoursesTest) {
+    MyFileDatabase* database = MyApp::getDatabase();
+    Course* phys1221 = database->findCourse("PHYS", 1221);
+    Course* coms4156 = database->findCourse("COMS", 4156);
+    ASSERT_NE(phys1221, nullptr);
+    ASSERT_NE(coms4156, nullptr);
+
+    // Details by default, with a line per course that was not found
+    req.url_params = crow::query_string{"?courses=PHYS:1221,NOTFOUND:1221,PHYS:0000"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "PHYS 1221\ndetails: " + phys1221->display().substr(1) + "\n" +
+                        "NOTFOUND 1221\nerror: Department Not Found\n" +
+                        "PHYS 0000\nerror: Course Not Found\n");
+    res = crow::response();
+
+    // Only the fields asked for, in a fixed order
+    req.url_params = crow::query_string{"?courses=COMS:4156,PHYS:1221&fields=full,time,location"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "COMS 4156\nlocation: " + coms4156->getCourseLocation() + "\ntime: " +
+                        coms4156->getCourseTimeSlot() + "\nfull: " + (coms4156->isCourseFull() ? "true" : "false") +
+                        "\nPHYS 1221\nlocation: " + phys1221->getCourseLocation() + "\ntime: " +
+                        phys1221->getCourseTimeSlot() + "\nfull: " + (phys1221->isCourseFull() ? "true" : "false") +
+                        "\n");
+    res = crow::response();
+
+    // Lists that cannot be read
+    req.url_params = crow::query_string{""};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Missing courses");
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?courses=PHYS1221"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid course: PHYS1221");
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?courses=PHYS:1221&fields=time,room"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid field: room");
+}
+
 TEST_F(RouteControllerUnitTests, SetEnrollmentCountTest) {
     // Course not full
     req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221&count=100"};
@@ -477,6 +552,42 @@ TEST_F(RouteControllerUnitTests, AddMajorToDeptTest) {
     EXPECT_EQ(res.body, "Department Not Found");
 }
 
+TEST_F(RouteControllerUnitTests, EnrollStudentInCourseTest) {
+    // Enroll into the last open seat
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221"};
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", "1221");
+    ASSERT_NE(course, nullptr);
+    course->setEnrolledStudentCount(149);
+    routeController.enrollStudentInCourse(req, res);
+
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student has been enrolled");
+    EXPECT_TRUE(course->isCourseFull());
+    res = crow::response();
+
+    // Course is already full
+    routeController.enrollStudentInCourse(req, res);
+
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Student has not been enrolled");
+    res = crow::response();
+
+    // Course not found
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=0000"};
+    routeController.enrollStudentInCourse(req, res);
+
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Course Not Found");
+    res = crow::response();
+
+    // Department not found
+    req.url_params = crow::query_string{"?deptCode=NOTFOUND&courseCode=1221"};
+    routeController.enrollStudentInCourse(req, res);
+
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Department Not Found");
+}
+
 TEST_F(RouteControllerUnitTests, DropStudentFromCourseTest) {
     // Drop from course with enrolled students
     req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221"};
@@ -519,3 +630,420 @@ TEST_F(RouteControllerUnitTests, DropStudentFromCourseTest) {
     EXPECT_EQ(res.code, 404);
     EXPECT_EQ(res.body, "Department Not Found");
 }
+
+TEST_F(RouteControllerUnitTests, BatchUpdateTest) {
+    MyFileDatabase* database = MyApp::getDatabase();
+    Course* phys1001 = database->findCourse("PHYS", 1001);
+    Course* phys4205 = database->findCourse("PHYS", 4205);
+    Course* phys1520 = database->findCourse("PHYS", 1520);
+    ASSERT_NE(phys1001, nullptr);
+    ASSERT_NE(phys4205, nullptr);
+    ASSERT_NE(phys1520, nullptr);
+    std::string phys1001Instructor = phys1001->getInstructorName();
+    int phys4205Enrolled = phys4205->getEnrolledStudentCount();
+    std::string phys1520Time = phys1520->getCourseTimeSlot();
+
+    // Every change is made
+    req.body = "/changeCourseTeacher?deptCode=PHYS&courseCode=1001&instructor=Jae Lee\n"
+               "\n"
+               "setEnrollmentCount?deptCode=PHYS&courseCode=4205&count=7\r\n"
+               "/changeCourseTime?deptCode=PHYS&courseCode=1520&time=7:10-8:25\n";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "3 changes applied");
+    EXPECT_EQ("Jae Lee", phys1001->getInstructorName());
+    EXPECT_EQ(7, phys4205->getEnrolledStudentCount());
+    EXPECT_EQ("7:10-8:25", phys1520->getCourseTimeSlot());
+    res = crow::response();
+
+    // Nothing is changed if one line fails
+    req.body = "/changeCourseTeacher?deptCode=PHYS&courseCode=1001&instructor=Adam Cannon\n"
+               "/setEnrollmentCount?deptCode=PHYS&courseCode=0000&count=7\n";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Line 2: Course Not Found");
+    EXPECT_EQ("Jae Lee", phys1001->getInstructorName());
+    res = crow::response();
+
+    req.body = "/setEnrollmentCount?deptCode=NOTFOUND&courseCode=1001&count=7\n";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Line 1: Department Not Found");
+    res = crow::response();
+
+    req.body = "/changeCourseLocation?deptCode=PHYS&courseCode=1001&location=402 CHANDLER\n"
+               "/changeCourseTime?deptCode=PHYS&courseCode=1001&time=1:10-3:40\n";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Line 2: Room is already in use at that time");
+    res = crow::response();
+
+    // Lines that cannot be read
+    req.body = "/setEnrollmentCount?deptCode=PHYS&courseCode=1001&count=-1\n";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Line 1: Invalid change");
+    res = crow::response();
+
+    req.body = "/setEnrollmentCount?deptCode=PHYS&courseCode=1001&count=7\n/enrollStudentInCourse?deptCode=PHYS";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Line 2: Invalid change");
+    res = crow::response();
+
+    req.body = "";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Missing changes");
+
+    EXPECT_EQ(MutationResult::Applied, database->commitMutations({
+        MutationRecord::forCourse(MutationType::SetCourseInstructor, "PHYS", "1001", 0, phys1001Instructor),
+        MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "4205", phys4205Enrolled),
+        MutationRecord::forCourse(MutationType::SetCourseTime, "PHYS", "1520", 0, phys1520Time),
+    }).result);
+}
+
+TEST_F(RouteControllerUnitTests, FindFullCoursesTest) {
+    MyFileDatabase* database = MyApp::getDatabase();
+    Course* course = database->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    int enrolled = course->getEnrolledStudentCount();
+
+    // A course filled through a mutation is listed, in the catalog and its department
+    database->commitMutation(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221",
+                                                       course->getEnrollmentCapacity()));
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.findFullCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find("\nPHYS 1221\n"), std::string::npos);
+    res = crow::response();
+
+    req.url_params = crow::query_string{""};
+    routeController.findFullCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find("\nPHYS 1221\n"), std::string::npos);
+    res = crow::response();
+
+    // Once a seat opens it is no longer listed
+    database->commitMutation(MutationRecord::forCourse(MutationType::DropStudent, "PHYS", "1221", 0));
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.findFullCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find("\nPHYS 1221\n"), std::string::npos);
+    res = crow::response();
+
+    // Department not found
+    req.url_params = crow::query_string{"?deptCode=NOTFOUND"};
+    routeController.findFullCourses(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Department Not Found");
+    database->commitMutation(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", enrolled));
+}
+
+TEST_F(RouteControllerUnitTests, QueryCoursesTest) {
+    MyFileDatabase* database = MyApp::getDatabase();
+    Course* course = database->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    int capacity = course->getEnrollmentCapacity();
+    int enrolled = course->getEnrolledStudentCount();
+    ASSERT_EQ(MutationResult::Applied, database->commitMutation(MutationRecord::forCourse(
+        MutationType::SetEnrollmentCount, "PHYS", "1221", capacity)));
+
+    req.url_params = crow::query_string{"?dept=PHYS&fill>=1&capacity>0"};
+    routeController.queryCourses(req, res);
+
+    EXPECT_EQ(res.code, 200);
+    std::string line = "PHYS 1221: " + std::to_string(capacity) + "/" + std::to_string(capacity) + " enrolled\n";
+    EXPECT_NE(res.body.find(line), std::string::npos);
+    EXPECT_EQ(res.body.find("COMS"), std::string::npos);
+    res = crow::response();
+
+    // Condition cannot be read
+    req.url_params = crow::query_string{"?dept=PHYS&seats>10"};
+    routeController.queryCourses(req, res);
+
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid condition: seats>10");
+
+    database->commitMutation(MutationRecord::forCourse(MutationType::SetEnrollmentCount, "PHYS", "1221", enrolled));
+}
+
+TEST_F(RouteControllerUnitTests, FindCoursesByAttributeTest) {
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    std::string line = "PHYS 1221: " + course->display() + "\n";
+
+    // Courses found
+    req.url_params = crow::query_string{"?instructor=" + course->getInstructorName()};
+    routeController.findCoursesByInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find(line), std::string::npos);
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?location=" + course->getCourseLocation()};
+    routeController.findCoursesByLocation(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find(line), std::string::npos);
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?time=" + course->getCourseTimeSlot()};
+    routeController.findCoursesByTime(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find(line), std::string::npos);
+    res = crow::response();
+
+    // No course has the value
+    req.url_params = crow::query_string{"?location=NOWHERE"};
+    routeController.findCoursesByLocation(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "No Courses Found");
+    res = crow::response();
+
+    // Parameter missing
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.findCoursesByTime(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Missing time");
+}
+
+TEST_F(RouteControllerUnitTests, SearchInstructorsTest) {
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    std::string instructor = course->getInstructorName();
+    std::string lastName = instructor.substr(instructor.rfind(' ') + 1);
+
+    // The start of the instructor's last name finds them
+    req.url_params = crow::query_string{"?q=" + lastName.substr(0, 4)};
+    routeController.searchInstructors(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find(instructor + ": "), std::string::npos);
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?q=Borowsk&limit=1"};
+    routeController.searchInstructors(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find("Brian Borowski: "), 0u);
+    EXPECT_EQ(res.body.find('\n'), res.body.size() - 1);
+    res = crow::response();
+
+    // Query missing or limit out of range
+    req.url_params = crow::query_string{"?limit=5"};
+    routeController.searchInstructors(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Missing q");
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?q=Kais&limit=0"};
+    routeController.searchInstructors(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid limit");
+    res = crow::response();
+
+    // A limit that is not a number, or too large to read, is rejected the same way
+    for (const char* limit : {"abc", "5x", "-3", "99999999999"}) {
+        req.url_params = crow::query_string{std::string("?q=Kais&limit=") + limit};
+        routeController.searchInstructors(req, res);
+        EXPECT_EQ(res.code, 400) << limit;
+        EXPECT_EQ(res.body, "Invalid limit") << limit;
+        res = crow::response();
+    }
+}
+
+TEST_F(RouteControllerUnitTests, FindCoursesMeetingBetweenTest) {
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    TimeInterval meeting = course->getMeetingTime();
+    ASSERT_TRUE(meeting.isValid());
+    std::string line = "PHYS 1221: " + course->display() + "\n";
+
+    // Courses found, asking for the last minute of the course in 24-hour times
+    int last = meeting.end - 1;
+    std::string start = std::to_string(last / 60) + ":" + (last % 60 < 10 ? "0" : "") + std::to_string(last % 60);
+    std::string end = std::to_string(meeting.end / 60) + ":" + (meeting.end % 60 < 10 ? "0" : "") +
+                      std::to_string(meeting.end % 60);
+    req.url_params = crow::query_string{"?start=" + start + "&end=" + end};
+    routeController.findCoursesMeetingBetween(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find(line), std::string::npos);
+    res = crow::response();
+
+    // Range the wrong way round
+    req.url_params = crow::query_string{"?start=12:00&end=10:00"};
+    routeController.findCoursesMeetingBetween(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid time range");
+    res = crow::response();
+
+    // Parameter missing
+    req.url_params = crow::query_string{"?start=10:00"};
+    routeController.findCoursesMeetingBetween(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid time range");
+}
+
+TEST_F(RouteControllerUnitTests, RoomConflictTest) {
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    std::string location = course->getCourseLocation();
+    std::string timeSlot = course->getCourseTimeSlot();
+
+    // Room taken by the course itself is not free while it meets
+    req.url_params = crow::query_string{"?start=" + timeSlot.substr(0, timeSlot.find('-')) + "&end=" +
+                                        timeSlot.substr(timeSlot.find('-') + 1)};
+    routeController.findFreeRooms(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find(location + "\n"), std::string::npos);
+    res = crow::response();
+
+    // Another course cannot move into the room at that time
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=2000&time=" + timeSlot};
+    routeController.setCourseTime(req, res);
+    res = crow::response();
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=2000&location=" + location};
+    routeController.setCourseLocation(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Room is already in use at that time");
+    EXPECT_NE(MyApp::getDatabase()->findCourse("PHYS", 2000)->getCourseLocation(), location);
+    res = crow::response();
+
+    // Time cannot be read
+    req.url_params = crow::query_string{"?time=noon"};
+    routeController.findFreeRooms(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid time range");
+}
+
+TEST_F(RouteControllerUnitTests, ConditionalGetTest) {
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    std::string deptTag = res.get_header_value("ETag");
+    ASSERT_FALSE(deptTag.empty());
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.findCourseInstructor(req, res);
+    std::string courseTag = res.get_header_value("ETag");
+    std::string instructor = MyApp::getDatabase()->findCourse("PHYS", 1001)->getInstructorName();
+    res = crow::response();
+    req.url_params = crow::query_string{"?q=Mar"};
+    routeController.searchInstructors(req, res);
+    std::string catalogTag = res.get_header_value("ETag");
+    res = crow::response();
+
+    // Unchanged: 304 with the same tag and no body, also when listed among other tags
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    req.add_header("If-None-Match", "\"0-0\", W/" + deptTag);
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 304);
+    EXPECT_EQ(res.body, "");
+    EXPECT_EQ(res.get_header_value("ETag"), deptTag);
+    res = crow::response();
+    req = crow::request();
+
+    // A change to one course moves the tags of the course, its department and the catalog
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&instructor=Brian Greene"};
+    routeController.setCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    req.add_header("If-None-Match", deptTag);
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find("Brian Greene"), std::string::npos);
+    EXPECT_NE(res.get_header_value("ETag"), deptTag);
+    res = crow::response();
+    req = crow::request();
+
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    req.add_header("If-None-Match", courseTag);
+    routeController.findCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Brian Greene is the instructor for the course.");
+    std::string changedTag = res.get_header_value("ETag");
+    EXPECT_NE(changedTag, courseTag);
+    res = crow::response();
+    req = crow::request();
+
+    req.url_params = crow::query_string{"?q=Mar"};
+    req.add_header("If-None-Match", catalogTag);
+    routeController.searchInstructors(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.get_header_value("ETag"), catalogTag);
+    res = crow::response();
+    req = crow::request();
+
+    // A course that did not change keeps its tag
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    req.add_header("If-None-Match", changedTag);
+    routeController.findCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 304);
+    res = crow::response();
+    req = crow::request();
+
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&instructor=" + instructor};
+    routeController.setCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+}
+
+TEST_F(RouteControllerUnitTests, JsonFormatTest) {
+    Course* course = MyApp::getDatabase()->findCourse("PHYS", 1221);
+    ASSERT_NE(course, nullptr);
+    std::string fields = "\"instructor\":\"" + course->getInstructorName() + "\",\"location\":\"" +
+                         course->getCourseLocation() + "\",\"time\":\"" + course->getCourseTimeSlot() +
+                         "\",\"capacity\":" + std::to_string(course->getEnrollmentCapacity()) +
+                         ",\"enrolled\":" + std::to_string(course->getEnrolledStudentCount());
+
+    // Asked for with format=json
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221&format=json"};
+    routeController.retrieveCourse(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.get_header_value("Content-Type"), "application/json");
+    EXPECT_EQ(res.body, "{\"deptCode\":\"PHYS\",\"courseCode\":\"1221\"," + fields + "}");
+    std::string jsonTag = res.get_header_value("ETag");
+    res = crow::response();
+
+    // Or with an Accept header; the text form is tagged apart
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221"};
+    routeController.findCourseInstructor(req, res);
+    EXPECT_EQ(res.body, course->getInstructorName() + " is the instructor for the course.");
+    EXPECT_NE(res.get_header_value("ETag"), jsonTag);
+    res = crow::response();
+    req.add_header("Accept", "text/html, application/json;q=0.9");
+    routeController.findCourseInstructor(req, res);
+    EXPECT_EQ(res.body, "{\"deptCode\":\"PHYS\",\"courseCode\":\"1221\",\"instructor\":\"" +
+                        course->getInstructorName() + "\"}");
+    res = crow::response();
+
+    // The department lists every course with its fields
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find("{\"deptCode\":\"PHYS\",\"chair\":"), 0u);
+    EXPECT_NE(res.body.find("{\"courseCode\":\"1221\"," + fields + "}"), std::string::npos);
+    EXPECT_EQ(res.body.back(), '}');
+    res = crow::response();
+    req = crow::request();
+
+    // Errors too
+    req.url_params = crow::query_string{"?deptCode=NOTFOUND&format=json"};
+    routeController.getDeptStats(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "{\"error\":\"Department Not Found\"}");
+    res = crow::response();
+
+    // Batches and queries
+    req.url_params = crow::query_string{"?courses=PHYS:1221,PHYS:0000&fields=full&format=json"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, std::string("{\"courses\":[{\"deptCode\":\"PHYS\",\"courseCode\":\"1221\",\"full\":") +
+                            (course->isCourseFull() ? "true" : "false") +
+                            "},{\"deptCode\":\"PHYS\",\"courseCode\":\"0000\",\"error\":\"Course Not Found\"}]}");
+    res = crow::response();
+
+    req.url_params = crow::query_string{"?dept=PHYS&capacity>=0&format=json"};
+    routeController.queryCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body.find("{\"count\":6,\"courses\":[{\"deptCode\":\"PHYS\""), 0u);
+}
@@ -0,0 +1,234 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "MyFileDatabase.h"
+#include "SnapshotFile.h"
+
+class SnapshotFileUnitTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MyFileDatabase::removeDataFiles(filePath);
+    }
+
+    void TearDown() override {
+        MyFileDatabase::removeDataFiles(filePath);
+    }
+
+    static bool exists(const std::string& path) {
+        return std::ifstream(path).good();
+    }
+
+    static void writeSample() {
+        SnapshotWriter writer(filePath);
+        writer.addDepartment("COMS", "COMS", "Luca Carloni", 2700);
+        writer.addCourse("3157", Course::State{400, 311, "417 IAB", "Jae Lee", "4:10-5:25"});
+        writer.addCourse("4156", Course::State{120, 109, "501 NWC", "Gail Kaiser", "10:10-11:25"});
+        writer.addDepartment("ECON", "ECON", "Michael Woodford", 2345);
+        writer.addDepartment("IEOR", "IEOR", "Jay Sethuraman", 67);
+        writer.addCourse("4106", Course::State{150, 161, "501 NWC", "Kaizheng Wang", "10:10-11:25"});
+        ASSERT_TRUE(writer.finish(42));
+    }
+
+    static const char* filePath;
+};
+
+const char* SnapshotFileUnitTests::filePath = "snapshotfile_test.bin";
+
+TEST_F(SnapshotFileUnitTests, WriteAndReadTest) {
+    writeSample();
+    auto snapshot = SnapshotFile::open(filePath);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(42u, snapshot->getLsn());
+    ASSERT_EQ(3u, snapshot->getDepartmentCount());
+
+    EXPECT_EQ("COMS", snapshot->getDepartmentKey(0));
+    EXPECT_EQ("Luca Carloni", snapshot->getDepartmentChair(0));
+    EXPECT_EQ(2700, snapshot->getNumberOfMajors(0));
+    ASSERT_EQ(2u, snapshot->getCourseCount(0));
+    EXPECT_EQ("4156", snapshot->getCourseId(0, 1));
+    Course::State state = snapshot->getCourseState(0, 1);
+    EXPECT_EQ(120, state.enrollmentCapacity);
+    EXPECT_EQ(109, state.enrolledStudentCount);
+    EXPECT_EQ("501 NWC", state.courseLocation);
+    EXPECT_EQ("Gail Kaiser", state.instructorName);
+    EXPECT_EQ("10:10-11:25", state.courseTimeSlot);
+
+    EXPECT_EQ(0u, snapshot->getCourseCount(1));
+    EXPECT_EQ("IEOR", snapshot->getDeptCode(2));
+    EXPECT_EQ("4106", snapshot->getCourseId(2, 0));
+    EXPECT_THROW(snapshot->getCourseId(2, 1), std::runtime_error);
+}
+
+TEST_F(SnapshotFileUnitTests, OriginalFormatIsNotMappedTest) {
+    EXPECT_EQ(SnapshotFile::open(filePath), nullptr);
+
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    Department coms("COMS", courses, "Luca Carloni", 2700);
+    {
+        std::ofstream out(filePath, std::ios::binary);
+        size_t mapSize = 1;
+        size_t keyLen = 4;
+        out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+        out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+        out.write("COMS", keyLen);
+        coms.serialize(out);
+    }
+    EXPECT_EQ(SnapshotFile::open(filePath), nullptr);
+
+    // files in the original format still load
+    MyFileDatabase database(0, filePath);
+    ASSERT_NE(database.findCourse("COMS", "4156"), nullptr);
+    EXPECT_EQ("Gail Kaiser", database.findCourse("COMS", "4156")->getInstructorName());
+}
+
+TEST_F(SnapshotFileUnitTests, TruncatedFileTest) {
+    writeSample();
+    std::ifstream in(filePath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 10);
+    out.close();
+    EXPECT_THROW(SnapshotFile::open(filePath), std::runtime_error);
+}
+
+TEST_F(SnapshotFileUnitTests, OverflowingCountTest) {
+    writeSample();
+    std::ifstream in(filePath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    // a course count whose table size wraps around to 24 bytes must not pass the check
+    uint64_t courseCount = 461168601842738791ull;
+    std::memcpy(&contents[24], &courseCount, sizeof(courseCount));
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+    out.close();
+    EXPECT_THROW(SnapshotFile::open(filePath), std::runtime_error);
+}
+
+TEST_F(SnapshotFileUnitTests, LazyDepartmentLoadTest) {
+    writeSample();
+    MyFileDatabase database(0, filePath);
+    EXPECT_EQ(2345, database.findDepartment("ECON")->getNumberOfMajors());
+    EXPECT_EQ("Jay Sethuraman", database.findDepartment("IEOR")->getDepartmentChair());
+
+    Course* coms4156 = database.findCourse("COMS", "4156");
+    ASSERT_NE(coms4156, nullptr);
+    EXPECT_EQ("501 NWC", coms4156->getCourseLocation());
+    EXPECT_EQ(coms4156, database.findCourse("COMS", "4156"));
+    EXPECT_EQ(nullptr, database.findCourse("COMS", "1004"));
+    coms4156->reassignLocation("833 MUDD");
+
+    // loaded and never loaded departments are both written back
+    database.saveContentsToFile();
+    MyFileDatabase reloaded(0, filePath);
+    EXPECT_EQ("833 MUDD", reloaded.findCourse("COMS", "4156")->getCourseLocation());
+    EXPECT_EQ(311, reloaded.findCourse("COMS", "3157")->getEnrolledStudentCount());
+    EXPECT_EQ("Kaizheng Wang", reloaded.findCourse("IEOR", "4106")->getInstructorName());
+    EXPECT_EQ(reloaded.findCourse("IEOR", "4106"), reloaded.findCourse("IEOR", 4106));
+    EXPECT_EQ(2u, reloaded.findDepartment("COMS")->getCourseSelection().size());
+    EXPECT_TRUE(reloaded.findDepartment("ECON")->getCourseSelection().empty());
+
+    // a query first loads the departments still in the file
+    CourseColumns::Condition location;
+    ASSERT_TRUE(CourseColumns::Condition::parse("location=501 NWC", location));
+    std::vector<CourseMatch> matches = reloaded.queryCourses({location});
+    ASSERT_EQ(1u, matches.size());
+    EXPECT_EQ("IEOR", matches[0].deptCode);
+    EXPECT_EQ(161, matches[0].enrolledStudentCount);
+    EXPECT_EQ(2u, reloaded.findCoursesBy(CourseAttributeIndex::Attribute::TimeSlot, "10:10-11:25").size());
+}
+
+TEST_F(SnapshotFileUnitTests, ParallelLoadTest) {
+    {
+        SnapshotWriter writer(filePath);
+        for (int dept = 0; dept < 40; ++dept) {
+            std::string code = "D" + std::to_string(100 + dept);
+            writer.addDepartment(code, code, "Chair " + std::to_string(dept), dept);
+            for (int course = 0; course < dept % 7; ++course) {
+                writer.addCourse(std::to_string(1000 + course),
+                                 Course::State{dept + course, course, "417 IAB", "Jae Lee", "4:10-5:25"});
+            }
+        }
+        ASSERT_TRUE(writer.finish(7));
+    }
+
+    MyFileDatabase database(0, filePath);
+    database.findCourse("D105", "1000");
+    database.loadAllDepartments(4);
+    for (const auto& it : database.getDepartmentMapping()) {
+        EXPECT_TRUE(it.second.isLoaded());
+    }
+    for (int dept = 0; dept < 40; ++dept) {
+        const Department* department = database.findDepartment("D" + std::to_string(100 + dept));
+        ASSERT_NE(department, nullptr);
+        ASSERT_EQ(static_cast<size_t>(dept % 7), department->getCourseSelection().size());
+        for (int course = 0; course < dept % 7; ++course) {
+            Course* loaded = database.findCourse("D" + std::to_string(100 + dept), std::to_string(1000 + course));
+            ASSERT_NE(loaded, nullptr);
+            EXPECT_EQ(dept + course, loaded->getState().enrollmentCapacity);
+            EXPECT_EQ(course, loaded->getEnrolledStudentCount());
+        }
+    }
+
+    // nothing is left to load the second time
+    database.loadAllDepartments(0);
+}
+
+TEST_F(SnapshotFileUnitTests, IncrementalSaveTest) {
+    writeSample();
+    uint64_t fullBytes;
+    {
+        MyFileDatabase database(0, filePath);
+        database.saveContentsToFile();
+        fullBytes = database.getLastSaveBytes();
+        EXPECT_TRUE(exists(SnapshotManifest::segmentPath(filePath, 0)));
+    }
+
+    MyFileDatabase database(0, filePath);
+    database.findCourse("IEOR", "4106")->reassignLocation("833 MUDD");
+    database.saveContentsToFile();
+    EXPECT_LT(database.getLastSaveBytes(), fullBytes);
+    EXPECT_TRUE(exists(SnapshotManifest::segmentPath(filePath, 1)));
+
+    // nothing changed, so only the manifest is rewritten
+    database.saveContentsToFile();
+    EXPECT_EQ(64u, database.getLastSaveBytes());
+    EXPECT_FALSE(exists(SnapshotManifest::segmentPath(filePath, 2)));
+
+    database.findDepartment("ECON")->addPersonToMajor();
+    database.findCourse("COMS", "3157")->enrollStudent();
+    database.saveContentsToFile();
+
+    MyFileDatabase reloaded(0, filePath);
+    EXPECT_EQ("833 MUDD", reloaded.findCourse("IEOR", "4106")->getCourseLocation());
+    EXPECT_EQ(312, reloaded.findCourse("COMS", "3157")->getEnrolledStudentCount());
+    EXPECT_EQ(109, reloaded.findCourse("COMS", "4156")->getEnrolledStudentCount());
+    EXPECT_EQ(2346, reloaded.findDepartment("ECON")->getNumberOfMajors());
+    EXPECT_EQ(3u, reloaded.getDepartmentMapping().size());
+}
+
+TEST_F(SnapshotFileUnitTests, SegmentsAreCompactedTest) {
+    writeSample();
+    MyFileDatabase database(0, filePath);
+    database.saveContentsToFile();
+    for (int i = 0; i < 40; ++i) {
+        database.findCourse("COMS", "4156")->setEnrolledStudentCount(i);
+        database.saveContentsToFile();
+    }
+    EXPECT_FALSE(exists(SnapshotManifest::segmentPath(filePath, 0)));
+    SnapshotManifest manifest;
+    ASSERT_TRUE(SnapshotManifest::read(filePath, manifest));
+    EXPECT_EQ(41u, manifest.nextSegment);
+    EXPECT_LE(manifest.segments.size(), 64u);
+
+    MyFileDatabase reloaded(0, filePath);
+    EXPECT_EQ(39, reloaded.findCourse("COMS", "4156")->getEnrolledStudentCount());
+    EXPECT_EQ("Kaizheng Wang", reloaded.findCourse("IEOR", "4106")->getInstructorName());
+}
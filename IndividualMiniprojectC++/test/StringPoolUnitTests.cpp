@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "StringPool.h"
+
+TEST(StringPoolUnitTests, InternTest) {
+    const std::string* location = StringPool::intern("417 IAB");
+    ASSERT_NE(location, nullptr);
+    EXPECT_EQ("417 IAB", *location);
+    EXPECT_EQ(location, StringPool::intern(std::string("417 ") + "IAB"));
+    EXPECT_NE(location, StringPool::intern("501 NWC"));
+    EXPECT_EQ("", *StringPool::intern(""));
+
+    size_t before = StringPool::size();
+    StringPool::intern("417 IAB");
+    EXPECT_EQ(before, StringPool::size());
+    EXPECT_EQ(nullptr, StringPool::find("a location no other test uses"));
+    const std::string* added = StringPool::intern("a location no other test uses");
+    EXPECT_EQ(before + 1, StringPool::size());
+    EXPECT_EQ(added, StringPool::find("a location no other test uses"));
+}
+
+TEST(StringPoolUnitTests, ConcurrentInternTest) {
+    std::vector<std::vector<const std::string*>> seen(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&seen, t]() {
+            for (int i = 0; i < 500; ++i) {
+                seen[t].push_back(StringPool::intern("Room " + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // every thread gets the same copy of each string
+    for (int t = 1; t < 4; ++t) {
+        EXPECT_EQ(seen[0], seen[t]);
+    }
+    EXPECT_EQ("Room 499", *seen[0][499]);
+}
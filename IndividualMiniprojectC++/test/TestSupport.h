@@ -0,0 +1,25 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <string>
+#include <vector>
+#include "CourseAttributeIndex.h"
+
+namespace testsupport {
+
+/**
+ * Names each course as "DEPT courseId", for comparing lookup results in one expectation.
+ */
+inline std::vector<std::string> names(const std::vector<CourseRef>& refs) {
+    std::vector<std::string> result;
+    for (const CourseRef& ref : refs) {
+        result.push_back(ref.deptCode + " " + ref.courseId);
+    }
+    return result;
+}
+
+}  // namespace testsupport
+
+#endif
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <string>
+#include "TimeInterval.h"
+
+TEST(TimeIntervalUnitTests, ParseTest) {
+    TimeInterval morning = TimeInterval::parse("11:40-12:55");
+    EXPECT_EQ(11 * 60 + 40, morning.start);
+    EXPECT_EQ(12 * 60 + 55, morning.end);
+
+    TimeInterval afternoon = TimeInterval::parse("4:10-5:25");
+    EXPECT_EQ(16 * 60 + 10, afternoon.start);
+    EXPECT_EQ(17 * 60 + 25, afternoon.end);
+
+    TimeInterval evening = TimeInterval::parse("6:10-9:50");
+    EXPECT_EQ(18 * 60 + 10, evening.start);
+    EXPECT_EQ(21 * 60 + 50, evening.end);
+
+    TimeInterval acrossNoon = TimeInterval::parse("10:10-1:00");
+    EXPECT_EQ(10 * 60 + 10, acrossNoon.start);
+    EXPECT_EQ(13 * 60, acrossNoon.end);
+
+    TimeInterval twentyFourHour = TimeInterval::parse("13:10-14:25");
+    EXPECT_EQ(13 * 60 + 10, twentyFourHour.start);
+    EXPECT_EQ(14 * 60 + 25, twentyFourHour.end);
+
+    EXPECT_FALSE(TimeInterval::parse("TBA").isValid());
+    EXPECT_FALSE(TimeInterval::parse("").isValid());
+    EXPECT_FALSE(TimeInterval::parse("10:10").isValid());
+    EXPECT_FALSE(TimeInterval::parse("10:1-11:25").isValid());
+    EXPECT_FALSE(TimeInterval::parse("10:70-11:25").isValid());
+    EXPECT_FALSE(TimeInterval::parse("25:00-26:00").isValid());
+    EXPECT_FALSE(TimeInterval::parse("14:00-13:00").isValid());
+}
+
+TEST(TimeIntervalUnitTests, OverlapTest) {
+    TimeInterval lecture = TimeInterval::parse("10:10-11:25");
+    EXPECT_TRUE(lecture.overlaps(TimeInterval::parse("11:00-12:00")));
+    EXPECT_TRUE(lecture.overlaps(TimeInterval::parse("9:00-10:11")));
+    EXPECT_FALSE(lecture.overlaps(TimeInterval::parse("11:25-12:40")));
+    EXPECT_FALSE(lecture.overlaps(TimeInterval::parse("8:40-10:10")));
+    EXPECT_FALSE(lecture.overlaps(TimeInterval::parse("TBA")));
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Annie Xu @ Columbia University
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TimeRangeIndex.h"
+
+namespace {
+
+std::vector<std::string> findIds(const TimeRangeIndex& index, const std::string& range) {
+    std::vector<std::string> ids;
+    for (const CourseRef& ref : index.find(TimeInterval::parse(range))) {
+        ids.push_back(ref.courseId);
+    }
+    return ids;
+}
+
+}  // namespace
+
+TEST(TimeRangeIndexUnitTests, FindTest) {
+    CourseTable coms;
+    coms.set("1004", std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55"));
+    coms.set("3157", std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25"));
+    coms.set("3203", std::make_shared<Course>(250, "Ansaf Salleb-Aouissi", "301 URIS", "10:10-11:25"));
+    coms.set("3251", std::make_shared<Course>(125, "Tony Dear", "402 CHANDLER", "1:10-3:40"));
+    coms.set("3827", std::make_shared<Course>(300, "Daniel Rubenstein", "207 Math", "10:10-11:25"));
+    coms.set("4156", std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "6:10-9:50"));
+    coms.set("4995", std::make_shared<Course>(60, "Nakul Verma", "TBA", "TBA"));
+    TimeRangeIndex index;
+    index.addDepartment("COMS", coms);
+    EXPECT_EQ(5u, index.getIntervalCount());
+
+    EXPECT_EQ((std::vector<std::string>{"1004", "3203", "3827"}), findIds(index, "10:00-12:00"));
+    EXPECT_EQ((std::vector<std::string>{"3157", "3251"}), findIds(index, "3:00-4:30"));
+    EXPECT_EQ((std::vector<std::string>{"4156"}), findIds(index, "7:00-7:30"));
+    EXPECT_EQ((std::vector<std::string>{"1004"}), findIds(index, "11:30-11:45"));
+    EXPECT_TRUE(findIds(index, "8:00-10:10").empty());
+    EXPECT_TRUE(findIds(index, "12:55-1:10").empty());
+    EXPECT_TRUE(index.find(TimeInterval::parse("TBA")).empty());
+
+    std::vector<CourseRef> evening = index.find(TimeInterval::parse("21:49-21:50"));
+    ASSERT_EQ(1u, evening.size());
+    EXPECT_EQ("COMS", evening[0].deptCode);
+    EXPECT_EQ(coms.findCourse("4156"), evening[0].course);
+}
+
+TEST(TimeRangeIndexUnitTests, RefreshTest) {
+    CourseTable coms;
+    coms.set("3157", std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25"));
+    coms.set("4156", std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25"));
+    TimeRangeIndex index;
+    index.addDepartment("COMS", coms);
+
+    // moving the only course of an interval to a new interval replaces it in the tree
+    Course* coms4156 = coms.findCourse("4156");
+    coms4156->reassignTime("6:10-9:50");
+    index.refresh(coms4156);
+    EXPECT_EQ(2u, index.getIntervalCount());
+    EXPECT_TRUE(findIds(index, "10:00-12:00").empty());
+    EXPECT_EQ((std::vector<std::string>{"4156"}), findIds(index, "7:00-8:00"));
+
+    // moving to an interval that has courses joins its list
+    coms4156->reassignTime("4:10-5:25");
+    index.refresh(coms4156);
+    EXPECT_EQ(1u, index.getIntervalCount());
+    EXPECT_EQ((std::vector<std::string>{"3157", "4156"}), findIds(index, "5:00-6:00"));
+
+    // a slot that cannot be parsed takes the course out of the index
+    coms4156->reassignTime("TBA");
+    index.refresh(coms4156);
+    EXPECT_EQ((std::vector<std::string>{"3157"}), findIds(index, "5:00-6:00"));
+}